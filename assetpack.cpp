@@ -0,0 +1,93 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include "assetpack.h"
+
+// The index is used in place, its layout is part of the file format
+static_assert(sizeof(AssetPackHeader) == 32, "AssetPackHeader layout");
+static_assert(sizeof(AssetPackEntry) == 128, "AssetPackEntry layout");
+
+AssetPack::AssetPack() : header(nullptr), entries(nullptr)
+{
+}
+
+bool AssetPack::open(const char *path)
+{
+	close();
+
+	if (!file.open(path))
+		return false;
+
+	size_t size = file.getSize();
+	const AssetPackHeader *h = reinterpret_cast<const AssetPackHeader *>(file.getData());
+	if ((size < sizeof(AssetPackHeader)) || memcmp(h->magic, ASSETPACK_MAGIC, 4) ||
+	    (h->version != ASSETPACK_VERSION) || (h->byteOrder != ASSETPACK_BYTE_ORDER) ||
+	    ((size - sizeof(AssetPackHeader)) / sizeof(AssetPackEntry) < h->numAssets))
+	{
+		file.close();
+		return false;
+	}
+
+	// Checked once, a corrupted entry must not read out of the file
+	const AssetPackEntry *e = reinterpret_cast<const AssetPackEntry *>(h + 1);
+	for (unsigned i = 0; i < h->numAssets; i++)
+	{
+		if ((e[i].offset % ASSETPACK_ALIGN) || (e[i].offset > size) ||
+		    (e[i].name[ASSETPACK_NAME_LEN - 1] != '\0') ||
+		    (e[i].height && ((size - e[i].offset) / e[i].height < e[i].pitch)) ||
+		    ((i > 0) && (strcmp(e[i - 1].name, e[i].name) >= 0)))
+		{
+			file.close();
+			return false;
+		}
+	}
+
+	header = h;
+	entries = e;
+	return true;
+}
+
+void AssetPack::close(void)
+{
+	file.close();
+	header = nullptr;
+	entries = nullptr;
+}
+
+const AssetPackEntry *AssetPack::find(const char *name) const
+{
+	if (!header)
+		return nullptr;
+
+	int lo = 0, hi = (int)header->numAssets - 1;
+	while (lo <= hi)
+	{
+		int mid = (lo + hi) / 2;
+		int cmp = strcmp(entries[mid].name, name);
+		if (cmp == 0)
+			return &entries[mid];
+		if (cmp < 0)
+			lo = mid + 1;
+		else
+			hi = mid - 1;
+	}
+
+	return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _ASSETPACK_H_
+#define _ASSETPACK_H_
+
+#include <cstdint>
+#include "mappedfile.h"
+
+/*
+ * Asset pack file layout.
+ * Bitmaps are converted in advance by the packassets tool to the pixel
+ * format of the renderer, so that they are uploaded straight from the
+ * file mapped in memory, with no decoding.
+ * The file starts with an AssetPackHeader, followed by an AssetPackEntry
+ * for each bitmap, sorted by name; the pixels follow, each bitmap starts
+ * at an offset multiple of ASSETPACK_ALIGN from the start of the file.
+ * Everything is in the byte order of the machine running the tool, a file
+ * with a different version or byte order is ignored.
+ */
+#define ASSETPACK_MAGIC "DGAP"
+#define ASSETPACK_VERSION 1
+#define ASSETPACK_BYTE_ORDER 0x01020304
+#define ASSETPACK_ALIGN 64
+#define ASSETPACK_NAME_LEN 112
+
+// The pack looked up by the renderers, in the working directory
+#define ASSETPACK_FILE "assets.pack"
+
+struct AssetPackHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t byteOrder;
+	// The SDL_PixelFormatEnum of all the bitmaps
+	uint32_t pixelFormat;
+	uint32_t numAssets;
+	uint32_t reserved[3];
+};
+
+struct AssetPackEntry
+{
+	// The name passed to ViewRender::loadBMP()
+	char name[ASSETPACK_NAME_LEN];
+	uint32_t offset;
+	uint32_t width, height;
+	// The distance between rows, in bytes
+	uint32_t pitch;
+};
+
+/*
+ * An asset pack mapped in memory.
+ * The pixels found in it are valid until the pack is closed.
+ */
+class AssetPack
+{
+public:
+	AssetPack();
+
+	/*
+	 * Map a pack and check its header and index.
+	 *
+	 * PARAMETERS IN
+	 *  const char *path - the pack file
+	 *
+	 * RETURN
+	 * true if the file is an asset pack of this version
+	 */
+	bool open(const char *path);
+
+	void close(void);
+
+	/*
+	 * Look up a bitmap.
+	 *
+	 * PARAMETERS IN
+	 *  const char *name - the name of the bitmap
+	 *
+	 * RETURN
+	 * the entry of the bitmap, nullptr if it is not in the pack
+	 */
+	const AssetPackEntry *find(const char *name) const;
+
+	inline const uint8_t *getPixels(const AssetPackEntry *entry) const { return file.getData() + entry->offset; }
+	inline uint32_t getPixelFormat(void) const { return header->pixelFormat; }
+	inline bool isOpen(void) const { return header != nullptr; }
+
+private:
+	MappedFile file;
+	const AssetPackHeader *header;
+	const AssetPackEntry *entries;
+};
+
+#endif
\ No newline at end of file
@@ -29,7 +29,7 @@ Background::Background(Rectangle &rect) : View(rect)
 void Background::drawView()
 {
 	Rectangle viewRect;
-	ViewRender *r = GRenderer;
+	ViewRenderBackend *r = GRenderer;
 	Palette *p = GPaletteGroup->getPalette(PaletteGroup::PAL_BACKGROUND);
 	getViewport(viewRect);
 	unsigned color;
@@ -0,0 +1,286 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Console throughput benchmark.
+ * A cat-like output, text lines with some of them colored by SGR sequences
+ * or holding UTF-8 characters, is decoded into a ConsoleScreen, whose
+ * cells are expanded to pixels by TextBuffer::blitBuffer(). Then it is
+ * written by another thread into a ConsoleView inserted in a ViewExec,
+ * whose event loop decodes it and draws the frames with the software
+ * renderer through reDraw() and show(): the longest event shows how long
+ * the loop is kept busy.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <SDL2/SDL.h>
+#include "viewinstances.h"
+#include "viewexec.h"
+#include "vieweventmgr.h"
+#include "consoleview.h"
+#include "textbuffer.h"
+#include "builtinfont.h"
+#include "event.h"
+
+static const int SCREEN_WIDTH = 640;
+static const int SCREEN_HEIGHT = 400;
+static const size_t OUTPUT_SIZE = 64 << 20;
+// The size of the writes, as for a pipe
+static const size_t CHUNK_SIZE = 64 << 10;
+// Frames of the console cells expanded to pixels
+static const int BLIT_FRAMES = 2000;
+
+/*
+ * The events of the loop, queued in memory instead of SDL: there is no
+ * input, only the messages of the views.
+ */
+class BenchEvents : public ViewEventManager
+{
+public:
+	virtual bool wait(Event *evt, int timeoutms) override
+	{
+		std::unique_lock<std::mutex> lock(eventsLock);
+		if (!eventsReady.wait_for(lock, std::chrono::milliseconds(timeoutms), [this] { return !events.empty(); }))
+			return false;
+		evt->setMessageEvent(events.front());
+		events.pop_front();
+		return true;
+	}
+
+	virtual bool poll(void) override
+	{
+		std::lock_guard<std::mutex> lock(eventsLock);
+		return !events.empty();
+	}
+
+	virtual bool put(Event *evt) override
+	{
+		std::lock_guard<std::mutex> lock(eventsLock);
+		events.push_back(*evt->getMessageEvent());
+		eventsReady.notify_one();
+		return true;
+	}
+
+private:
+	std::mutex eventsLock;
+	std::condition_variable eventsReady;
+	std::deque<MessageEvent> events;
+};
+
+/*
+ * The event loop of ViewExec::run(), measured and stopped when the
+ * producer is over and no events are left.
+ */
+class BenchLoop : public ViewExec
+{
+public:
+	BenchLoop(Rectangle &limits, ViewEventManager *evt) : ViewExec(limits, evt) {}
+
+	void measure(const std::atomic<bool> &written, unsigned &frames, double &longest)
+	{
+		Event event;
+
+		reDraw();
+
+		for (;;)
+		{
+			if (!evtM->wait(&event, 10))
+			{
+				if (written)
+					break;
+				continue;
+			}
+
+			bool frame = event.isEventCommand() && (event.getMessageEvent()->command == CMD_REDRAW);
+			auto eventStart = std::chrono::steady_clock::now();
+			if (!handleWakeup(&event))
+				handleEvent(&event);
+			std::chrono::duration<double, std::milli> busy = std::chrono::steady_clock::now() - eventStart;
+			longest = std::max(longest, busy.count());
+			if (frame)
+				frames++;
+		}
+	}
+};
+
+static unsigned seed = 12345;
+
+static int nextRandom(int range)
+{
+	/* Deterministic LCG, runs are comparable */
+	seed = seed * 1103515245 + 12345;
+	return (int)((seed >> 16) % (unsigned)range);
+}
+
+static char *makeOutput(size_t size)
+{
+	static const char *words[] = {"drwxr-xr-x", "root", "4096", "Makefile", "viewgroup.cpp", "-rw-r--r--", "2024", "\t", "include", "src"};
+	char *out = new char[size];
+	size_t len = 0;
+
+	while (len + 256 < size)
+	{
+		int line = nextRandom(16);
+
+		if (line == 0)
+			len += snprintf(out + len, 64, "\x1b[01;34mdirectory\x1b[0m ");
+		else if (line == 1)
+			len += snprintf(out + len, 64, "caf\xc3\xa9 \xe2\x94\x80\xe2\x94\x80 ");
+
+		for (int n = nextRandom(12); n > 0; n--)
+			len += snprintf(out + len, 64, "%s ", words[nextRandom(10)]);
+		out[len++] = '\n';
+	}
+	memset(out + len, 'x', size - len);
+
+	return out;
+}
+
+/*
+ * The glyphs of the built-in font as a TextBuffer::blitBuffer() table, in
+ * the left pixels of the cells. The table MUST be deleted by the caller.
+ */
+static uint8_t *makeGlyphs(TextGlyphs &glyphs)
+{
+	uint8_t *bits = new uint8_t[256 * builtinFont.height]();
+
+	for (int ch = 0; ch < 256; ch++)
+	{
+		const BitmapGlyph &g = builtinFont.find(ch);
+
+		for (int y = 0; y < g.height; y++)
+		{
+			int row = builtinFont.ascent - g.top + y;
+			if ((row >= 0) && (row < builtinFont.height))
+				bits[ch * builtinFont.height + row] = builtinFont.bits[g.offset + y * builtinFont.stride(g)] >> std::max((int)g.left, 0);
+		}
+	}
+
+	glyphs.bits = bits;
+	glyphs.height = builtinFont.height;
+	return bits;
+}
+
+/*
+ * Expand a known cell and compare its pixels with the bits of the glyph.
+ */
+static bool checkBlit(const TextGlyphs &glyphs)
+{
+	TextBuffer cell(1, 1);
+	std::vector<uint8_t> pixels(8 * glyphs.height);
+	const uint8_t fg = 15, bg = 1;
+
+	cell.setBufferXY(0, 0, (uint16_t)('A' | (fg << 8) | (bg << 12)));
+	cell.blitBuffer(0, 0, 1, 1, glyphs, pixels.data(), 8);
+
+	for (int y = 0; y < glyphs.height; y++)
+		for (int x = 0; x < 8; x++)
+		{
+			uint8_t expected = (glyphs.bits['A' * glyphs.height + y] & (0x80 >> x)) ? fg : bg;
+			if (pixels[y * 8 + x] != expected)
+				return false;
+		}
+
+	return true;
+}
+
+static double megabytesPerSecond(size_t bytes, std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	return bytes / elapsed.count() / (1 << 20);
+}
+
+int main(void)
+{
+	SDL_Init(0);
+
+	Rectangle master(0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1);
+	ViewRenderInstance::instance()->configure(VRENDER_VESA, SCREEN_WIDTH, SCREEN_HEIGHT, 32);
+	ViewZBuffer::instance()->configure(master);
+	PaletteGroupInstance::instance()->configure(SYS_PALETTE_DIEGOS, 32);
+
+	char *output = makeOutput(OUTPUT_SIZE);
+
+	ConsoleScreen *screen = new ConsoleScreen(80, 25, 1000);
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < OUTPUT_SIZE; i += CHUNK_SIZE)
+		screen->write((const uint8_t *)output + i, CHUNK_SIZE);
+	std::cout << "decode\t\t" << megabytesPerSecond(OUTPUT_SIZE, start) << " MB/s" << std::endl;
+
+	TextGlyphs glyphs;
+	uint8_t *glyphBits = makeGlyphs(glyphs);
+	if (!checkBlit(glyphs))
+	{
+		std::cout << "blitBuffer() expanded a wrong glyph" << std::endl;
+		return 1;
+	}
+
+	// The last screen decoded, one byte per pixel
+	TextBuffer cells(80, 25);
+	for (int row = 0; row < 25; row++)
+		for (int x = 0; x < 80; x++)
+			cells.setBufferXY(x, row, screen->getLine(row)[x]);
+	delete screen;
+
+	std::vector<uint8_t> pixels(80 * 8 * 25 * glyphs.height);
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < BLIT_FRAMES; i++)
+		cells.blitBuffer(0, 0, 80, 25, glyphs, pixels.data(), 80 * 8);
+	std::cout << "blit\t\t" << megabytesPerSecond(pixels.size() * BLIT_FRAMES, start) << " MB/s" << std::endl;
+	delete[] glyphBits;
+
+	BenchEvents *events = new BenchEvents();
+	BenchLoop *loop = new BenchLoop(master, events);
+	ConsoleView *console = new ConsoleView(master, 80, 25, 1000);
+	loop->insert(console);
+
+	std::atomic<bool> written(false);
+	unsigned frames = 0;
+	double longest = 0;
+
+	start = std::chrono::steady_clock::now();
+	std::thread producer([&]() {
+		for (size_t i = 0; i < OUTPUT_SIZE; i += CHUNK_SIZE)
+			console->write(output + i, CHUNK_SIZE);
+		written = true;
+	});
+
+	loop->measure(written, frames, longest);
+	producer.join();
+
+	std::cout << "view\t\t" << megabytesPerSecond(OUTPUT_SIZE, start) << " MB/s" << std::endl;
+	std::cout << "frames\t\t" << frames << std::endl;
+	std::cout << "longest event\t" << longest << " ms" << std::endl;
+
+	delete loop;
+	delete events;
+	delete[] output;
+	SDL_Quit();
+
+	return 0;
+}
\ No newline at end of file
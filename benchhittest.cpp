@@ -0,0 +1,123 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Hit-testing microbenchmark.
+ * A group is filled with an increasing number of small views, then random
+ * positional events are looked up with the linear walk of the collection
+ * and with the spatial index, to find the crossover point between the two.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <SDL2/SDL.h>
+#include "viewinstances.h"
+#include "viewgroup.h"
+#include "event.h"
+
+static const int SCREEN_WIDTH = 1280;
+static const int SCREEN_HEIGHT = 720;
+static const int VIEW_SIZE = 24;
+static const unsigned CELL_SIZE = 64;
+static const unsigned LOOKUPS = 200000;
+
+/*
+ * A plain view, View cannot be instantiated directly
+ */
+class BenchView : public View
+{
+public:
+	explicit BenchView(Rectangle &limits) : View(limits) {}
+};
+
+static unsigned seed = 12345;
+
+static int nextRandom(int range)
+{
+	/* Deterministic LCG, runs are comparable */
+	seed = seed * 1103515245 + 12345;
+	return (int)((seed >> 16) % (unsigned)range);
+}
+
+static double lookup(ViewGroup *group, PositionalEvent *positions, unsigned &hits)
+{
+	hits = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned i = 0; i < LOOKUPS; i++)
+	{
+		Event evt(positions[i]);
+		if (group->viewAt(&evt))
+			hits++;
+	}
+	auto stop = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(stop - start).count() / LOOKUPS;
+}
+
+int main(void)
+{
+	static const unsigned counts[] = {4, 16, 64, 256, 1024, 4096};
+
+	SDL_Init(0);
+
+	Rectangle master(0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1);
+	ViewRenderInstance::instance()->configure(VRENDER_HW, SCREEN_WIDTH, SCREEN_HEIGHT, 32);
+
+	PositionalEvent *positions = new PositionalEvent[LOOKUPS];
+	for (unsigned i = 0; i < LOOKUPS; i++)
+	{
+		positions[i].x = nextRandom(SCREEN_WIDTH);
+		positions[i].y = nextRandom(SCREEN_HEIGHT);
+		positions[i].xrel = positions[i].yrel = 0;
+		positions[i].buttons = 0;
+		positions[i].status = 0;
+	}
+
+	std::cout << "views\tlinear ns\tgrid ns\t\thits" << std::endl;
+
+	for (unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+	{
+		ViewGroup *group = new ViewGroup(master);
+
+		for (unsigned i = 0; i < counts[c]; i++)
+		{
+			Rectangle limits(0, 0, VIEW_SIZE - 1, VIEW_SIZE - 1);
+			limits.move(nextRandom(SCREEN_WIDTH - VIEW_SIZE), nextRandom(SCREEN_HEIGHT - VIEW_SIZE));
+			group->insert(new BenchView(limits));
+		}
+
+		unsigned linearHits, gridHits;
+		double linear = lookup(group, positions, linearHits);
+		group->setSpatialIndex(CELL_SIZE);
+		double grid = lookup(group, positions, gridHits);
+
+		std::cout << counts[c] << "\t" << linear << "\t\t" << grid << "\t\t" << linearHits;
+		if (linearHits != gridHits)
+			std::cout << " MISMATCH " << gridHits;
+		std::cout << std::endl;
+
+		delete group;
+	}
+
+	delete[] positions;
+	SDL_Quit();
+
+	return 0;
+}
\ No newline at end of file
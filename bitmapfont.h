@@ -0,0 +1,152 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BITMAPFONT_H_
+#define _BITMAPFONT_H_
+
+#include <cstdint>
+
+/*
+ * Pre-rasterized fonts, usable without a font engine.
+ * The tables are plain aggregates: a font can be a constexpr table built
+ * into the program (see builtinfont.h) or be read from a file, nothing is
+ * allocated or computed when it is used.
+ */
+
+// Glyph bitmaps with 1 bit per pixel, bit 7 of a byte is the leftmost pixel
+#define BITMAP_FONT_MONO 1
+// Glyph bitmaps with 1 byte per pixel, the coverage (alpha) of the pixel
+#define BITMAP_FONT_ALPHA 8
+
+struct BitmapGlyph
+{
+	// Unicode code point
+	uint32_t code;
+	// First byte of the bitmap in BitmapFont::bits
+	uint32_t offset;
+	// Size of the bitmap, glyphs without pixels (e.g. space) have size 0
+	uint8_t width, height;
+	// Position of the bitmap: left from the pen, top above the baseline
+	int8_t left, top;
+	// Distance to the pen of the next glyph
+	uint8_t advance;
+};
+
+struct BitmapFont
+{
+	// BITMAP_FONT_MONO or BITMAP_FONT_ALPHA
+	uint8_t bitsPerPixel;
+	// Distance between lines, and from the top of a line to the baseline
+	uint8_t height, ascent;
+	/*
+	 * The glyphs sorted by code. The first numDirect glyphs have
+	 * consecutive codes starting from firstCode, they are indexed
+	 * directly, the others are searched.
+	 */
+	uint16_t numGlyphs, numDirect;
+	uint32_t firstCode;
+	// The glyph drawn for the codes not available
+	uint16_t defaultGlyph;
+	const BitmapGlyph *glyphs;
+	const uint8_t *bits;
+
+	/*
+	 * Get the glyph of a character.
+	 *
+	 * PARAMETERS IN
+	 *  uint32_t code - the code point
+	 *
+	 * RETURN
+	 * the glyph, or the default glyph if the font has not the character
+	 */
+	const BitmapGlyph &find(uint32_t code) const
+	{
+		if (code - firstCode < numDirect)
+			return glyphs[code - firstCode];
+
+		int lo = numDirect, hi = numGlyphs - 1;
+		while (lo <= hi)
+		{
+			int mid = (lo + hi) / 2;
+			if (glyphs[mid].code == code)
+				return glyphs[mid];
+			if (glyphs[mid].code < code)
+				lo = mid + 1;
+			else
+				hi = mid - 1;
+		}
+
+		return glyphs[defaultGlyph];
+	}
+
+	/*
+	 * The distance between rows of the bitmap of a glyph, in bytes.
+	 */
+	inline int stride(const BitmapGlyph &glyph) const
+	{
+		return (bitsPerPixel == BITMAP_FONT_MONO) ? (glyph.width + 7) / 8 : glyph.width;
+	}
+
+	/*
+	 * Get the width of a string, the sum of the advances of its glyphs.
+	 * char strings are Latin-1, uint16_t strings are UCS-2.
+	 */
+	template <class T>
+	int measure(const T *text) const
+	{
+		int width = 0;
+
+		for (; *text; text++)
+			width += find(static_cast<typename CodeOf<T>::type>(*text)).advance;
+
+		return width;
+	}
+
+	/*
+	 * Check if the font has the glyphs of all the characters of a string.
+	 */
+	template <class T>
+	bool covers(const T *text) const
+	{
+		for (; *text; text++)
+		{
+			uint32_t code = static_cast<typename CodeOf<T>::type>(*text);
+			if (find(code).code != code)
+				return false;
+		}
+
+		return true;
+	}
+
+private:
+	// Characters are converted to code points without sign extension
+	template <class T>
+	struct CodeOf
+	{
+		typedef T type;
+	};
+};
+
+template <>
+struct BitmapFont::CodeOf<char>
+{
+	typedef uint8_t type;
+};
+
+#endif
\ No newline at end of file
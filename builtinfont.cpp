@@ -0,0 +1,1617 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "builtinfont.h"
+
+/*
+ * Glyph entries: code, offset, width, height, left, top, advance.
+ * Space has no bitmap.
+ */
+
+static constexpr uint8_t fixedBits[] = {
+	// '!'
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x00,
+	0x20, //   X
+	// '"'
+	0x50, //  X X
+	0x50, //  X X
+	0x50, //  X X
+	// '#'
+	0x50, //  X X
+	0x50, //  X X
+	0xF8, // XXXXX
+	0x50, //  X X
+	0xF8, // XXXXX
+	0x50, //  X X
+	0x50, //  X X
+	// '$'
+	0x20, //   X
+	0x78, //  XXXX
+	0xA0, // X X
+	0x70, //  XXX
+	0x28, //   X X
+	0xF0, // XXXX
+	0x20, //   X
+	// '%'
+	0xC0, // XX
+	0xC8, // XX  X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0x98, // X  XX
+	0x18, //    XX
+	// '&'
+	0x60, //  XX
+	0x90, // X  X
+	0xA0, // X X
+	0x40, //  X
+	0xA8, // X X X
+	0x90, // X  X
+	0x68, //  XX X
+	// '''
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	// '('
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0x20, //   X
+	0x10, //    X
+	// ')'
+	0x40, //  X
+	0x20, //   X
+	0x10, //    X
+	0x10, //    X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	// '*'
+	0x20, //   X
+	0xA8, // X X X
+	0x70, //  XXX
+	0xA8, // X X X
+	0x20, //   X
+	// '+'
+	0x20, //   X
+	0x20, //   X
+	0xF8, // XXXXX
+	0x20, //   X
+	0x20, //   X
+	// ','
+	0x60, //  XX
+	0x20, //   X
+	0x40, //  X
+	// '-'
+	0xF8, // XXXXX
+	// '.'
+	0x60, //  XX
+	0x60, //  XX
+	// '/'
+	0x08, //     X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0x80, // X
+	// '0'
+	0x70, //  XXX
+	0x88, // X   X
+	0x98, // X  XX
+	0xA8, // X X X
+	0xC8, // XX  X
+	0x88, // X   X
+	0x70, //  XXX
+	// '1'
+	0x20, //   X
+	0x60, //  XX
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x70, //  XXX
+	// '2'
+	0x70, //  XXX
+	0x88, // X   X
+	0x08, //     X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0xF8, // XXXXX
+	// '3'
+	0xF8, // XXXXX
+	0x10, //    X
+	0x20, //   X
+	0x10, //    X
+	0x08, //     X
+	0x88, // X   X
+	0x70, //  XXX
+	// '4'
+	0x10, //    X
+	0x30, //   XX
+	0x50, //  X X
+	0x90, // X  X
+	0xF8, // XXXXX
+	0x10, //    X
+	0x10, //    X
+	// '5'
+	0xF8, // XXXXX
+	0x80, // X
+	0xF0, // XXXX
+	0x08, //     X
+	0x08, //     X
+	0x88, // X   X
+	0x70, //  XXX
+	// '6'
+	0x30, //   XX
+	0x40, //  X
+	0x80, // X
+	0xF0, // XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0x70, //  XXX
+	// '7'
+	0xF8, // XXXXX
+	0x08, //     X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	// '8'
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x70, //  XXX
+	// '9'
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x78, //  XXXX
+	0x08, //     X
+	0x10, //    X
+	0x60, //  XX
+	// ':'
+	0x60, //  XX
+	0x60, //  XX
+	0x00,
+	0x60, //  XX
+	0x60, //  XX
+	// ';'
+	0x60, //  XX
+	0x60, //  XX
+	0x00,
+	0x60, //  XX
+	0x20, //   X
+	0x40, //  X
+	// '<'
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0x80, // X
+	0x40, //  X
+	0x20, //   X
+	0x10, //    X
+	// '='
+	0xF8, // XXXXX
+	0x00,
+	0xF8, // XXXXX
+	// '>'
+	0x40, //  X
+	0x20, //   X
+	0x10, //    X
+	0x08, //     X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	// '?'
+	0x70, //  XXX
+	0x88, // X   X
+	0x08, //     X
+	0x10, //    X
+	0x20, //   X
+	0x00,
+	0x20, //   X
+	// '@'
+	0x70, //  XXX
+	0x88, // X   X
+	0x08, //     X
+	0x68, //  XX X
+	0xA8, // X X X
+	0xA8, // X X X
+	0x70, //  XXX
+	// 'A'
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0xF8, // XXXXX
+	0x88, // X   X
+	0x88, // X   X
+	// 'B'
+	0xF0, // XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0xF0, // XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0xF0, // XXXX
+	// 'C'
+	0x70, //  XXX
+	0x88, // X   X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x88, // X   X
+	0x70, //  XXX
+	// 'D'
+	0xE0, // XXX
+	0x90, // X  X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x90, // X  X
+	0xE0, // XXX
+	// 'E'
+	0xF8, // XXXXX
+	0x80, // X
+	0x80, // X
+	0xF0, // XXXX
+	0x80, // X
+	0x80, // X
+	0xF8, // XXXXX
+	// 'F'
+	0xF8, // XXXXX
+	0x80, // X
+	0x80, // X
+	0xF0, // XXXX
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	// 'G'
+	0x70, //  XXX
+	0x88, // X   X
+	0x80, // X
+	0xB8, // X XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x78, //  XXXX
+	// 'H'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0xF8, // XXXXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	// 'I'
+	0x70, //  XXX
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x70, //  XXX
+	// 'J'
+	0x38, //   XXX
+	0x10, //    X
+	0x10, //    X
+	0x10, //    X
+	0x10, //    X
+	0x90, // X  X
+	0x60, //  XX
+	// 'K'
+	0x88, // X   X
+	0x90, // X  X
+	0xA0, // X X
+	0xC0, // XX
+	0xA0, // X X
+	0x90, // X  X
+	0x88, // X   X
+	// 'L'
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0xF8, // XXXXX
+	// 'M'
+	0x88, // X   X
+	0xD8, // XX XX
+	0xA8, // X X X
+	0xA8, // X X X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	// 'N'
+	0x88, // X   X
+	0x88, // X   X
+	0xC8, // XX  X
+	0xA8, // X X X
+	0x98, // X  XX
+	0x88, // X   X
+	0x88, // X   X
+	// 'O'
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x70, //  XXX
+	// 'P'
+	0xF0, // XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0xF0, // XXXX
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	// 'Q'
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0xA8, // X X X
+	0x90, // X  X
+	0x68, //  XX X
+	// 'R'
+	0xF0, // XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0xF0, // XXXX
+	0xA0, // X X
+	0x90, // X  X
+	0x88, // X   X
+	// 'S'
+	0x78, //  XXXX
+	0x80, // X
+	0x80, // X
+	0x70, //  XXX
+	0x08, //     X
+	0x08, //     X
+	0xF0, // XXXX
+	// 'T'
+	0xF8, // XXXXX
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	// 'U'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x70, //  XXX
+	// 'V'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x50, //  X X
+	0x20, //   X
+	// 'W'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0xA8, // X X X
+	0xA8, // X X X
+	0xA8, // X X X
+	0x50, //  X X
+	// 'X'
+	0x88, // X   X
+	0x88, // X   X
+	0x50, //  X X
+	0x20, //   X
+	0x50, //  X X
+	0x88, // X   X
+	0x88, // X   X
+	// 'Y'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x50, //  X X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	// 'Z'
+	0xF8, // XXXXX
+	0x08, //     X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0x80, // X
+	0xF8, // XXXXX
+	// '['
+	0x70, //  XXX
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0x70, //  XXX
+	// '\\'
+	0x80, // X
+	0x40, //  X
+	0x20, //   X
+	0x10, //    X
+	0x08, //     X
+	// ']'
+	0x70, //  XXX
+	0x10, //    X
+	0x10, //    X
+	0x10, //    X
+	0x10, //    X
+	0x10, //    X
+	0x70, //  XXX
+	// '^'
+	0x20, //   X
+	0x50, //  X X
+	0x88, // X   X
+	// '_'
+	0xF8, // XXXXX
+	// '`'
+	0x40, //  X
+	0x20, //   X
+	0x10, //    X
+	// 'a'
+	0x70, //  XXX
+	0x08, //     X
+	0x78, //  XXXX
+	0x88, // X   X
+	0x78, //  XXXX
+	// 'b'
+	0x80, // X
+	0x80, // X
+	0xB0, // X XX
+	0xC8, // XX  X
+	0x88, // X   X
+	0x88, // X   X
+	0xF0, // XXXX
+	// 'c'
+	0x70, //  XXX
+	0x80, // X
+	0x80, // X
+	0x88, // X   X
+	0x70, //  XXX
+	// 'd'
+	0x08, //     X
+	0x08, //     X
+	0x68, //  XX X
+	0x98, // X  XX
+	0x88, // X   X
+	0x88, // X   X
+	0x78, //  XXXX
+	// 'e'
+	0x70, //  XXX
+	0x88, // X   X
+	0xF8, // XXXXX
+	0x80, // X
+	0x70, //  XXX
+	// 'f'
+	0x30, //   XX
+	0x48, //  X  X
+	0x40, //  X
+	0xE0, // XXX
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	// 'g'
+	0x78, //  XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x78, //  XXXX
+	0x08, //     X
+	0x70, //  XXX
+	// 'h'
+	0x80, // X
+	0x80, // X
+	0xB0, // X XX
+	0xC8, // XX  X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	// 'i'
+	0x20, //   X
+	0x00,
+	0x60, //  XX
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x70, //  XXX
+	// 'j'
+	0x10, //    X
+	0x00,
+	0x30, //   XX
+	0x10, //    X
+	0x10, //    X
+	0x10, //    X
+	0x10, //    X
+	0x90, // X  X
+	0x60, //  XX
+	// 'k'
+	0x80, // X
+	0x80, // X
+	0x90, // X  X
+	0xA0, // X X
+	0xC0, // XX
+	0xA0, // X X
+	0x90, // X  X
+	// 'l'
+	0x60, //  XX
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x70, //  XXX
+	// 'm'
+	0xD0, // XX X
+	0xA8, // X X X
+	0xA8, // X X X
+	0x88, // X   X
+	0x88, // X   X
+	// 'n'
+	0xB0, // X XX
+	0xC8, // XX  X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	// 'o'
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x70, //  XXX
+	// 'p'
+	0xF0, // XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0xF0, // XXXX
+	0x80, // X
+	0x80, // X
+	// 'q'
+	0x78, //  XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x78, //  XXXX
+	0x08, //     X
+	0x08, //     X
+	// 'r'
+	0xB0, // X XX
+	0xC8, // XX  X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	// 's'
+	0x78, //  XXXX
+	0x80, // X
+	0x70, //  XXX
+	0x08, //     X
+	0xF0, // XXXX
+	// 't'
+	0x40, //  X
+	0x40, //  X
+	0xE0, // XXX
+	0x40, //  X
+	0x40, //  X
+	0x48, //  X  X
+	0x30, //   XX
+	// 'u'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x98, // X  XX
+	0x68, //  XX X
+	// 'v'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x50, //  X X
+	0x20, //   X
+	// 'w'
+	0x88, // X   X
+	0x88, // X   X
+	0xA8, // X X X
+	0xA8, // X X X
+	0x50, //  X X
+	// 'x'
+	0x88, // X   X
+	0x50, //  X X
+	0x20, //   X
+	0x50, //  X X
+	0x88, // X   X
+	// 'y'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x78, //  XXXX
+	0x08, //     X
+	0x70, //  XXX
+	// 'z'
+	0xF8, // XXXXX
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0xF8, // XXXXX
+	// '{'
+	0x18, //    XX
+	0x20, //   X
+	0x20, //   X
+	0x40, //  X
+	0x20, //   X
+	0x20, //   X
+	0x18, //    XX
+	// '|'
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	// '}'
+	0xC0, // XX
+	0x20, //   X
+	0x20, //   X
+	0x10, //    X
+	0x20, //   X
+	0x20, //   X
+	0xC0, // XX
+	// '~'
+	0x40, //  X
+	0xA8, // X X X
+	0x10, //    X
+	// U+FFFD
+	0xF8, // XXXXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0xF8, // XXXXX
+};
+
+static constexpr BitmapGlyph fixedGlyphs[] = {
+	{0x0020, 0, 0, 0, 0, 0, 6},
+	{0x0021, 0, 5, 7, 0, 7, 6},
+	{0x0022, 7, 5, 3, 0, 7, 6},
+	{0x0023, 10, 5, 7, 0, 7, 6},
+	{0x0024, 17, 5, 7, 0, 7, 6},
+	{0x0025, 24, 5, 7, 0, 7, 6},
+	{0x0026, 31, 5, 7, 0, 7, 6},
+	{0x0027, 38, 5, 3, 0, 7, 6},
+	{0x0028, 41, 5, 7, 0, 7, 6},
+	{0x0029, 48, 5, 7, 0, 7, 6},
+	{0x002A, 55, 5, 5, 0, 6, 6},
+	{0x002B, 60, 5, 5, 0, 6, 6},
+	{0x002C, 65, 5, 3, 0, 3, 6},
+	{0x002D, 68, 5, 1, 0, 4, 6},
+	{0x002E, 69, 5, 2, 0, 2, 6},
+	{0x002F, 71, 5, 5, 0, 6, 6},
+	{0x0030, 76, 5, 7, 0, 7, 6},
+	{0x0031, 83, 5, 7, 0, 7, 6},
+	{0x0032, 90, 5, 7, 0, 7, 6},
+	{0x0033, 97, 5, 7, 0, 7, 6},
+	{0x0034, 104, 5, 7, 0, 7, 6},
+	{0x0035, 111, 5, 7, 0, 7, 6},
+	{0x0036, 118, 5, 7, 0, 7, 6},
+	{0x0037, 125, 5, 7, 0, 7, 6},
+	{0x0038, 132, 5, 7, 0, 7, 6},
+	{0x0039, 139, 5, 7, 0, 7, 6},
+	{0x003A, 146, 5, 5, 0, 6, 6},
+	{0x003B, 151, 5, 6, 0, 6, 6},
+	{0x003C, 157, 5, 7, 0, 7, 6},
+	{0x003D, 164, 5, 3, 0, 5, 6},
+	{0x003E, 167, 5, 7, 0, 7, 6},
+	{0x003F, 174, 5, 7, 0, 7, 6},
+	{0x0040, 181, 5, 7, 0, 7, 6},
+	{0x0041, 188, 5, 7, 0, 7, 6},
+	{0x0042, 195, 5, 7, 0, 7, 6},
+	{0x0043, 202, 5, 7, 0, 7, 6},
+	{0x0044, 209, 5, 7, 0, 7, 6},
+	{0x0045, 216, 5, 7, 0, 7, 6},
+	{0x0046, 223, 5, 7, 0, 7, 6},
+	{0x0047, 230, 5, 7, 0, 7, 6},
+	{0x0048, 237, 5, 7, 0, 7, 6},
+	{0x0049, 244, 5, 7, 0, 7, 6},
+	{0x004A, 251, 5, 7, 0, 7, 6},
+	{0x004B, 258, 5, 7, 0, 7, 6},
+	{0x004C, 265, 5, 7, 0, 7, 6},
+	{0x004D, 272, 5, 7, 0, 7, 6},
+	{0x004E, 279, 5, 7, 0, 7, 6},
+	{0x004F, 286, 5, 7, 0, 7, 6},
+	{0x0050, 293, 5, 7, 0, 7, 6},
+	{0x0051, 300, 5, 7, 0, 7, 6},
+	{0x0052, 307, 5, 7, 0, 7, 6},
+	{0x0053, 314, 5, 7, 0, 7, 6},
+	{0x0054, 321, 5, 7, 0, 7, 6},
+	{0x0055, 328, 5, 7, 0, 7, 6},
+	{0x0056, 335, 5, 7, 0, 7, 6},
+	{0x0057, 342, 5, 7, 0, 7, 6},
+	{0x0058, 349, 5, 7, 0, 7, 6},
+	{0x0059, 356, 5, 7, 0, 7, 6},
+	{0x005A, 363, 5, 7, 0, 7, 6},
+	{0x005B, 370, 5, 7, 0, 7, 6},
+	{0x005C, 377, 5, 5, 0, 6, 6},
+	{0x005D, 382, 5, 7, 0, 7, 6},
+	{0x005E, 389, 5, 3, 0, 7, 6},
+	{0x005F, 392, 5, 1, 0, 1, 6},
+	{0x0060, 393, 5, 3, 0, 7, 6},
+	{0x0061, 396, 5, 5, 0, 5, 6},
+	{0x0062, 401, 5, 7, 0, 7, 6},
+	{0x0063, 408, 5, 5, 0, 5, 6},
+	{0x0064, 413, 5, 7, 0, 7, 6},
+	{0x0065, 420, 5, 5, 0, 5, 6},
+	{0x0066, 425, 5, 7, 0, 7, 6},
+	{0x0067, 432, 5, 7, 0, 5, 6},
+	{0x0068, 439, 5, 7, 0, 7, 6},
+	{0x0069, 446, 5, 7, 0, 7, 6},
+	{0x006A, 453, 5, 9, 0, 7, 6},
+	{0x006B, 462, 5, 7, 0, 7, 6},
+	{0x006C, 469, 5, 7, 0, 7, 6},
+	{0x006D, 476, 5, 5, 0, 5, 6},
+	{0x006E, 481, 5, 5, 0, 5, 6},
+	{0x006F, 486, 5, 5, 0, 5, 6},
+	{0x0070, 491, 5, 7, 0, 5, 6},
+	{0x0071, 498, 5, 7, 0, 5, 6},
+	{0x0072, 505, 5, 5, 0, 5, 6},
+	{0x0073, 510, 5, 5, 0, 5, 6},
+	{0x0074, 515, 5, 7, 0, 7, 6},
+	{0x0075, 522, 5, 5, 0, 5, 6},
+	{0x0076, 527, 5, 5, 0, 5, 6},
+	{0x0077, 532, 5, 5, 0, 5, 6},
+	{0x0078, 537, 5, 5, 0, 5, 6},
+	{0x0079, 542, 5, 7, 0, 5, 6},
+	{0x007A, 549, 5, 5, 0, 5, 6},
+	{0x007B, 554, 5, 7, 0, 7, 6},
+	{0x007C, 561, 5, 7, 0, 7, 6},
+	{0x007D, 568, 5, 7, 0, 7, 6},
+	{0x007E, 575, 5, 3, 0, 5, 6},
+	{0xFFFD, 578, 5, 7, 0, 7, 6},
+};
+
+static constexpr uint8_t proportionalBits[] = {
+	// '!'
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x00,
+	0x80, // X
+	// '"'
+	0xA0, // X X
+	0xA0, // X X
+	0xA0, // X X
+	// '#'
+	0x50, //  X X
+	0x50, //  X X
+	0xF8, // XXXXX
+	0x50, //  X X
+	0xF8, // XXXXX
+	0x50, //  X X
+	0x50, //  X X
+	// '$'
+	0x20, //   X
+	0x78, //  XXXX
+	0xA0, // X X
+	0x70, //  XXX
+	0x28, //   X X
+	0xF0, // XXXX
+	0x20, //   X
+	// '%'
+	0xC0, // XX
+	0xC8, // XX  X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0x98, // X  XX
+	0x18, //    XX
+	// '&'
+	0x60, //  XX
+	0x90, // X  X
+	0xA0, // X X
+	0x40, //  X
+	0xA8, // X X X
+	0x90, // X  X
+	0x68, //  XX X
+	// '''
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	// '('
+	0x20, //   X
+	0x40, //  X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x40, //  X
+	0x20, //   X
+	// ')'
+	0x80, // X
+	0x40, //  X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x40, //  X
+	0x80, // X
+	// '*'
+	0x20, //   X
+	0xA8, // X X X
+	0x70, //  XXX
+	0xA8, // X X X
+	0x20, //   X
+	// '+'
+	0x20, //   X
+	0x20, //   X
+	0xF8, // XXXXX
+	0x20, //   X
+	0x20, //   X
+	// ','
+	0xC0, // XX
+	0x40, //  X
+	0x80, // X
+	// '-'
+	0xF8, // XXXXX
+	// '.'
+	0xC0, // XX
+	0xC0, // XX
+	// '/'
+	0x08, //     X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0x80, // X
+	// '0'
+	0x70, //  XXX
+	0x88, // X   X
+	0x98, // X  XX
+	0xA8, // X X X
+	0xC8, // XX  X
+	0x88, // X   X
+	0x70, //  XXX
+	// '1'
+	0x40, //  X
+	0xC0, // XX
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0xE0, // XXX
+	// '2'
+	0x70, //  XXX
+	0x88, // X   X
+	0x08, //     X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0xF8, // XXXXX
+	// '3'
+	0xF8, // XXXXX
+	0x10, //    X
+	0x20, //   X
+	0x10, //    X
+	0x08, //     X
+	0x88, // X   X
+	0x70, //  XXX
+	// '4'
+	0x10, //    X
+	0x30, //   XX
+	0x50, //  X X
+	0x90, // X  X
+	0xF8, // XXXXX
+	0x10, //    X
+	0x10, //    X
+	// '5'
+	0xF8, // XXXXX
+	0x80, // X
+	0xF0, // XXXX
+	0x08, //     X
+	0x08, //     X
+	0x88, // X   X
+	0x70, //  XXX
+	// '6'
+	0x30, //   XX
+	0x40, //  X
+	0x80, // X
+	0xF0, // XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0x70, //  XXX
+	// '7'
+	0xF8, // XXXXX
+	0x08, //     X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	// '8'
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x70, //  XXX
+	// '9'
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x78, //  XXXX
+	0x08, //     X
+	0x10, //    X
+	0x60, //  XX
+	// ':'
+	0xC0, // XX
+	0xC0, // XX
+	0x00,
+	0xC0, // XX
+	0xC0, // XX
+	// ';'
+	0xC0, // XX
+	0xC0, // XX
+	0x00,
+	0xC0, // XX
+	0x40, //  X
+	0x80, // X
+	// '<'
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0x80, // X
+	0x40, //  X
+	0x20, //   X
+	0x10, //    X
+	// '='
+	0xF8, // XXXXX
+	0x00,
+	0xF8, // XXXXX
+	// '>'
+	0x80, // X
+	0x40, //  X
+	0x20, //   X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0x80, // X
+	// '?'
+	0x70, //  XXX
+	0x88, // X   X
+	0x08, //     X
+	0x10, //    X
+	0x20, //   X
+	0x00,
+	0x20, //   X
+	// '@'
+	0x70, //  XXX
+	0x88, // X   X
+	0x08, //     X
+	0x68, //  XX X
+	0xA8, // X X X
+	0xA8, // X X X
+	0x70, //  XXX
+	// 'A'
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0xF8, // XXXXX
+	0x88, // X   X
+	0x88, // X   X
+	// 'B'
+	0xF0, // XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0xF0, // XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0xF0, // XXXX
+	// 'C'
+	0x70, //  XXX
+	0x88, // X   X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x88, // X   X
+	0x70, //  XXX
+	// 'D'
+	0xE0, // XXX
+	0x90, // X  X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x90, // X  X
+	0xE0, // XXX
+	// 'E'
+	0xF8, // XXXXX
+	0x80, // X
+	0x80, // X
+	0xF0, // XXXX
+	0x80, // X
+	0x80, // X
+	0xF8, // XXXXX
+	// 'F'
+	0xF8, // XXXXX
+	0x80, // X
+	0x80, // X
+	0xF0, // XXXX
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	// 'G'
+	0x70, //  XXX
+	0x88, // X   X
+	0x80, // X
+	0xB8, // X XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x78, //  XXXX
+	// 'H'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0xF8, // XXXXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	// 'I'
+	0xE0, // XXX
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0xE0, // XXX
+	// 'J'
+	0x38, //   XXX
+	0x10, //    X
+	0x10, //    X
+	0x10, //    X
+	0x10, //    X
+	0x90, // X  X
+	0x60, //  XX
+	// 'K'
+	0x88, // X   X
+	0x90, // X  X
+	0xA0, // X X
+	0xC0, // XX
+	0xA0, // X X
+	0x90, // X  X
+	0x88, // X   X
+	// 'L'
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0xF8, // XXXXX
+	// 'M'
+	0x88, // X   X
+	0xD8, // XX XX
+	0xA8, // X X X
+	0xA8, // X X X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	// 'N'
+	0x88, // X   X
+	0x88, // X   X
+	0xC8, // XX  X
+	0xA8, // X X X
+	0x98, // X  XX
+	0x88, // X   X
+	0x88, // X   X
+	// 'O'
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x70, //  XXX
+	// 'P'
+	0xF0, // XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0xF0, // XXXX
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	// 'Q'
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0xA8, // X X X
+	0x90, // X  X
+	0x68, //  XX X
+	// 'R'
+	0xF0, // XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0xF0, // XXXX
+	0xA0, // X X
+	0x90, // X  X
+	0x88, // X   X
+	// 'S'
+	0x78, //  XXXX
+	0x80, // X
+	0x80, // X
+	0x70, //  XXX
+	0x08, //     X
+	0x08, //     X
+	0xF0, // XXXX
+	// 'T'
+	0xF8, // XXXXX
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	// 'U'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x70, //  XXX
+	// 'V'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x50, //  X X
+	0x20, //   X
+	// 'W'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0xA8, // X X X
+	0xA8, // X X X
+	0xA8, // X X X
+	0x50, //  X X
+	// 'X'
+	0x88, // X   X
+	0x88, // X   X
+	0x50, //  X X
+	0x20, //   X
+	0x50, //  X X
+	0x88, // X   X
+	0x88, // X   X
+	// 'Y'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x50, //  X X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	// 'Z'
+	0xF8, // XXXXX
+	0x08, //     X
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0x80, // X
+	0xF8, // XXXXX
+	// '['
+	0xE0, // XXX
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0xE0, // XXX
+	// '\\'
+	0x80, // X
+	0x40, //  X
+	0x20, //   X
+	0x10, //    X
+	0x08, //     X
+	// ']'
+	0xE0, // XXX
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0x20, //   X
+	0xE0, // XXX
+	// '^'
+	0x20, //   X
+	0x50, //  X X
+	0x88, // X   X
+	// '_'
+	0xF8, // XXXXX
+	// '`'
+	0x80, // X
+	0x40, //  X
+	0x20, //   X
+	// 'a'
+	0x70, //  XXX
+	0x08, //     X
+	0x78, //  XXXX
+	0x88, // X   X
+	0x78, //  XXXX
+	// 'b'
+	0x80, // X
+	0x80, // X
+	0xB0, // X XX
+	0xC8, // XX  X
+	0x88, // X   X
+	0x88, // X   X
+	0xF0, // XXXX
+	// 'c'
+	0x70, //  XXX
+	0x80, // X
+	0x80, // X
+	0x88, // X   X
+	0x70, //  XXX
+	// 'd'
+	0x08, //     X
+	0x08, //     X
+	0x68, //  XX X
+	0x98, // X  XX
+	0x88, // X   X
+	0x88, // X   X
+	0x78, //  XXXX
+	// 'e'
+	0x70, //  XXX
+	0x88, // X   X
+	0xF8, // XXXXX
+	0x80, // X
+	0x70, //  XXX
+	// 'f'
+	0x30, //   XX
+	0x48, //  X  X
+	0x40, //  X
+	0xE0, // XXX
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	// 'g'
+	0x78, //  XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x78, //  XXXX
+	0x08, //     X
+	0x70, //  XXX
+	// 'h'
+	0x80, // X
+	0x80, // X
+	0xB0, // X XX
+	0xC8, // XX  X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	// 'i'
+	0x40, //  X
+	0x00,
+	0xC0, // XX
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0xE0, // XXX
+	// 'j'
+	0x10, //    X
+	0x00,
+	0x30, //   XX
+	0x10, //    X
+	0x10, //    X
+	0x10, //    X
+	0x10, //    X
+	0x90, // X  X
+	0x60, //  XX
+	// 'k'
+	0x80, // X
+	0x80, // X
+	0x90, // X  X
+	0xA0, // X X
+	0xC0, // XX
+	0xA0, // X X
+	0x90, // X  X
+	// 'l'
+	0xC0, // XX
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0x40, //  X
+	0xE0, // XXX
+	// 'm'
+	0xD0, // XX X
+	0xA8, // X X X
+	0xA8, // X X X
+	0x88, // X   X
+	0x88, // X   X
+	// 'n'
+	0xB0, // X XX
+	0xC8, // XX  X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	// 'o'
+	0x70, //  XXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x70, //  XXX
+	// 'p'
+	0xF0, // XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0xF0, // XXXX
+	0x80, // X
+	0x80, // X
+	// 'q'
+	0x78, //  XXXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x78, //  XXXX
+	0x08, //     X
+	0x08, //     X
+	// 'r'
+	0xB0, // X XX
+	0xC8, // XX  X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	// 's'
+	0x78, //  XXXX
+	0x80, // X
+	0x70, //  XXX
+	0x08, //     X
+	0xF0, // XXXX
+	// 't'
+	0x40, //  X
+	0x40, //  X
+	0xE0, // XXX
+	0x40, //  X
+	0x40, //  X
+	0x48, //  X  X
+	0x30, //   XX
+	// 'u'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x98, // X  XX
+	0x68, //  XX X
+	// 'v'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x50, //  X X
+	0x20, //   X
+	// 'w'
+	0x88, // X   X
+	0x88, // X   X
+	0xA8, // X X X
+	0xA8, // X X X
+	0x50, //  X X
+	// 'x'
+	0x88, // X   X
+	0x50, //  X X
+	0x20, //   X
+	0x50, //  X X
+	0x88, // X   X
+	// 'y'
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x78, //  XXXX
+	0x08, //     X
+	0x70, //  XXX
+	// 'z'
+	0xF8, // XXXXX
+	0x10, //    X
+	0x20, //   X
+	0x40, //  X
+	0xF8, // XXXXX
+	// '{'
+	0x30, //   XX
+	0x40, //  X
+	0x40, //  X
+	0x80, // X
+	0x40, //  X
+	0x40, //  X
+	0x30, //   XX
+	// '|'
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	0x80, // X
+	// '}'
+	0xC0, // XX
+	0x20, //   X
+	0x20, //   X
+	0x10, //    X
+	0x20, //   X
+	0x20, //   X
+	0xC0, // XX
+	// '~'
+	0x40, //  X
+	0xA8, // X X X
+	0x10, //    X
+	// U+FFFD
+	0xF8, // XXXXX
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0x88, // X   X
+	0xF8, // XXXXX
+};
+
+static constexpr BitmapGlyph proportionalGlyphs[] = {
+	{0x0020, 0, 0, 0, 0, 0, 3},
+	{0x0021, 0, 1, 7, 0, 7, 2},
+	{0x0022, 7, 3, 3, 0, 7, 4},
+	{0x0023, 10, 5, 7, 0, 7, 6},
+	{0x0024, 17, 5, 7, 0, 7, 6},
+	{0x0025, 24, 5, 7, 0, 7, 6},
+	{0x0026, 31, 5, 7, 0, 7, 6},
+	{0x0027, 38, 1, 3, 0, 7, 2},
+	{0x0028, 41, 3, 7, 0, 7, 4},
+	{0x0029, 48, 3, 7, 0, 7, 4},
+	{0x002A, 55, 5, 5, 0, 6, 6},
+	{0x002B, 60, 5, 5, 0, 6, 6},
+	{0x002C, 65, 2, 3, 0, 3, 3},
+	{0x002D, 68, 5, 1, 0, 4, 6},
+	{0x002E, 69, 2, 2, 0, 2, 3},
+	{0x002F, 71, 5, 5, 0, 6, 6},
+	{0x0030, 76, 5, 7, 0, 7, 6},
+	{0x0031, 83, 3, 7, 0, 7, 4},
+	{0x0032, 90, 5, 7, 0, 7, 6},
+	{0x0033, 97, 5, 7, 0, 7, 6},
+	{0x0034, 104, 5, 7, 0, 7, 6},
+	{0x0035, 111, 5, 7, 0, 7, 6},
+	{0x0036, 118, 5, 7, 0, 7, 6},
+	{0x0037, 125, 5, 7, 0, 7, 6},
+	{0x0038, 132, 5, 7, 0, 7, 6},
+	{0x0039, 139, 5, 7, 0, 7, 6},
+	{0x003A, 146, 2, 5, 0, 6, 3},
+	{0x003B, 151, 2, 6, 0, 6, 3},
+	{0x003C, 157, 4, 7, 0, 7, 5},
+	{0x003D, 164, 5, 3, 0, 5, 6},
+	{0x003E, 167, 4, 7, 0, 7, 5},
+	{0x003F, 174, 5, 7, 0, 7, 6},
+	{0x0040, 181, 5, 7, 0, 7, 6},
+	{0x0041, 188, 5, 7, 0, 7, 6},
+	{0x0042, 195, 5, 7, 0, 7, 6},
+	{0x0043, 202, 5, 7, 0, 7, 6},
+	{0x0044, 209, 5, 7, 0, 7, 6},
+	{0x0045, 216, 5, 7, 0, 7, 6},
+	{0x0046, 223, 5, 7, 0, 7, 6},
+	{0x0047, 230, 5, 7, 0, 7, 6},
+	{0x0048, 237, 5, 7, 0, 7, 6},
+	{0x0049, 244, 3, 7, 0, 7, 4},
+	{0x004A, 251, 5, 7, 0, 7, 6},
+	{0x004B, 258, 5, 7, 0, 7, 6},
+	{0x004C, 265, 5, 7, 0, 7, 6},
+	{0x004D, 272, 5, 7, 0, 7, 6},
+	{0x004E, 279, 5, 7, 0, 7, 6},
+	{0x004F, 286, 5, 7, 0, 7, 6},
+	{0x0050, 293, 5, 7, 0, 7, 6},
+	{0x0051, 300, 5, 7, 0, 7, 6},
+	{0x0052, 307, 5, 7, 0, 7, 6},
+	{0x0053, 314, 5, 7, 0, 7, 6},
+	{0x0054, 321, 5, 7, 0, 7, 6},
+	{0x0055, 328, 5, 7, 0, 7, 6},
+	{0x0056, 335, 5, 7, 0, 7, 6},
+	{0x0057, 342, 5, 7, 0, 7, 6},
+	{0x0058, 349, 5, 7, 0, 7, 6},
+	{0x0059, 356, 5, 7, 0, 7, 6},
+	{0x005A, 363, 5, 7, 0, 7, 6},
+	{0x005B, 370, 3, 7, 0, 7, 4},
+	{0x005C, 377, 5, 5, 0, 6, 6},
+	{0x005D, 382, 3, 7, 0, 7, 4},
+	{0x005E, 389, 5, 3, 0, 7, 6},
+	{0x005F, 392, 5, 1, 0, 1, 6},
+	{0x0060, 393, 3, 3, 0, 7, 4},
+	{0x0061, 396, 5, 5, 0, 5, 6},
+	{0x0062, 401, 5, 7, 0, 7, 6},
+	{0x0063, 408, 5, 5, 0, 5, 6},
+	{0x0064, 413, 5, 7, 0, 7, 6},
+	{0x0065, 420, 5, 5, 0, 5, 6},
+	{0x0066, 425, 5, 7, 0, 7, 6},
+	{0x0067, 432, 5, 7, 0, 5, 6},
+	{0x0068, 439, 5, 7, 0, 7, 6},
+	{0x0069, 446, 3, 7, 0, 7, 4},
+	{0x006A, 453, 4, 9, 0, 7, 5},
+	{0x006B, 462, 4, 7, 0, 7, 5},
+	{0x006C, 469, 3, 7, 0, 7, 4},
+	{0x006D, 476, 5, 5, 0, 5, 6},
+	{0x006E, 481, 5, 5, 0, 5, 6},
+	{0x006F, 486, 5, 5, 0, 5, 6},
+	{0x0070, 491, 5, 7, 0, 5, 6},
+	{0x0071, 498, 5, 7, 0, 5, 6},
+	{0x0072, 505, 5, 5, 0, 5, 6},
+	{0x0073, 510, 5, 5, 0, 5, 6},
+	{0x0074, 515, 5, 7, 0, 7, 6},
+	{0x0075, 522, 5, 5, 0, 5, 6},
+	{0x0076, 527, 5, 5, 0, 5, 6},
+	{0x0077, 532, 5, 5, 0, 5, 6},
+	{0x0078, 537, 5, 5, 0, 5, 6},
+	{0x0079, 542, 5, 7, 0, 5, 6},
+	{0x007A, 549, 5, 5, 0, 5, 6},
+	{0x007B, 554, 4, 7, 0, 7, 5},
+	{0x007C, 561, 1, 7, 0, 7, 2},
+	{0x007D, 568, 4, 7, 0, 7, 5},
+	{0x007E, 575, 5, 3, 0, 5, 6},
+	{0xFFFD, 578, 5, 7, 0, 7, 6},
+};
+
+// Glyphs 0x20 - 0x7E are indexed directly, U+FFFD follows
+#define BUILTIN_DIRECT (0x7F - 0x20)
+#define BUILTIN_GLYPHS (sizeof(fixedGlyphs) / sizeof(fixedGlyphs[0]))
+
+static_assert(sizeof(fixedGlyphs) == sizeof(proportionalGlyphs), "The builtin fonts have the same glyphs");
+
+const BitmapFont builtinFont = {
+	BITMAP_FONT_MONO,
+	11,
+	8,
+	BUILTIN_GLYPHS,
+	BUILTIN_DIRECT,
+	0x20,
+	BUILTIN_DIRECT,
+	fixedGlyphs,
+	fixedBits};
+
+const BitmapFont builtinPropFont = {
+	BITMAP_FONT_MONO,
+	11,
+	8,
+	BUILTIN_GLYPHS,
+	BUILTIN_DIRECT,
+	0x20,
+	BUILTIN_DIRECT,
+	proportionalGlyphs,
+	proportionalBits};
\ No newline at end of file
@@ -0,0 +1,37 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BUILTINFONT_H_
+#define _BUILTINFONT_H_
+
+#include "bitmapfont.h"
+
+/*
+ * Fonts built into the program, for the renderers without a font engine.
+ * Both have the glyphs of printable ASCII and U+FFFD, drawn for the
+ * characters not available; they are 5x7 dot matrix fonts with descenders,
+ * 1 bit per pixel, 11 pixels lines.
+ */
+
+// Every glyph advances 6 pixels, the columns of a text are aligned
+extern const BitmapFont builtinFont;
+// The glyphs advance by their width plus one pixel
+extern const BitmapFont builtinPropFont;
+
+#endif
\ No newline at end of file
@@ -28,7 +28,7 @@ Button::Button(Rectangle &rect) : AbstractButton(rect)
 void Button::drawView()
 {
 	Rectangle viewRect;
-	ViewRender *r = GRenderer;
+	ViewRenderBackend *r = GRenderer;
 	Palette *p = GPaletteGroup->getPalette(PaletteGroup::PAL_BUTTON);
 	unsigned color[2];
 
@@ -34,7 +34,10 @@ union ARGBColor
 	uint32_t color;
 };
 
-// TODO: this should take into account little and big endian
+/*
+ * Components are extracted by shifting, which does not depend on the byte
+ * order of the host; only the color member of ARGBColor does.
+ */
 inline void toARGBColor(const uint32_t ARGB, union ARGBColor *clr)
 {
 	clr->colorARGB.b = ARGB & 0xFF;
@@ -43,4 +46,39 @@ inline void toARGBColor(const uint32_t ARGB, union ARGBColor *clr)
 	clr->colorARGB.a = (ARGB >> 24) & 0xFF;
 }
 
+/*
+ * Component access on 0xAARRGGBB colors, resolved at compile time
+ * when the color is a constant.
+ */
+constexpr uint8_t alphaOf(uint32_t argb) { return (argb >> 24) & 0xFF; }
+constexpr uint8_t redOf(uint32_t argb) { return (argb >> 16) & 0xFF; }
+constexpr uint8_t greenOf(uint32_t argb) { return (argb >> 8) & 0xFF; }
+constexpr uint8_t blueOf(uint32_t argb) { return argb & 0xFF; }
+
+constexpr uint32_t makeARGB(uint8_t a, uint8_t r, uint8_t g, uint8_t b)
+{
+	return ((uint32_t)a << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+}
+
+/*
+ * Host byte order, video memory formats are defined little endian
+ */
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+constexpr bool hostBigEndian = true;
+#else
+constexpr bool hostBigEndian = false;
+#endif
+
+constexpr uint16_t swap16(uint16_t v) { return (uint16_t)((v << 8) | (v >> 8)); }
+constexpr uint32_t swap32(uint32_t v)
+{
+	return (v << 24) | ((v << 8) & 0x00FF0000) | ((v >> 8) & 0x0000FF00) | (v >> 24);
+}
+
+/*
+ * Convert a little endian value to and from host order
+ */
+constexpr uint16_t toLE16(uint16_t v) { return (hostBigEndian) ? swap16(v) : v; }
+constexpr uint32_t toLE32(uint32_t v) { return (hostBigEndian) ? swap32(v) : v; }
+
 #endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CONSOLE_PALETTE_H_
+#define _CONSOLE_PALETTE_H_
+
+/*
+ * The 16 colors of the ANSI SGR attributes, in the order of the
+ * 30 - 37 codes, then the bright ones.
+ */
+enum CONSOLE_PAL
+{
+	CONSOLE_BLACK,
+	CONSOLE_RED,
+	CONSOLE_GREEN,
+	CONSOLE_YELLOW,
+	CONSOLE_BLUE,
+	CONSOLE_MAGENTA,
+	CONSOLE_CYAN,
+	CONSOLE_WHITE,
+	CONSOLE_BRIGHT_BLACK,
+	CONSOLE_BRIGHT_RED,
+	CONSOLE_BRIGHT_GREEN,
+	CONSOLE_BRIGHT_YELLOW,
+	CONSOLE_BRIGHT_BLUE,
+	CONSOLE_BRIGHT_MAGENTA,
+	CONSOLE_BRIGHT_CYAN,
+	CONSOLE_BRIGHT_WHITE,
+	CONSOLE_PAL_NUM
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,731 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "viewinstances.h"
+#include "consoleview.h"
+#include "viewexec.h"
+#include "console_palette.h"
+
+// Foreground and background of the cells after a reset
+#define CONSOLE_DEFAULT_FG CONSOLE_WHITE
+#define CONSOLE_DEFAULT_BG CONSOLE_BLACK
+#define CONSOLE_TAB_SIZE 8
+
+ConsoleScreen::ConsoleScreen(int columns, int rows, int scrollback) : cells(columns, rows + scrollback),
+								      parser(this),
+								      columns(columns),
+								      rows(rows),
+								      capacity(rows + scrollback)
+{
+	reset();
+}
+
+void ConsoleScreen::reset()
+{
+	head = 0;
+	history = 0;
+	scrolled = 0;
+	cx = cy = 0;
+	wrapPending = false;
+	cursorVisible = true;
+	marginTop = 0;
+	marginBottom = rows - 1;
+	fg = savedFg = CONSOLE_DEFAULT_FG;
+	bg = savedBg = CONSOLE_DEFAULT_BG;
+	bold = savedBold = false;
+	inverse = savedInverse = false;
+	savedX = savedY = 0;
+	updateAttribute();
+
+	cells.setBuffer(' ' | (attr << 8));
+	parser.reset();
+}
+
+const uint16_t *ConsoleScreen::getLine(int row, int offset) const
+{
+	offset = std::min(std::max(offset, 0), history);
+	return cells.getRow((head + capacity + row - offset) % capacity);
+}
+
+bool ConsoleScreen::getDirtySpan(int row, int &first, int &last) const
+{
+	int p = physical(row);
+
+	if (!cells.isRowDirty(p))
+		return false;
+
+	cells.getDirtySpan(p, first, last);
+	return true;
+}
+
+unsigned ConsoleScreen::takeScrolled()
+{
+	unsigned lines = scrolled;
+
+	scrolled = 0;
+	return lines;
+}
+
+void ConsoleScreen::touch(int x, int y)
+{
+	if ((y < 0) || (y >= rows))
+		return;
+
+	int p = physical(y);
+	cells.setBufferXY(x, p, cells.getBufferXY(x, p));
+}
+
+void ConsoleScreen::print(const uint8_t *text, int len)
+{
+	while (len > 0)
+	{
+		if (wrapPending)
+		{
+			newLine();
+			wrapPending = false;
+		}
+
+		int n = std::min(len, columns - cx);
+		cells.setText(cx, physical(cy), text, n, attr);
+		text += n;
+		len -= n;
+		cx += n;
+
+		if (cx == columns)
+		{
+			cx = columns - 1;
+			wrapPending = true;
+		}
+	}
+}
+
+void ConsoleScreen::printCode(uint32_t code)
+{
+	// Cells hold Latin-1 characters
+	uint8_t c = (code < 0x100) ? code : '?';
+
+	print(&c, 1);
+}
+
+void ConsoleScreen::execute(uint8_t code)
+{
+	switch (code)
+	{
+	case '\r':
+		cx = 0;
+		wrapPending = false;
+		break;
+
+	case '\n':
+	case '\v':
+	case '\f':
+		newLine();
+		wrapPending = false;
+		break;
+
+	case '\b':
+		if (cx > 0)
+			cx--;
+		wrapPending = false;
+		break;
+
+	case '\t':
+		cx = std::min((cx / CONSOLE_TAB_SIZE + 1) * CONSOLE_TAB_SIZE, columns - 1);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void ConsoleScreen::escDispatch(uint8_t final, uint8_t intermediate)
+{
+	// Character sets are not supported
+	if (intermediate)
+		return;
+
+	switch (final)
+	{
+	case '7':
+		savedX = cx;
+		savedY = cy;
+		savedFg = fg;
+		savedBg = bg;
+		savedBold = bold;
+		savedInverse = inverse;
+		break;
+
+	case '8':
+		fg = savedFg;
+		bg = savedBg;
+		bold = savedBold;
+		inverse = savedInverse;
+		updateAttribute();
+		setCursor(savedX, savedY);
+		break;
+
+	case 'D':
+		// Index, a newline without carriage return
+		if (cy == marginBottom)
+			scrollUp(marginTop, marginBottom, 1);
+		else if (cy < rows - 1)
+			cy++;
+		break;
+
+	case 'E':
+		newLine();
+		break;
+
+	case 'M':
+		reverseIndex();
+		break;
+
+	case 'c':
+		reset();
+		break;
+
+	default:
+		break;
+	}
+}
+
+void ConsoleScreen::csiDispatch(uint8_t final, const int *params, int num, uint8_t prefix, uint8_t intermediate)
+{
+	// The first two parameters, omitted or 0 take the default value
+	int p0 = ((num > 0) && params[0]) ? params[0] : 1;
+	int p1 = ((num > 1) && params[1]) ? params[1] : 1;
+	int mode = (num > 0) ? params[0] : 0;
+
+	if (intermediate)
+		return;
+
+	if (prefix)
+	{
+		// DECTCEM, show or hide the cursor
+		if ((prefix == '?') && (mode == 25) && ((final == 'h') || (final == 'l')))
+			cursorVisible = (final == 'h');
+		return;
+	}
+
+	switch (final)
+	{
+	case 'A':
+		setCursor(cx, cy - p0);
+		break;
+
+	case 'B':
+		setCursor(cx, cy + p0);
+		break;
+
+	case 'C':
+		setCursor(cx + p0, cy);
+		break;
+
+	case 'D':
+		setCursor(cx - p0, cy);
+		break;
+
+	case 'E':
+		setCursor(0, cy + p0);
+		break;
+
+	case 'F':
+		setCursor(0, cy - p0);
+		break;
+
+	case 'G':
+	case '`':
+		setCursor(p0 - 1, cy);
+		break;
+
+	case 'H':
+	case 'f':
+		setCursor(p1 - 1, p0 - 1);
+		break;
+
+	case 'd':
+		setCursor(cx, p0 - 1);
+		break;
+
+	case 'J':
+		if (mode == 0)
+		{
+			clearColumns(cy, cx, columns - 1);
+			clearRows(cy + 1, rows - 1);
+		}
+		else if (mode == 1)
+		{
+			clearRows(0, cy - 1);
+			clearColumns(cy, 0, cx);
+		}
+		else if ((mode == 2) || (mode == 3))
+		{
+			clearRows(0, rows - 1);
+			if (mode == 3)
+				history = 0;
+		}
+		break;
+
+	case 'K':
+		if (mode == 0)
+			clearColumns(cy, cx, columns - 1);
+		else if (mode == 1)
+			clearColumns(cy, 0, cx);
+		else if (mode == 2)
+			clearColumns(cy, 0, columns - 1);
+		break;
+
+	case 'L':
+		if ((cy >= marginTop) && (cy <= marginBottom))
+			scrollDown(cy, marginBottom, p0);
+		break;
+
+	case 'M':
+		if ((cy >= marginTop) && (cy <= marginBottom))
+			scrollUp(cy, marginBottom, p0);
+		break;
+
+	case 'S':
+		scrollUp(marginTop, marginBottom, p0);
+		break;
+
+	case 'T':
+		scrollDown(marginTop, marginBottom, p0);
+		break;
+
+	case '@':
+		p0 = std::min(p0, columns - cx);
+		cells.move(cx, physical(cy), columns - cx - p0, 1, cx + p0, physical(cy));
+		clearColumns(cy, cx, cx + p0 - 1);
+		break;
+
+	case 'P':
+		p0 = std::min(p0, columns - cx);
+		cells.move(cx + p0, physical(cy), columns - cx - p0, 1, cx, physical(cy));
+		clearColumns(cy, columns - p0, columns - 1);
+		break;
+
+	case 'X':
+		clearColumns(cy, cx, std::min(cx + p0, columns) - 1);
+		break;
+
+	case 'm':
+		setGraphics(params, num);
+		break;
+
+	case 'r':
+		marginTop = p0 - 1;
+		marginBottom = ((num > 1) && params[1]) ? params[1] - 1 : rows - 1;
+		if ((marginTop >= marginBottom) || (marginBottom >= rows))
+		{
+			marginTop = 0;
+			marginBottom = rows - 1;
+		}
+		setCursor(0, 0);
+		break;
+
+	case 's':
+		escDispatch('7', 0);
+		break;
+
+	case 'u':
+		escDispatch('8', 0);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void ConsoleScreen::newLine()
+{
+	cx = 0;
+	if (cy == marginBottom)
+		scrollUp(marginTop, marginBottom, 1);
+	else if (cy < rows - 1)
+		cy++;
+}
+
+void ConsoleScreen::reverseIndex()
+{
+	if (cy == marginTop)
+		scrollDown(marginTop, marginBottom, 1);
+	else if (cy > 0)
+		cy--;
+}
+
+void ConsoleScreen::scrollUp(int top, int bottom, int lines)
+{
+	lines = std::min(lines, bottom - top + 1);
+
+	if ((top == 0) && (bottom == rows - 1))
+	{
+		// The rows leaving the screen join the scrollback
+		for (int i = 0; i < lines; i++)
+		{
+			head = (head + 1) % capacity;
+			clearRows(rows - 1, rows - 1);
+		}
+		history = std::min(history + lines, capacity - rows);
+		scrolled += lines;
+		return;
+	}
+
+	for (int row = top; row <= bottom - lines; row++)
+		cells.move(0, physical(row + lines), columns, 1, 0, physical(row));
+	clearRows(bottom - lines + 1, bottom);
+}
+
+void ConsoleScreen::scrollDown(int top, int bottom, int lines)
+{
+	lines = std::min(lines, bottom - top + 1);
+
+	for (int row = bottom; row >= top + lines; row--)
+		cells.move(0, physical(row - lines), columns, 1, 0, physical(row));
+	clearRows(top, top + lines - 1);
+}
+
+void ConsoleScreen::clearRows(int top, int bottom)
+{
+	for (int row = std::max(top, 0); row <= std::min(bottom, rows - 1); row++)
+		cells.fill(0, physical(row), columns, 1, ' ' | (attr << 8));
+}
+
+void ConsoleScreen::clearColumns(int row, int first, int last)
+{
+	cells.fill(first, physical(row), last - first + 1, 1, ' ' | (attr << 8));
+}
+
+void ConsoleScreen::setGraphics(const int *params, int num)
+{
+	if (!num)
+	{
+		fg = CONSOLE_DEFAULT_FG;
+		bg = CONSOLE_DEFAULT_BG;
+		bold = inverse = false;
+	}
+
+	for (int i = 0; i < num; i++)
+	{
+		int v = params[i];
+
+		if (v == 0)
+		{
+			fg = CONSOLE_DEFAULT_FG;
+			bg = CONSOLE_DEFAULT_BG;
+			bold = inverse = false;
+		}
+		else if (v == 1)
+			bold = true;
+		else if (v == 22)
+			bold = false;
+		else if (v == 7)
+			inverse = true;
+		else if (v == 27)
+			inverse = false;
+		else if ((v >= 30) && (v <= 37))
+			fg = v - 30;
+		else if (v == 39)
+			fg = CONSOLE_DEFAULT_FG;
+		else if ((v >= 40) && (v <= 47))
+			bg = v - 40;
+		else if (v == 49)
+			bg = CONSOLE_DEFAULT_BG;
+		else if ((v >= 90) && (v <= 97))
+			fg = v - 90 + CONSOLE_BRIGHT_BLACK;
+		else if ((v >= 100) && (v <= 107))
+			bg = v - 100 + CONSOLE_BRIGHT_BLACK;
+		else if ((v == 38) || (v == 48))
+		{
+			// 256 colors and RGB colors, only the first 16 colors are kept
+			if ((i + 2 < num) && (params[i + 1] == 5))
+			{
+				if ((params[i + 2] < CONSOLE_PAL_NUM) && (v == 38))
+					fg = params[i + 2];
+				else if (params[i + 2] < CONSOLE_PAL_NUM)
+					bg = params[i + 2];
+				i += 2;
+			}
+			else if ((i + 1 < num) && (params[i + 1] == 2))
+				i += 4;
+		}
+	}
+
+	updateAttribute();
+}
+
+void ConsoleScreen::setCursor(int x, int y)
+{
+	cx = std::min(std::max(x, 0), columns - 1);
+	cy = std::min(std::max(y, 0), rows - 1);
+	wrapPending = false;
+}
+
+void ConsoleScreen::updateAttribute()
+{
+	uint8_t f = (bold && (fg < CONSOLE_BRIGHT_BLACK)) ? fg + CONSOLE_BRIGHT_BLACK : fg;
+	uint8_t b = bg;
+
+	if (inverse)
+		std::swap(f, b);
+
+	attr = f | (b << 4);
+}
+
+ConsoleView::ConsoleView(Rectangle &viewLimits, int columns, int rows, int scrollback) : View(viewLimits),
+											 screen(columns, rows, scrollback),
+											 offset(0),
+											 fullRedraw(true),
+											 lastCursorX(0),
+											 lastCursorY(0),
+											 cellWidth(0),
+											 cellHeight(0),
+											 updatePosted(false),
+											 closing(false),
+											 writers(0),
+											 pendingPos(0)
+{
+}
+
+ConsoleView::~ConsoleView()
+{
+	{
+		std::unique_lock<std::mutex> lock(inputLock);
+		closing = true;
+		inputDrained.notify_all();
+		inputDrained.wait(lock, [this] { return !writers; });
+	}
+
+	ViewExec::cancelUpdate(this);
+}
+
+bool ConsoleView::write(const char *data, size_t len)
+{
+	bool written, post;
+
+	{
+		std::unique_lock<std::mutex> lock(inputLock);
+		if (closing)
+			return false;
+
+		writers++;
+		inputDrained.wait(lock, [this] { return closing || (input.size() < CONSOLE_INPUT_LIMIT); });
+		written = !closing;
+		post = written && !updatePosted;
+		if (written)
+		{
+			input.insert(input.end(), data, data + len);
+			updatePosted = true;
+		}
+	}
+
+	// Still counted as a writer, the view cannot cancel the update before
+	if (post)
+		ViewExec::postUpdate(this);
+
+	std::lock_guard<std::mutex> lock(inputLock);
+	if (!--writers && closing)
+		inputDrained.notify_all();
+
+	return written;
+}
+
+void ConsoleView::setScrollback(int lines)
+{
+	offset = std::min(std::max(lines, 0), screen.getHistory());
+	fullRedraw = true;
+	setChanged(VIEW_CHANGED_REDRAW);
+	sendCommandToTopView(CMD_REDRAW);
+}
+
+void ConsoleView::update()
+{
+	bool more;
+
+	{
+		std::lock_guard<std::mutex> lock(inputLock);
+		if (pendingPos == pending.size())
+		{
+			// Take the whole queue, the buffers are swapped and reused
+			pending.clear();
+			pending.swap(input);
+			pendingPos = 0;
+			inputDrained.notify_all();
+		}
+	}
+
+	size_t len = std::min(pending.size() - pendingPos, (size_t)CONSOLE_UPDATE_BUDGET);
+	screen.write(pending.data() + pendingPos, len);
+	pendingPos += len;
+
+	{
+		std::lock_guard<std::mutex> lock(inputLock);
+		more = (pendingPos < pending.size()) || !input.empty();
+		updatePosted = more;
+	}
+
+	/*
+	 * While the input keeps coming frames are limited, the screen can
+	 * change many times in between.
+	 */
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (!more || (now - lastFrame >= std::chrono::milliseconds(CONSOLE_FRAME_MS)))
+	{
+		lastFrame = now;
+		setChanged(VIEW_CHANGED_REDRAW);
+		sendCommandToTopView(CMD_REDRAW);
+	}
+
+	if (more)
+		ViewExec::postUpdate(this);
+}
+
+void ConsoleView::drawView()
+{
+	ViewRenderBackend *r = GRenderer;
+	Palette *p = GPaletteGroup->getPalette(PaletteGroup::PAL_CONSOLE);
+	Rectangle viewRect;
+	getViewport(viewRect);
+
+	if (!cellWidth)
+	{
+		Rectangle box;
+		r->textBox("M", box);
+		cellWidth = (box.lr.x > 0) ? box.lr.x : 8;
+		cellHeight = (box.lr.y > 0) ? box.lr.y : 16;
+	}
+
+	// The rows moved, or the view shows the scrollback or was resized
+	if (screen.takeScrolled() || offset || (viewRect != lastViewport))
+		fullRedraw = true;
+
+	if (fullRedraw)
+	{
+		unsigned color;
+		p->getPalette(CONSOLE_DEFAULT_BG, color);
+		r->filledRectangle(viewRect, color);
+	}
+	else
+		screen.touch(lastCursorX, lastCursorY);
+
+	for (int row = 0; row < screen.getRows(); row++)
+	{
+		int first = 0, last = screen.getColumns() - 1;
+
+		if (fullRedraw || screen.getDirtySpan(row, first, last))
+			drawRow(row, first, last, viewRect);
+	}
+
+	lastCursorX = screen.getCursorX();
+	lastCursorY = screen.getCursorY();
+	if (!offset && screen.isCursorVisible())
+	{
+		unsigned color;
+		uint16_t cell = screen.getLine(lastCursorY)[lastCursorX];
+		Rectangle cursor(viewRect.ul.x + lastCursorX * cellWidth,
+				 viewRect.ul.y + (lastCursorY + 1) * cellHeight - 2,
+				 viewRect.ul.x + (lastCursorX + 1) * cellWidth - 1,
+				 viewRect.ul.y + (lastCursorY + 1) * cellHeight - 1);
+		cursor.clip(viewRect);
+		p->getPalette((cell >> 8) & 0x0F, color);
+		r->filledRectangle(cursor, color);
+	}
+
+	screen.clearDirty();
+	fullRedraw = false;
+	lastViewport = viewRect;
+}
+
+void ConsoleView::drawRow(int row, int first, int last, const Rectangle &viewRect)
+{
+	ViewRenderBackend *r = GRenderer;
+	Palette *p = GPaletteGroup->getPalette(PaletteGroup::PAL_CONSOLE);
+	const uint16_t *line = screen.getLine(row, offset);
+	Rectangle clipping;
+	clipping = viewRect;
+	char text[128];
+
+	// A run of cells with the same attribute is drawn at once
+	for (int x = first; x <= last;)
+	{
+		uint8_t attr = line[x] >> 8;
+		bool blank = true;
+		int n = 0;
+
+		for (; (x + n <= last) && ((line[x + n] >> 8) == attr) && (n < (int)sizeof(text) - 1); n++)
+		{
+			char c = line[x + n] & 0xFF;
+			text[n] = c ? c : ' ';
+			blank = blank && (text[n] == ' ');
+		}
+		text[n] = '\0';
+
+		unsigned fcolor, bcolor;
+		Rectangle cells(viewRect.ul.x + x * cellWidth,
+				viewRect.ul.y + row * cellHeight,
+				viewRect.ul.x + (x + n) * cellWidth - 1,
+				viewRect.ul.y + (row + 1) * cellHeight - 1);
+		p->getPalette(attr & 0x0F, fcolor);
+		p->getPalette(attr >> 4, bcolor);
+
+		// Text is not clipped by the renderers, runs crossing the border are skipped
+		if (clipping.includes(cells))
+		{
+			r->filledRectangle(cells, bcolor);
+			if (!blank)
+				r->text(cells, fcolor, bcolor, text);
+		}
+		else if (clipping.intersect(cells))
+		{
+			cells.clip(clipping);
+			r->filledRectangle(cells, bcolor);
+		}
+
+		x += n;
+	}
+}
+
+void ConsoleView::handleEvent(Event *evt)
+{
+	View::handleEvent(evt);
+
+	if (evt->isEventCommand())
+	{
+		MessageEvent *msg = evt->getMessageEvent();
+		if (isCommandForMe(msg) && (msg->command == CMD_UPDATE))
+		{
+			update();
+			evt->clear();
+		}
+	}
+}
+
+void ConsoleView::releaseRenderBuffer()
+{
+	View::releaseRenderBuffer();
+
+	// The display list holds the last rows drawn only, draw all again
+	if (getChanged(VIEW_CHANGED_LOST))
+	{
+		fullRedraw = true;
+		setChanged(VIEW_CHANGED_REDRAW);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CONSOLEVIEW_H_
+#define _CONSOLEVIEW_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "view.h"
+#include "textbuffer.h"
+#include "vtparser.h"
+
+// Bytes decoded for each CMD_UPDATE, so that the event loop is never stalled
+#define CONSOLE_UPDATE_BUDGET (1 << 20)
+// Bytes queued by ConsoleView::write() before the writers are blocked
+#define CONSOLE_INPUT_LIMIT (4 << 20)
+// Minimum time between two frames while the input is being decoded
+#define CONSOLE_FRAME_MS 20
+
+/*
+ * The cells of a terminal: the screen and the lines scrolled out of it.
+ * Cells hold a Latin-1 character and an attribute, the foreground color in
+ * the low nibble and the background color in the high nibble (see
+ * console_palette.h).
+ * Screen and scrollback share a TextBuffer used as a ring of rows:
+ * scrolling the whole screen moves the index of its first row and clears
+ * the new bottom row, no cell is copied.
+ * Newlines also return the carriage, as the output of programs is not
+ * translated by a tty.
+ */
+class ConsoleScreen : public VTHandler
+{
+public:
+	ConsoleScreen(int columns, int rows, int scrollback);
+	virtual ~ConsoleScreen() {}
+
+	/*
+	 * Decode output, see VTParser::parse().
+	 */
+	inline void write(const uint8_t *data, size_t len) { parser.parse(data, len); }
+
+	/*
+	 * Get the cells of a row of the screen.
+	 *
+	 * PARAMETERS IN
+	 *  int row - the row of the screen
+	 *  int offset - view the screen offset lines up into the scrollback
+	 *
+	 * RETURN
+	 * the columns cells of the row
+	 */
+	const uint16_t *getLine(int row, int offset = 0) const;
+
+	/*
+	 * Check if a row of the screen was written since the last
+	 * clearDirty(), the columns written are returned.
+	 */
+	bool getDirtySpan(int row, int &first, int &last) const;
+
+	/*
+	 * Take the number of lines scrolled since the last call: the
+	 * rows of the screen moved and must be displayed again.
+	 */
+	unsigned takeScrolled(void);
+
+	/*
+	 * Mark a cell as written, e.g. after the cursor left it.
+	 */
+	void touch(int x, int y);
+
+	inline void clearDirty(void) { cells.clearDirty(); }
+
+	inline int getColumns(void) const { return columns; }
+	inline int getRows(void) const { return rows; }
+	inline int getHistory(void) const { return history; }
+	inline int getCursorX(void) const { return cx; }
+	inline int getCursorY(void) const { return cy; }
+	inline bool isCursorVisible(void) const { return cursorVisible; }
+
+	virtual void print(const uint8_t *text, int len) override;
+	virtual void printCode(uint32_t code) override;
+	virtual void execute(uint8_t code) override;
+	virtual void escDispatch(uint8_t final, uint8_t intermediate) override;
+	virtual void csiDispatch(uint8_t final, const int *params, int num, uint8_t prefix, uint8_t intermediate) override;
+
+private:
+	// Index in cells of a row of the screen
+	inline int physical(int row) const { return (head + row) % capacity; }
+
+	void reset(void);
+	void newLine(void);
+	void reverseIndex(void);
+	void scrollUp(int top, int bottom, int lines);
+	void scrollDown(int top, int bottom, int lines);
+	void clearRows(int top, int bottom);
+	void clearColumns(int row, int first, int last);
+	void setGraphics(const int *params, int num);
+	void setCursor(int x, int y);
+	void updateAttribute(void);
+
+	TextBuffer cells;
+	VTParser parser;
+	int columns, rows, capacity;
+	// Index in cells of the first row of the screen, rows scrolled out
+	int head, history;
+	unsigned scrolled;
+	// Cursor, the last column was written and the next character wraps
+	int cx, cy;
+	bool wrapPending, cursorVisible;
+	// Scrolling region, rows marginTop - marginBottom
+	int marginTop, marginBottom;
+	// SGR state and the resulting attribute
+	uint8_t fg, bg, attr;
+	bool bold, inverse;
+	int savedX, savedY;
+	uint8_t savedFg, savedBg;
+	bool savedBold, savedInverse;
+};
+
+/*
+ * A view showing a terminal, fed with the output of programs.
+ * write() can be called from any thread: the bytes are queued and decoded
+ * by the thread running the event loop when the CMD_UPDATE message of
+ * ViewExec::postUpdate() arrives, a bounded amount each time. The writers
+ * block while the queue is full.
+ * Only the rows changed since the last frame are drawn, unless the
+ * screen scrolled.
+ */
+class ConsoleView : public View
+{
+public:
+	ConsoleView(Rectangle &viewLimits, int columns = 80, int rows = 25, int scrollback = 1000);
+	virtual ~ConsoleView();
+
+	/*
+	 * Queue output to be shown.
+	 * It MUST NOT be called by the thread running the event loop while the
+	 * queue is full. The writers blocked when the view is destroyed are
+	 * woken and fail, no more calls are allowed after that.
+	 *
+	 * PARAMETERS IN
+	 *  const char *data - the bytes, UTF-8 text and VT100 sequences
+	 *  size_t len - the number of bytes
+	 *
+	 * RETURN
+	 * false if the view is being destroyed, nothing was queued
+	 */
+	bool write(const char *data, size_t len);
+
+	/*
+	 * Show the screen offset lines up into the scrollback, 0 shows the
+	 * last lines written.
+	 */
+	void setScrollback(int offset);
+
+	inline ConsoleScreen &getScreen(void) { return screen; }
+
+	virtual void drawView(void) override;
+	virtual void handleEvent(Event *evt) override;
+	virtual void releaseRenderBuffer(void) override;
+
+private:
+	void update(void);
+	void drawRow(int row, int first, int last, const Rectangle &viewRect);
+
+	ConsoleScreen screen;
+	int offset;
+	// The whole view is drawn at the next frame
+	bool fullRedraw;
+	Rectangle lastViewport;
+	int lastCursorX, lastCursorY;
+	int cellWidth, cellHeight;
+
+	// Bytes written by other threads and not taken yet
+	std::mutex inputLock;
+	std::condition_variable inputDrained;
+	std::vector<uint8_t> input;
+	bool updatePosted;
+	// The view is being destroyed, the writers inside write()
+	bool closing;
+	int writers;
+	// Bytes taken by the event loop, decoded from pendingPos on
+	std::vector<uint8_t> pending;
+	size_t pendingPos;
+	std::chrono::steady_clock::time_point lastFrame;
+};
+
+#endif
\ No newline at end of file
@@ -28,7 +28,7 @@ Desktop::Desktop(Rectangle &rect) : View(rect)
 void Desktop::drawView()
 {
 	Rectangle viewRect;
-	ViewRender *r = GRenderer;
+	ViewRenderBackend *r = GRenderer;
 	Palette *p = GPaletteGroup->getPalette(PaletteGroup::PAL_DESKTOP);
 	unsigned color;
 	getViewport(viewRect);
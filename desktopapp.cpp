@@ -32,16 +32,21 @@
 static const int SCREEN_WIDTH = 1280;
 static const int SCREEN_HEIGHT = 720;
 
-DesktopApp::DesktopApp()
+DesktopApp::DesktopApp(const char *capture, bool commandList)
 {
 	SDL_Init(0);
 
 	Rectangle master(0, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1);
 	ViewRenderInstance::instance()->configure(VRENDER_HW, SCREEN_WIDTH, SCREEN_HEIGHT, 32);
+	ViewRenderInstance::instance()->setCommandList(commandList);
+	if (capture)
+		ViewRenderInstance::instance()->setCapture(capture);
 	ViewZBuffer::instance()->configure(master);
 	he = ViewEventFactory::create(EST_SDL);
-	SystemPaletteInstance::instance()->configure(SYS_PALETTE_DIEGOS, 32);
-	PaletteGroupInstance::instance()->configure(SYS_PALETTE_DIEGOS, 32);
+	// The palettes provide colors as the renderer draws them
+	int depth = ViewRenderInstance::instance()->get()->getBitDepth();
+	SystemPaletteInstance::instance()->configure(SYS_PALETTE_DIEGOS, depth);
+	PaletteGroupInstance::instance()->configure(SYS_PALETTE_DIEGOS, depth);
 
 	app = new ViewApplication(master, he);
 	app->initDesktop();
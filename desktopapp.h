@@ -27,7 +27,14 @@
 class DesktopApp
 {
 public:
-	explicit DesktopApp();
+	/*
+	 * PARAMETERS IN
+	 * const char *capture - if not NULL, the rendering is written to this
+	 *                       capture file, see ViewRenderCapture
+	 * bool commandList - record the frames and send them grouped by
+	 *                    destination buffer, see ViewRenderRecorder
+	 */
+	explicit DesktopApp(const char *capture = nullptr, bool commandList = false);
 	virtual ~DesktopApp();
 
 	void run();
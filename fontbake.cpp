@@ -0,0 +1,225 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Font cache tool.
+ * The glyphs of Latin-1 and U+FFFD are rasterized for each (font, point
+ * size) pair and written to a font cache, see fontcache.h. Renderers
+ * finding their font in FONTCACHE_FILE draw the text with it, without
+ * opening the font engine.
+ * The cache MUST be made again when a font changes; stale entries are
+ * detected and ignored.
+ *
+ * fontbake <cache> <font> <size> [<font> <size> ...]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <SDL2/SDL.h>
+#include "fontcache.h"
+#include "SDL_ttf.h"
+
+#define FIRST_DIRECT 0x20
+#define LAST_DIRECT 0x7E
+#define REPLACEMENT_CHAR 0xFFFD
+
+struct BakedFont
+{
+	FontCacheEntry entry;
+	std::vector<BitmapGlyph> glyphs;
+	std::vector<uint8_t> bits;
+};
+
+/*
+ * Rasterize a glyph: the coverage of the shaded rendering, with the empty
+ * rows and columns trimmed.
+ */
+static bool bakeGlyph(TTF_Font *font, uint16_t code, BakedFont &baked)
+{
+	SDL_Color white = {0xFF, 0xFF, 0xFF, 0xFF};
+	SDL_Color black = {0, 0, 0, 0xFF};
+	int minx, maxx, miny, maxy, advance;
+	BitmapGlyph g;
+
+	if (TTF_GlyphMetrics(font, code, &minx, &maxx, &miny, &maxy, &advance))
+		return false;
+
+	memset(&g, 0, sizeof(g));
+	g.code = code;
+	g.offset = (uint32_t)baked.bits.size();
+	g.advance = (uint8_t)std::min(std::max(advance, 0), 255);
+
+	// 8 bits per pixel, the palette goes from black to white: the pixels are the coverage
+	SDL_Surface *surface = TTF_RenderGlyph_Shaded(font, code, white, black);
+	if (!surface)
+		return false;
+
+	const uint8_t *pixels = static_cast<const uint8_t *>(surface->pixels);
+	int x0 = surface->w, y0 = surface->h, x1 = -1, y1 = -1;
+	for (int y = 0; y < surface->h; y++)
+		for (int x = 0; x < surface->w; x++)
+			if (pixels[y * surface->pitch + x])
+			{
+				x0 = std::min(x0, x);
+				x1 = std::max(x1, x);
+				y0 = std::min(y0, y);
+				y1 = std::max(y1, y);
+			}
+
+	if (x1 >= 0)
+	{
+		if ((x1 - x0 >= 255) || (y1 - y0 >= 255) || (x0 > 127) || (TTF_FontAscent(font) - y0 > 127))
+		{
+			SDL_FreeSurface(surface);
+			return false;
+		}
+
+		// The surface starts at the pen, its row TTF_FontAscent() is the baseline
+		g.width = x1 - x0 + 1;
+		g.height = y1 - y0 + 1;
+		g.left = x0;
+		g.top = TTF_FontAscent(font) - y0;
+		for (int y = y0; y <= y1; y++)
+			baked.bits.insert(baked.bits.end(), pixels + y * surface->pitch + x0, pixels + y * surface->pitch + x1 + 1);
+	}
+
+	SDL_FreeSurface(surface);
+	baked.glyphs.push_back(g);
+	return true;
+}
+
+static bool bakeFont(const char *path, int pointSize, BakedFont &baked)
+{
+	if (strlen(path) >= FONTCACHE_PATH_LEN)
+	{
+		std::cout << path << ": the path is too long" << std::endl;
+		return false;
+	}
+
+	TTF_Font *font = TTF_OpenFont(path, pointSize);
+	if (!font)
+	{
+		std::cout << path << " could not be loaded! SDL_Error: " << TTF_GetError() << std::endl;
+		return false;
+	}
+
+	memset(&baked.entry, 0, sizeof(baked.entry));
+	strcpy(baked.entry.path, path);
+	baked.entry.pointSize = pointSize;
+	baked.entry.firstCode = FIRST_DIRECT;
+	baked.entry.numDirect = LAST_DIRECT - FIRST_DIRECT + 1;
+	baked.entry.height = (uint8_t)std::min(TTF_FontHeight(font), 255);
+	baked.entry.ascent = (uint8_t)std::min(TTF_FontAscent(font), 255);
+	FontCache::getSourceStamp(path, baked.entry.sourceSize, baked.entry.sourceTime);
+
+	bool ok = true;
+	for (uint16_t code = FIRST_DIRECT; ok && (code <= LAST_DIRECT); code++)
+		ok = bakeGlyph(font, code, baked);
+	for (uint16_t code = 0xA0; ok && (code <= 0xFF); code++)
+		if (TTF_GlyphIsProvided(font, code))
+			ok = bakeGlyph(font, code, baked);
+
+	// Characters not available are drawn as U+FFFD, or '?' if the font has not it
+	baked.entry.defaultGlyph = '?' - FIRST_DIRECT;
+	if (ok && TTF_GlyphIsProvided(font, REPLACEMENT_CHAR) && bakeGlyph(font, REPLACEMENT_CHAR, baked))
+		baked.entry.defaultGlyph = (uint16_t)(baked.glyphs.size() - 1);
+
+	TTF_CloseFont(font);
+
+	if (!ok)
+	{
+		std::cout << path << ": the glyphs could not be rasterized" << std::endl;
+		return false;
+	}
+
+	baked.entry.numGlyphs = (uint16_t)baked.glyphs.size();
+	baked.entry.bitsSize = (uint32_t)baked.bits.size();
+	std::cout << path << " " << pointSize << ": " << baked.glyphs.size() << " glyphs, "
+		  << baked.bits.size() << " bytes" << std::endl;
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	if ((argc < 4) || (argc & 1))
+	{
+		std::cout << "usage: " << argv[0] << " <cache> <font> <size> [<font> <size> ...]" << std::endl;
+		return 1;
+	}
+
+	if (TTF_Init())
+	{
+		std::cout << "Font could not be inited! SDL_Error: " << TTF_GetError() << std::endl;
+		return 1;
+	}
+
+	int numFonts = (argc - 2) / 2;
+	std::vector<BakedFont> fonts(numFonts);
+	for (int i = 0; i < numFonts; i++)
+		if (!bakeFont(argv[2 + i * 2], atoi(argv[3 + i * 2]), fonts[i]))
+			return 1;
+
+	TTF_Quit();
+
+	// Lay out the tables after the entries, the glyphs aligned to 8 bytes
+	uint32_t offset = sizeof(FontCacheHeader) + numFonts * sizeof(FontCacheEntry);
+	for (BakedFont &f : fonts)
+	{
+		offset = (offset + 7) & ~7u;
+		f.entry.glyphsOffset = offset;
+		offset += f.glyphs.size() * sizeof(BitmapGlyph);
+		f.entry.bitsOffset = offset;
+		offset += f.entry.bitsSize;
+	}
+
+	FILE *file = fopen(argv[1], "wb");
+	if (!file)
+	{
+		std::cout << "Cache file " << argv[1] << " could not be created!" << std::endl;
+		return 1;
+	}
+
+	FontCacheHeader header;
+	memcpy(header.magic, FONTCACHE_MAGIC, 4);
+	header.version = FONTCACHE_VERSION;
+	header.byteOrder = FONTCACHE_BYTE_ORDER;
+	header.numFonts = numFonts;
+	fwrite(&header, sizeof(header), 1, file);
+	for (BakedFont &f : fonts)
+		fwrite(&f.entry, sizeof(f.entry), 1, file);
+	for (BakedFont &f : fonts)
+	{
+		static const uint8_t padding[8] = {0};
+		fwrite(padding, 1, f.entry.glyphsOffset - ftell(file), file);
+		fwrite(f.glyphs.data(), sizeof(BitmapGlyph), f.glyphs.size(), file);
+		fwrite(f.bits.data(), 1, f.bits.size(), file);
+	}
+
+	bool ok = !ferror(file);
+	if (fclose(file) || !ok)
+	{
+		std::cout << "Cache file " << argv[1] << " could not be written!" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
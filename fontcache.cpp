@@ -0,0 +1,128 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <sys/stat.h>
+#include "fontcache.h"
+
+// The tables are used in place, their layout is part of the file format
+static_assert(sizeof(FontCacheHeader) == 16, "FontCacheHeader layout");
+static_assert(sizeof(FontCacheEntry) == 304, "FontCacheEntry layout");
+static_assert(sizeof(BitmapGlyph) == 16, "BitmapGlyph layout");
+
+FontCache::FontCache() : header(nullptr), entries(nullptr)
+{
+}
+
+bool FontCache::open(const char *path)
+{
+	close();
+
+	if (!file.open(path))
+		return false;
+
+	const FontCacheHeader *h = reinterpret_cast<const FontCacheHeader *>(file.getData());
+	if ((file.getSize() < sizeof(FontCacheHeader)) || memcmp(h->magic, FONTCACHE_MAGIC, 4) ||
+	    (h->version != FONTCACHE_VERSION) || (h->byteOrder != FONTCACHE_BYTE_ORDER) ||
+	    ((file.getSize() - sizeof(FontCacheHeader)) / sizeof(FontCacheEntry) < h->numFonts))
+	{
+		file.close();
+		return false;
+	}
+
+	header = h;
+	entries = reinterpret_cast<const FontCacheEntry *>(h + 1);
+	return true;
+}
+
+void FontCache::close(void)
+{
+	file.close();
+	header = nullptr;
+	entries = nullptr;
+}
+
+bool FontCache::checkEntry(const FontCacheEntry &entry) const
+{
+	size_t size = file.getSize();
+
+	if ((entry.glyphsOffset % alignof(BitmapGlyph)) || (entry.glyphsOffset > size) ||
+	    ((size - entry.glyphsOffset) / sizeof(BitmapGlyph) < entry.numGlyphs) ||
+	    (entry.bitsOffset > size) || (size - entry.bitsOffset < entry.bitsSize))
+		return false;
+
+	if (!entry.numGlyphs || (entry.numDirect > entry.numGlyphs) || (entry.defaultGlyph >= entry.numGlyphs))
+		return false;
+
+	// A corrupted glyph must not read out of the file
+	const BitmapGlyph *glyphs = reinterpret_cast<const BitmapGlyph *>(file.getData() + entry.glyphsOffset);
+	for (unsigned i = 0; i < entry.numGlyphs; i++)
+	{
+		if ((glyphs[i].offset > entry.bitsSize) ||
+		    (entry.bitsSize - glyphs[i].offset < (uint32_t)glyphs[i].width * glyphs[i].height))
+			return false;
+	}
+
+	return true;
+}
+
+bool FontCache::find(const char *fontPath, int pointSize, BitmapFont &out) const
+{
+	uint64_t sourceSize;
+	int64_t sourceTime;
+
+	if (!header || !getSourceStamp(fontPath, sourceSize, sourceTime))
+		return false;
+
+	for (unsigned i = 0; i < header->numFonts; i++)
+	{
+		const FontCacheEntry &e = entries[i];
+
+		if ((e.pointSize != (uint32_t)pointSize) || strncmp(e.path, fontPath, FONTCACHE_PATH_LEN))
+			continue;
+
+		if ((e.sourceSize != sourceSize) || (e.sourceTime != sourceTime) || !checkEntry(e))
+			return false;
+
+		out.bitsPerPixel = BITMAP_FONT_ALPHA;
+		out.height = e.height;
+		out.ascent = e.ascent;
+		out.numGlyphs = e.numGlyphs;
+		out.numDirect = e.numDirect;
+		out.firstCode = e.firstCode;
+		out.defaultGlyph = e.defaultGlyph;
+		out.glyphs = reinterpret_cast<const BitmapGlyph *>(file.getData() + e.glyphsOffset);
+		out.bits = file.getData() + e.bitsOffset;
+		return true;
+	}
+
+	return false;
+}
+
+bool FontCache::getSourceStamp(const char *fontPath, uint64_t &size, int64_t &time)
+{
+	struct stat st;
+
+	if (stat(fontPath, &st))
+		return false;
+
+	size = (uint64_t)st.st_size;
+	time = (int64_t)st.st_mtime;
+	return true;
+}
\ No newline at end of file
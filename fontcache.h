@@ -0,0 +1,127 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FONTCACHE_H_
+#define _FONTCACHE_H_
+
+#include <cstdint>
+#include "bitmapfont.h"
+#include "mappedfile.h"
+
+/*
+ * Font cache file layout.
+ * The glyphs of TTF fonts are rasterized in advance by the fontbake tool,
+ * for each (font, point size) pair, so that the text can be drawn at start
+ * up without running the font engine.
+ * The file starts with a FontCacheHeader, followed by a FontCacheEntry
+ * for each font; the tables of the fonts follow, the glyphs as an array
+ * of BitmapGlyph aligned to 8 bytes and the bitmaps, 8 bit coverage.
+ * Offsets are counted from the start of the file.
+ * Everything is in the byte order and layout of the machine running the
+ * tool; the cache is mapped in memory and used in place, a file with a
+ * different version or byte order is ignored.
+ */
+#define FONTCACHE_MAGIC "DGFC"
+#define FONTCACHE_VERSION 1
+#define FONTCACHE_BYTE_ORDER 0x01020304
+#define FONTCACHE_PATH_LEN 256
+
+// The cache looked up by the renderers, in the working directory
+#define FONTCACHE_FILE "fonts.cache"
+
+struct FontCacheHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t byteOrder;
+	uint32_t numFonts;
+};
+
+struct FontCacheEntry
+{
+	// The font file as passed to TTF_OpenFont(), and its point size
+	char path[FONTCACHE_PATH_LEN];
+	// Size and modification time of the font file: if they changed the
+	// glyphs are stale
+	uint64_t sourceSize;
+	int64_t sourceTime;
+	uint32_t pointSize;
+	// The fields of BitmapFont, see bitmapfont.h
+	uint32_t firstCode;
+	uint32_t glyphsOffset, bitsOffset, bitsSize;
+	uint16_t numGlyphs, numDirect, defaultGlyph;
+	uint8_t height, ascent;
+	uint8_t reserved[4];
+};
+
+/*
+ * A font cache mapped in memory.
+ * The fonts found in it point into the mapping, they are valid until the
+ * cache is closed.
+ */
+class FontCache
+{
+public:
+	FontCache();
+
+	/*
+	 * Map a cache file and check its header.
+	 *
+	 * PARAMETERS IN
+	 *  const char *path - the cache file
+	 *
+	 * RETURN
+	 * true if the file is a font cache of this version
+	 */
+	bool open(const char *path);
+
+	void close(void);
+
+	/*
+	 * Get the glyphs of a font.
+	 * The tables of the font are checked against the size of the file,
+	 * and the font file against the size and time recorded by the tool.
+	 *
+	 * PARAMETERS IN
+	 *  const char *fontPath - the font file
+	 *  int pointSize - the point size
+	 *
+	 * PARAMETERS OUT
+	 *  BitmapFont &out - the font, 8 bits per pixel
+	 *
+	 * RETURN
+	 * true if the font is in the cache and up to date
+	 */
+	bool find(const char *fontPath, int pointSize, BitmapFont &out) const;
+
+	/*
+	 * Get the size and modification time of a font file, recorded in the
+	 * cache to detect stale entries.
+	 */
+	static bool getSourceStamp(const char *fontPath, uint64_t &size, int64_t &time);
+
+private:
+	bool checkEntry(const FontCacheEntry &entry) const;
+
+	MappedFile file;
+	const FontCacheHeader *header;
+	const FontCacheEntry *entries;
+};
+
+#endif
\ No newline at end of file
@@ -37,7 +37,7 @@ void Frame::drawView()
 	Rectangle viewRect;
 	getViewport(viewRect);
 	unsigned color[2];
-	ViewRender *r = GRenderer;
+	ViewRenderBackend *r = GRenderer;
 	Palette *p = GPaletteGroup->getPalette(PaletteGroup::PAL_FRAME);
 
 	if (style == FRAME_FLAT)
@@ -127,19 +127,30 @@ bool Frame::isEventPositionInRange(Event *evt)
 void Frame::computeExposure()
 {
 	Rectangle ext;
-	bool areaSet = true;
 
 	getExtent(ext);
 
+	{
+		/*
+		 * Nothing changed around the frame, keep the cached state
+		 */
+		Rectangle whole(ext);
+		globalize(whole);
+		if (!GZBuffer->intersectsClipping(whole))
+			return;
+	}
+
+	clipVisibleRegion();
+
 	{
 		Rectangle temp(0, 0, ext.width(), width);
 		globalize(temp);
 
-		areaSet = areaSet && GZBuffer->isAreaSet(temp);
+		addVisibleArea(temp);
 		GZBuffer->set(temp);
 
 		temp.move(0, ext.height() - width);
-		areaSet = areaSet && GZBuffer->isAreaSet(temp);
+		addVisibleArea(temp);
 		GZBuffer->set(temp);
 	}
 
@@ -147,13 +158,13 @@ void Frame::computeExposure()
 		Rectangle temp(0, width, width, ext.height() - width);
 		globalize(temp);
 
-		areaSet = areaSet && GZBuffer->isAreaSet(temp);
+		addVisibleArea(temp);
 		GZBuffer->set(temp);
 
 		temp.move(ext.width() - width, 0);
-		areaSet = areaSet && GZBuffer->isAreaSet(temp);
+		addVisibleArea(temp);
 		GZBuffer->set(temp);
 	}
 
-	setExposed(!areaSet);
+	setExposed(hasVisibleArea());
 }
\ No newline at end of file
@@ -273,4 +273,96 @@ void Rectangle::print()
 	std::cout << "LR ";
 	lr.print();
 	std::cout << "W " << width() << " H " << height() << std::endl;
+}
+
+Region::Region() : rects(nullptr), count(0), capacity(0)
+{
+}
+
+Region::~Region()
+{
+	delete[] rects;
+	rects = nullptr;
+	count = capacity = 0;
+}
+
+void Region::add(Rectangle &rect)
+{
+	if (count == capacity)
+	{
+		unsigned newCapacity = (capacity) ? (capacity * 2) : 4;
+		Rectangle *newRects = new Rectangle[newCapacity];
+
+		for (unsigned i = 0; i < count; i++)
+			newRects[i] = rects[i];
+
+		delete[] rects;
+		rects = newRects;
+		capacity = newCapacity;
+	}
+
+	rects[count++] = rect;
+}
+
+void Region::remove(unsigned index)
+{
+	if (index < count)
+		rects[index] = rects[--count];
+}
+
+void Region::subtract(Rectangle &rect)
+{
+	unsigned i = 0;
+	unsigned last = count;
+
+	/*
+	 * Rectangles appended by the split are outside rect,
+	 * only the original ones need to be checked.
+	 */
+	while (i < last)
+	{
+		if (!rects[i].intersect(rect))
+		{
+			i++;
+			continue;
+		}
+
+		Rectangle cut;
+		cut = rects[i];
+
+		/*
+		 * Remove the intersecting rectangle, replacing it with the last one
+		 */
+		rects[i] = rects[--count];
+		if (count >= last)
+			i++;
+		else
+			last--;
+
+		/*
+		 * Up to four parts: above, below, left and right of rect
+		 */
+		if (cut.ul.y < rect.ul.y)
+		{
+			Rectangle part(cut.ul.x, cut.ul.y, cut.lr.x, rect.ul.y - 1);
+			add(part);
+			cut.ul.y = rect.ul.y;
+		}
+		if (cut.lr.y > rect.lr.y)
+		{
+			Rectangle part(cut.ul.x, rect.lr.y + 1, cut.lr.x, cut.lr.y);
+			add(part);
+			cut.lr.y = rect.lr.y;
+		}
+		if (cut.ul.x < rect.ul.x)
+		{
+			Rectangle part(cut.ul.x, cut.ul.y, rect.ul.x - 1, cut.lr.y);
+			add(part);
+		}
+		if (cut.lr.x > rect.lr.x)
+		{
+			Rectangle part(rect.lr.x + 1, cut.ul.y, cut.lr.x, cut.lr.y);
+			add(part);
+		}
+	}
 }
\ No newline at end of file
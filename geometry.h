@@ -292,4 +292,61 @@ public:
 	Point lr;
 };
 
+/*
+ * A region is a set of non overlapping rectangles, describing
+ * an area which is not necessarily rectangular (e.g. the visible
+ * part of a view partially covered by other views).
+ */
+class Region
+{
+public:
+	Region();
+	~Region();
+
+	/*
+	 * Add a rectangle to the region.
+	 * The rectangle MUST NOT overlap the rectangles already stored.
+	 *
+	 * PARAMETERS IN
+	 * Rectangle &rect - the rectangle to be added
+	 */
+	void add(Rectangle &rect);
+
+	/*
+	 * Remove an area from the region, rectangles intersecting
+	 * the area are split into the parts falling outside it.
+	 *
+	 * PARAMETERS IN
+	 * Rectangle &rect - the area to be removed
+	 */
+	void subtract(Rectangle &rect);
+
+	/*
+	 * Remove the rectangle stored at index, the last rectangle
+	 * takes its place.
+	 *
+	 * PARAMETERS IN
+	 * unsigned index - the index of the rectangle
+	 */
+	void remove(unsigned index);
+
+	/*
+	 * Remove all rectangles from the region.
+	 */
+	inline void clear(void) { count = 0; }
+
+	inline bool isEmpty(void) const { return (count == 0); }
+
+	inline unsigned size(void) const { return count; }
+
+	inline Rectangle &operator[](unsigned index) { return rects[index]; }
+
+private:
+	Region(const Region &other) = delete;
+	Region &operator=(const Region &other) = delete;
+
+	Rectangle *rects;
+	unsigned count, capacity;
+};
+
 #endif
\ No newline at end of file
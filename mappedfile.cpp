@@ -0,0 +1,120 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mappedfile.h"
+
+MappedFile::MappedFile() : data(nullptr), size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const char *path)
+{
+	LARGE_INTEGER fileSize;
+
+	close();
+
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart == 0))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	// The view keeps the mapping alive, the handles are not needed anymore
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (!mapping)
+		return false;
+
+	data = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	CloseHandle(mapping);
+	if (!data)
+		return false;
+
+	size = (size_t)fileSize.QuadPart;
+	return true;
+}
+
+void MappedFile::close(void)
+{
+	if (data)
+		UnmapViewOfFile(data);
+
+	data = nullptr;
+	size = 0;
+}
+
+#else
+
+bool MappedFile::open(const char *path)
+{
+	struct stat st;
+
+	close();
+
+	int fd = ::open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	if (fstat(fd, &st) || (st.st_size == 0))
+	{
+		::close(fd);
+		return false;
+	}
+
+	// The mapping holds a reference to the file, the descriptor is not needed anymore
+	void *mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED)
+		return false;
+
+	data = static_cast<const uint8_t *>(mapped);
+	size = (size_t)st.st_size;
+	return true;
+}
+
+void MappedFile::close(void)
+{
+	if (data)
+		munmap(const_cast<uint8_t *>(data), size);
+
+	data = nullptr;
+	size = 0;
+}
+
+#endif
\ No newline at end of file
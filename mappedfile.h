@@ -0,0 +1,66 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MAPPEDFILE_H_
+#define _MAPPEDFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * A file mapped read only in memory: its pages are loaded by the os when
+ * they are touched, and are shared with the page cache, nothing is copied.
+ * The mapping starts at a page boundary.
+ */
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	/*
+	 * Map a file, a file already mapped is unmapped first.
+	 *
+	 * PARAMETERS IN
+	 *  const char *path - the file
+	 *
+	 * RETURN
+	 * true if the file is mapped, false if it cannot be opened or is empty
+	 */
+	bool open(const char *path);
+
+	/*
+	 * Unmap the file, the pointers to its data are no more valid.
+	 */
+	void close(void);
+
+	inline bool isOpen(void) const { return data != nullptr; }
+	inline const uint8_t *getData(void) const { return data; }
+	inline size_t getSize(void) const { return size; }
+
+private:
+	// No copies, the mapping has a single owner
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	const uint8_t *data;
+	size_t size;
+};
+
+#endif
\ No newline at end of file
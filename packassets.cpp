@@ -0,0 +1,169 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Asset pack tool.
+ * Bitmaps are converted to a pixel format and written to an asset pack,
+ * see assetpack.h. Renderers finding a bitmap in ASSETPACK_FILE upload it
+ * from the pack instead of loading the file; the bitmaps are named as
+ * given on the command line, they MUST be loaded with the same names.
+ * The pixel format should be the texture format of the renderer, marked
+ * in the list of formats printed by ViewRenderHW at start up.
+ *
+ * packassets <pack> <argb8888|rgb888|rgb565> <bitmap> [<bitmap> ...]
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <SDL2/SDL.h>
+#include "assetpack.h"
+
+struct PackedAsset
+{
+	AssetPackEntry entry;
+	std::vector<uint8_t> pixels;
+};
+
+static bool selectFormat(const char *name, Uint32 &format)
+{
+	if (!strcmp(name, "argb8888"))
+		format = SDL_PIXELFORMAT_ARGB8888;
+	else if (!strcmp(name, "rgb888"))
+		format = SDL_PIXELFORMAT_RGB888;
+	else if (!strcmp(name, "rgb565"))
+		format = SDL_PIXELFORMAT_RGB565;
+	else
+		return false;
+
+	return true;
+}
+
+static bool packBitmap(const char *name, Uint32 format, PackedAsset &asset)
+{
+	if (strlen(name) >= ASSETPACK_NAME_LEN)
+	{
+		std::cout << name << ": the name is too long" << std::endl;
+		return false;
+	}
+
+	SDL_Surface *loaded = SDL_LoadBMP(name);
+	if (!loaded)
+	{
+		std::cout << name << " could not be loaded! SDL_Error: " << SDL_GetError() << std::endl;
+		return false;
+	}
+
+	SDL_Surface *surf = SDL_ConvertSurfaceFormat(loaded, format, 0);
+	SDL_FreeSurface(loaded);
+	if (!surf)
+	{
+		std::cout << name << " could not be converted! SDL_Error: " << SDL_GetError() << std::endl;
+		return false;
+	}
+
+	memset(&asset.entry, 0, sizeof(asset.entry));
+	strcpy(asset.entry.name, name);
+	asset.entry.width = surf->w;
+	asset.entry.height = surf->h;
+	// Rows are 4 bytes aligned, as in SDL surfaces
+	asset.entry.pitch = (surf->w * SDL_BYTESPERPIXEL(format) + 3) & ~3u;
+
+	asset.pixels.resize(asset.entry.pitch * asset.entry.height);
+	for (int y = 0; y < surf->h; y++)
+		memcpy(&asset.pixels[y * asset.entry.pitch], static_cast<uint8_t *>(surf->pixels) + y * surf->pitch,
+		       surf->w * SDL_BYTESPERPIXEL(format));
+
+	SDL_FreeSurface(surf);
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	Uint32 format;
+
+	if ((argc < 4) || !selectFormat(argv[2], format))
+	{
+		std::cout << "usage: " << argv[0] << " <pack> <argb8888|rgb888|rgb565> <bitmap> [<bitmap> ...]" << std::endl;
+		return 1;
+	}
+
+	SDL_Init(0);
+
+	int numAssets = argc - 3;
+	std::vector<PackedAsset> assets(numAssets);
+	for (int i = 0; i < numAssets; i++)
+		if (!packBitmap(argv[3 + i], format, assets[i]))
+			return 1;
+
+	// The index is searched by name
+	std::sort(assets.begin(), assets.end(), [](const PackedAsset &a, const PackedAsset &b)
+		  { return strcmp(a.entry.name, b.entry.name) < 0; });
+	for (int i = 1; i < numAssets; i++)
+		if (!strcmp(assets[i - 1].entry.name, assets[i].entry.name))
+		{
+			std::cout << assets[i].entry.name << " is given twice" << std::endl;
+			return 1;
+		}
+
+	uint32_t offset = sizeof(AssetPackHeader) + numAssets * sizeof(AssetPackEntry);
+	for (PackedAsset &a : assets)
+	{
+		offset = (offset + ASSETPACK_ALIGN - 1) & ~(uint32_t)(ASSETPACK_ALIGN - 1);
+		a.entry.offset = offset;
+		offset += a.pixels.size();
+	}
+
+	FILE *file = fopen(argv[1], "wb");
+	if (!file)
+	{
+		std::cout << "Pack file " << argv[1] << " could not be created!" << std::endl;
+		return 1;
+	}
+
+	AssetPackHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, ASSETPACK_MAGIC, 4);
+	header.version = ASSETPACK_VERSION;
+	header.byteOrder = ASSETPACK_BYTE_ORDER;
+	header.pixelFormat = format;
+	header.numAssets = numAssets;
+	fwrite(&header, sizeof(header), 1, file);
+	for (PackedAsset &a : assets)
+		fwrite(&a.entry, sizeof(a.entry), 1, file);
+	for (PackedAsset &a : assets)
+	{
+		static const uint8_t padding[ASSETPACK_ALIGN] = {0};
+		fwrite(padding, 1, a.entry.offset - ftell(file), file);
+		fwrite(a.pixels.data(), 1, a.pixels.size(), file);
+	}
+
+	bool ok = !ferror(file);
+	if (fclose(file) || !ok)
+	{
+		std::cout << "Pack file " << argv[1] << " could not be written!" << std::endl;
+		return 1;
+	}
+
+	std::cout << numAssets << " bitmaps, " << offset << " bytes" << std::endl;
+	SDL_Quit();
+	return 0;
+}
\ No newline at end of file
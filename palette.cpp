@@ -18,6 +18,7 @@
  */
 
 #include <cstring>
+#include <iostream>
 
 #include "palette.h"
 
@@ -73,4 +74,60 @@ bool PaletteTrueColor::storePalette(void *data)
 
 	memcpy(data, palette, colorsNum * sizeof(uint32_t));
 	return true;
+}
+
+uint32_t PaletteIndexed::lut[PALETTE_LUT_SIZE];
+unsigned PaletteIndexed::lutVersion = 0;
+
+PaletteIndexed::PaletteIndexed(unsigned num, unsigned base) : Palette(num), base(base)
+{
+	if (base + num > PALETTE_LUT_SIZE)
+	{
+		std::cout << __FUNCSIG__ << " slots " << base << "-" << base + num - 1 << " out of the lookup table" << std::endl;
+		colorsNum = (base < PALETTE_LUT_SIZE) ? PALETTE_LUT_SIZE - base : 0;
+	}
+}
+
+bool PaletteIndexed::setPalette(unsigned index, unsigned color)
+{
+	if (index < colorsNum)
+	{
+		// ARGB
+		lut[base + index] = color & 0x00FFFFFF;
+		lutVersion++;
+		return true;
+	}
+	return false;
+}
+
+bool PaletteIndexed::getPalette(unsigned index, unsigned &color)
+{
+	if (index < colorsNum)
+	{
+		color = base + index;
+		return true;
+	}
+	return false;
+}
+
+bool PaletteIndexed::loadPalette(const void *data)
+{
+	if (!data)
+		return false;
+
+	const uint32_t *colors = static_cast<const uint32_t *>(data);
+	// ARGB
+	for (unsigned i = 0; i < colorsNum; i++)
+		lut[base + i] = colors[i] & 0x00FFFFFF;
+	lutVersion++;
+	return true;
+}
+
+bool PaletteIndexed::storePalette(void *data)
+{
+	if (!data)
+		return false;
+
+	memcpy(data, lut + base, colorsNum * sizeof(uint32_t));
+	return true;
 }
\ No newline at end of file
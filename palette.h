@@ -55,4 +55,47 @@ private:
 	uint32_t *palette;
 };
 
+#define PALETTE_LUT_SIZE 256
+
+/*
+ * The entries of an indexed palette are slots of a lookup table shared by
+ * all the indexed palettes: getPalette() returns the slot, not the color.
+ * Views draw slots into their buffers and the renderer converts them to
+ * colors when composing the screen (see viewrenderlut.h), so changing the
+ * colors of the table does not require to draw the views again.
+ */
+class PaletteIndexed : public Palette
+{
+public:
+	/*
+	 * PARAMETERS IN
+	 * unsigned num - number of colors
+	 * unsigned base - first slot of the lookup table used by this palette
+	 */
+	PaletteIndexed(unsigned num, unsigned base);
+	virtual ~PaletteIndexed() {}
+
+	virtual bool setPalette(unsigned index, unsigned color) override;
+	virtual bool getPalette(unsigned index, unsigned &color) override;
+	virtual bool loadPalette(const void *data) override;
+	virtual bool storePalette(void *data) override;
+
+	/*
+	 * Retrieve the lookup table, PALETTE_LUT_SIZE 0x00RRGGBB colors.
+	 */
+	static inline const uint32_t *getLUT(void) { return lut; }
+
+	/*
+	 * Retrieve the version of the lookup table, it changes every time
+	 * a color of the table is changed.
+	 */
+	static inline unsigned getLUTVersion(void) { return lutVersion; }
+
+private:
+	unsigned base;
+
+	static uint32_t lut[PALETTE_LUT_SIZE];
+	static unsigned lutVersion;
+};
+
 #endif
\ No newline at end of file
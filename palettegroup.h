@@ -39,6 +39,7 @@ public:
 		PAL_DESKTOP,
 		PAL_WINICON,
 		PAL_SCROLLBAR,
+		PAL_CONSOLE,
 		PAL_NUM
 	};
 
@@ -29,6 +29,7 @@
 #include "window_palette.h"
 #include "window_icon_palette.h"
 #include "scrollbar_palette.h"
+#include "console_palette.h"
 
 #define BLACK 0x000000
 #define MAROON 0x800000
@@ -215,27 +216,35 @@ static const unsigned winiconPaletteDIEGOS[] = {C(12), C(14), C(13), C(3), C(15)
 // Bright, Dark, Foreground, Background, disabled
 static const unsigned scrollbarPaletteDIEGOS[] = {C(12), C(14), C(13), C(15), C(14)};
 
-class PaletteGroup *PaletteGroupFactory::create(enum SystemColorPalette sel, int bitdepth)
-{
-	/*
-	 * Right now supports only 32 bit depth
-	 */
-	if (bitdepth != 32)
-		return nullptr;
+// Console colors, the same for all the themes: programs pick them by name
+/*
+ * 0 - black    8 - dark grey
+ * 1 - red      9 - bright red
+ * 2 - green   10 - bright green
+ * 3 - brown   11 - yellow
+ * 4 - blue    12 - bright blue
+ * 5 - magenta 13 - bright magenta
+ * 6 - cyan    14 - bright cyan
+ * 7 - grey    15 - white
+ */
+static const unsigned consolePalette[] = {0x000000, 0xAA0000, 0x00AA00, 0xAA5500, 0x0000AA, 0xAA00AA, 0x00AAAA, 0xAAAAAA, 0x555555, 0xFF5555, 0x55FF55, 0xFFFF55, 0x5555FF, 0xFF55FF, 0x55FFFF, 0xFFFFFF};
 
-	Palette *pal[PaletteGroup::PAL_NUM];
-	memset(pal, 0, sizeof(pal));
+/*
+ * Allocate a palette of num colors for the bit depth, indexed palettes take
+ * the next free slots of the lookup table.
+ */
+static Palette *newPalette(unsigned num, int bitdepth, unsigned &slot)
+{
+	if (bitdepth != PALETTE_INDEXED_DEPTH)
+		return new PaletteTrueColor(num);
 
-	pal[PaletteGroup::PAL_BACKGROUND] = new PaletteTrueColor(BACKGROUND_PAL_NUM);
-	pal[PaletteGroup::PAL_FRAME] = new PaletteTrueColor(FRAME_PAL_NUM);
-	pal[PaletteGroup::PAL_TITLEBAR] = new PaletteTrueColor(TITLEBAR_PAL_NUM);
-	pal[PaletteGroup::PAL_PROGRESSBAR] = new PaletteTrueColor(PROGRESSBAR_PAL_NUM);
-	// FIXME: where is this one ?
-	pal[PaletteGroup::PAL_DESKTOP] = new PaletteTrueColor(1);
-	pal[PaletteGroup::PAL_BUTTON] = new PaletteTrueColor(BUTTON_PAL_NUM);
-	pal[PaletteGroup::PAL_WINICON] = new PaletteTrueColor(WINICON_PAL_NUM);
-	pal[PaletteGroup::PAL_SCROLLBAR] = new PaletteTrueColor(SCROLLBAR_PAL_NUM);
+	Palette *pal = new PaletteIndexed(num, slot);
+	slot += num;
+	return pal;
+}
 
+static bool loadGroup(Palette *pal[], enum SystemColorPalette sel)
+{
 	switch (sel)
 	{
 	case SYS_PALETTE_WINOS2:
@@ -294,34 +303,57 @@ class PaletteGroup *PaletteGroupFactory::create(enum SystemColorPalette sel, int
 		break;
 
 	default:
-		delete pal[PaletteGroup::PAL_BACKGROUND];
-		delete pal[PaletteGroup::PAL_FRAME];
-		delete pal[PaletteGroup::PAL_TITLEBAR];
-		delete pal[PaletteGroup::PAL_PROGRESSBAR];
-		delete pal[PaletteGroup::PAL_DESKTOP];
-		delete pal[PaletteGroup::PAL_BUTTON];
-		delete pal[PaletteGroup::PAL_WINICON];
-		delete pal[PaletteGroup::PAL_SCROLLBAR];
+		return false;
+	}
+
+	pal[PaletteGroup::PAL_CONSOLE]->loadPalette(consolePalette);
+	return true;
+}
+
+class PaletteGroup *PaletteGroupFactory::create(enum SystemColorPalette sel, int bitdepth)
+{
+	Palette *pal[PaletteGroup::PAL_NUM];
+	memset(pal, 0, sizeof(pal));
+	// The system colors come first in the lookup table
+	unsigned slot = SYSTEM_PALETTE_SIZE;
+
+	pal[PaletteGroup::PAL_BACKGROUND] = newPalette(BACKGROUND_PAL_NUM, bitdepth, slot);
+	pal[PaletteGroup::PAL_FRAME] = newPalette(FRAME_PAL_NUM, bitdepth, slot);
+	pal[PaletteGroup::PAL_TITLEBAR] = newPalette(TITLEBAR_PAL_NUM, bitdepth, slot);
+	pal[PaletteGroup::PAL_PROGRESSBAR] = newPalette(PROGRESSBAR_PAL_NUM, bitdepth, slot);
+	// FIXME: where is this one ?
+	pal[PaletteGroup::PAL_DESKTOP] = newPalette(1, bitdepth, slot);
+	pal[PaletteGroup::PAL_BUTTON] = newPalette(BUTTON_PAL_NUM, bitdepth, slot);
+	pal[PaletteGroup::PAL_WINICON] = newPalette(WINICON_PAL_NUM, bitdepth, slot);
+	pal[PaletteGroup::PAL_SCROLLBAR] = newPalette(SCROLLBAR_PAL_NUM, bitdepth, slot);
+	pal[PaletteGroup::PAL_CONSOLE] = newPalette(CONSOLE_PAL_NUM, bitdepth, slot);
+
+	if (!loadGroup(pal, sel))
+	{
+		for (unsigned i = 0; i < PaletteGroup::PAL_NUM; i++)
+			delete pal[i];
 		return nullptr;
 	}
 
 	return new PaletteGroup(pal, PaletteGroup::PAL_NUM);
 }
 
-PaletteGroupFactory::PaletteGroupFactory()
+bool PaletteGroupFactory::reload(class PaletteGroup *group, enum SystemColorPalette sel)
 {
+	Palette *pal[PaletteGroup::PAL_NUM];
+
+	if (!group || !group->storePalette(pal))
+		return false;
+
+	return loadGroup(pal, sel);
 }
 
-class Palette *SystemPaletteFactory::create(enum SystemColorPalette sel, int bitdepth)
+PaletteGroupFactory::PaletteGroupFactory()
 {
-	/*
-	 * Right now supports only 32 bit depth
-	 */
-	if (bitdepth != 32)
-		return nullptr;
-
-	Palette *pal = new PaletteTrueColor(16);
+}
 
+static bool loadSystem(Palette *pal, enum SystemColorPalette sel)
+{
 	switch (sel)
 	{
 	case SYS_PALETTE_WINOS2:
@@ -343,6 +375,23 @@ class Palette *SystemPaletteFactory::create(enum SystemColorPalette sel, int bit
 		break;
 
 	default:
+		return false;
+	}
+
+	return true;
+}
+
+class Palette *SystemPaletteFactory::create(enum SystemColorPalette sel, int bitdepth)
+{
+	Palette *pal;
+
+	if (bitdepth == PALETTE_INDEXED_DEPTH)
+		pal = new PaletteIndexed(SYSTEM_PALETTE_SIZE, 0);
+	else
+		pal = new PaletteTrueColor(SYSTEM_PALETTE_SIZE);
+
+	if (!loadSystem(pal, sel))
+	{
 		delete pal;
 		return nullptr;
 	}
@@ -350,6 +399,14 @@ class Palette *SystemPaletteFactory::create(enum SystemColorPalette sel, int bit
 	return pal;
 }
 
+bool SystemPaletteFactory::reload(class Palette *pal, enum SystemColorPalette sel)
+{
+	if (!pal)
+		return false;
+
+	return loadSystem(pal, sel);
+}
+
 SystemPaletteFactory::SystemPaletteFactory()
 {
 }
@@ -31,11 +31,31 @@ enum SystemColorPalette
 	SYS_PALETTE_DEBUG,
 	SYS_PALETTE_NUM
 };
+
+// Number of system colors
+#define SYSTEM_PALETTE_SIZE 16
+
+/*
+ * Bit depth selecting indexed palettes: the colors are slots of the
+ * lookup table of PaletteIndexed, resolved by the renderer.
+ * With any other bit depth the palettes hold 0x00RRGGBB colors, the
+ * renderer converts them to its pixel format.
+ */
+#define PALETTE_INDEXED_DEPTH 8
+
 class PaletteGroupFactory
 {
 public:
 	static class PaletteGroup *create(enum SystemColorPalette sel, int bitdepth);
 
+	/*
+	 * Load the colors of the theme sel into the palettes of an existing group.
+	 *
+	 * RETURN
+	 * true if the theme is available
+	 */
+	static bool reload(class PaletteGroup *group, enum SystemColorPalette sel);
+
 private:
 	PaletteGroupFactory();
 };
@@ -45,6 +65,14 @@ class SystemPaletteFactory
 public:
 	static class Palette *create(enum SystemColorPalette sel, int bitdepth);
 
+	/*
+	 * Load the colors of the theme sel into an existing palette.
+	 *
+	 * RETURN
+	 * true if the theme is available
+	 */
+	static bool reload(class Palette *pal, enum SystemColorPalette sel);
+
 private:
 	SystemPaletteFactory();
 };
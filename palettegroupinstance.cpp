@@ -19,7 +19,7 @@
 
 #include "palettegroupinstance.h"
 
-PaletteGroupInstance::PaletteGroupInstance() : pg(nullptr)
+PaletteGroupInstance::PaletteGroupInstance() : pg(nullptr), depth(0)
 {
 }
 
@@ -32,10 +32,19 @@ PaletteGroupInstance *PaletteGroupInstance::instance()
 
 void PaletteGroupInstance::configure(enum SystemColorPalette sel, int bitdepth)
 {
+	/*
+	 * Same bit depth: only the colors change, the palettes are kept.
+	 * With indexed palettes the slots do not change either, the views
+	 * do not need to be drawn again.
+	 */
+	if (pg && (bitdepth == depth) && PaletteGroupFactory::reload(pg, sel))
+		return;
+
 	if (pg)
 		delete pg;
 
 	pg = PaletteGroupFactory::create(sel, bitdepth);
+	depth = (pg) ? bitdepth : 0;
 }
 
 class PaletteGroup *PaletteGroupInstance::get()
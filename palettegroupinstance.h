@@ -36,6 +36,11 @@ public:
 	 */
 	class PaletteGroup *get(void);
 
+	/*
+	 * Retrieve the configured bit depth, 0 if not configured.
+	 */
+	inline int getBitDepth(void) const { return depth; }
+
 	/*
 	 * Retrieve the singleton instance.
 	 */
@@ -43,6 +48,7 @@ public:
 
 private:
 	class PaletteGroup *pg;
+	int depth;
 
 	PaletteGroupInstance();
 };
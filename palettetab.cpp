@@ -28,7 +28,7 @@ PaletteTab::PaletteTab(Rectangle &viewLimits) : View(viewLimits)
 void PaletteTab::drawView()
 {
 	Rectangle viewRect;
-	ViewRender *r = GRenderer;
+	ViewRenderBackend *r = GRenderer;
 	Palette *p = GSystemPalette;
 	getViewport(viewRect);
 	unsigned ruled = p->size() / 2;
@@ -62,14 +62,27 @@ void PaletteTab::handleEvent(Event *evt)
 	{
 		if (evt->testPositionalEventStatus(POS_EVT_SINGLE))
 		{
-			SystemPaletteInstance::instance()->configure((SystemColorPalette)p, 32);
-			PaletteGroupInstance::instance()->configure((SystemColorPalette)p, 32);
+			int depth = PaletteGroupInstance::instance()->getBitDepth();
+
+			SystemPaletteInstance::instance()->configure((SystemColorPalette)p, depth);
+			PaletteGroupInstance::instance()->configure((SystemColorPalette)p, depth);
 			p++;
 			if (p == SYS_PALETTE_NUM)
 				p = 0;
 
-			setChanged(VIEW_CHANGED_REDRAW);
-			sendCommandToTopView(CMD_REDRAW);
+			/*
+			 * Indexed colors are resolved composing the screen, the
+			 * buffers of the views are still valid.
+			 */
+			if (depth == PALETTE_INDEXED_DEPTH)
+			{
+				sendCommandToTopView(CMD_DRAW);
+			}
+			else
+			{
+				setChanged(VIEW_CHANGED_REDRAW);
+				sendCommandToTopView(CMD_REDRAW);
+			}
 		}
 	}
 }
\ No newline at end of file
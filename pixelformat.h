@@ -0,0 +1,126 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _PIXELFORMAT_H_
+#define _PIXELFORMAT_H_
+
+#include <cstdint>
+#include "color_utils.h"
+
+/*
+ * Pixel formats of the video memory, used as template parameters by
+ * the CPU rasterizer (see rasterizer.h).
+ * Each format defines:
+ *  pixel_t - the type of a pixel in memory
+ *  bitsPerPixel - the bit depth
+ *  pack() - convert a 0xAARRGGBB color to a pixel, as stored in memory
+ *  unpack() - convert a pixel stored in memory to a 0xAARRGGBB color
+ * Multi byte pixels are stored little endian, whatever the host byte order.
+ * Both conversions are constexpr, constant colors cost nothing at run time.
+ */
+
+/*
+ * 32 bits, 8 bits per component, memory order B G R A
+ */
+struct PixelARGB8888
+{
+	typedef uint32_t pixel_t;
+	static constexpr int bitsPerPixel = 32;
+
+	static constexpr pixel_t pack(uint32_t argb) { return toLE32(argb); }
+	static constexpr uint32_t unpack(pixel_t pixel) { return toLE32(pixel); }
+};
+
+/*
+ * 24 bits, 8 bits per component, memory order B G R
+ */
+struct Pixel888
+{
+	uint8_t b, g, r;
+};
+
+struct PixelRGB888
+{
+	typedef Pixel888 pixel_t;
+	static constexpr int bitsPerPixel = 24;
+
+	static constexpr pixel_t pack(uint32_t argb) { return {blueOf(argb), greenOf(argb), redOf(argb)}; }
+	static constexpr uint32_t unpack(pixel_t pixel) { return makeARGB(0xFF, pixel.r, pixel.g, pixel.b); }
+};
+
+/*
+ * 16 bits, 5 bits red, 6 bits green, 5 bits blue
+ */
+struct PixelRGB565
+{
+	typedef uint16_t pixel_t;
+	static constexpr int bitsPerPixel = 16;
+
+	static constexpr pixel_t pack(uint32_t argb)
+	{
+		return toLE16((uint16_t)(((redOf(argb) >> 3) << 11) | ((greenOf(argb) >> 2) << 5) | (blueOf(argb) >> 3)));
+	}
+
+	static constexpr uint32_t unpack(pixel_t pixel)
+	{
+		// Low bits are filled replicating the high ones, white stays white
+		return makeARGB(0xFF,
+				(uint8_t)(((toLE16(pixel) >> 8) & 0xF8) | (toLE16(pixel) >> 13)),
+				(uint8_t)(((toLE16(pixel) >> 3) & 0xFC) | ((toLE16(pixel) >> 9) & 0x03)),
+				(uint8_t)(((toLE16(pixel) << 3) & 0xF8) | ((toLE16(pixel) >> 2) & 0x07)));
+	}
+};
+
+/*
+ * 8 bits, index in a fixed palette made of 3 bits red, 3 bits green, 2 bits blue
+ */
+struct PixelIndexed8
+{
+	typedef uint8_t pixel_t;
+	static constexpr int bitsPerPixel = 8;
+
+	static constexpr pixel_t pack(uint32_t argb)
+	{
+		return (uint8_t)((redOf(argb) & 0xE0) | ((greenOf(argb) >> 3) & 0x1C) | (blueOf(argb) >> 6));
+	}
+
+	static constexpr uint32_t unpack(pixel_t pixel)
+	{
+		return makeARGB(0xFF,
+				(uint8_t)((pixel & 0xE0) | ((pixel >> 3) & 0x1C) | (pixel >> 6)),
+				(uint8_t)(((pixel << 3) & 0xE0) | (pixel & 0x1C) | ((pixel >> 3) & 0x03)),
+				(uint8_t)((pixel & 0x03) * 0x55));
+	}
+};
+
+/*
+ * 8 bits, slot of the lookup table of PaletteIndexed (see palette.h).
+ * Colors are already slots, the conversion to a color happens when the
+ * frame is sent to the video memory (see viewrenderlut.h).
+ */
+struct PixelLUT8
+{
+	typedef uint8_t pixel_t;
+	static constexpr int bitsPerPixel = 8;
+
+	static constexpr pixel_t pack(uint32_t slot) { return (uint8_t)slot; }
+	static constexpr uint32_t unpack(pixel_t pixel) { return pixel; }
+};
+
+#endif
\ No newline at end of file
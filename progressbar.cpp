@@ -31,7 +31,7 @@ void ProgressBar::drawView()
 {
 	unsigned color, color2;
 	int pxcent;
-	ViewRender *r = GRenderer;
+	ViewRenderBackend *r = GRenderer;
 	Palette *p = GPaletteGroup->getPalette(PaletteGroup::PAL_PROGRESSBAR);
 	Rectangle viewRect;
 	getViewport(viewRect);
@@ -0,0 +1,332 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _RASTERIZER_H_
+#define _RASTERIZER_H_
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include "geometry.h"
+#include "bitmapfont.h"
+#include "pixelformat.h"
+
+/*
+ * A memory area holding pixels, rows are pitch bytes apart.
+ */
+struct Surface
+{
+	uint8_t *pixels;
+	int width, height, pitch;
+};
+
+/*
+ * CPU drawing kernels for the pixel format Format (see pixelformat.h).
+ * Colors are packed once per call, the inner loops move pixels of the
+ * native size with no per pixel format check.
+ * All kernels clip to the surface; coordinates are inclusive.
+ */
+template <class Format>
+class Rasterizer
+{
+public:
+	typedef typename Format::pixel_t pixel_t;
+
+	static inline pixel_t pack(uint32_t argb) { return Format::pack(argb); }
+
+	static inline pixel_t *row(const Surface &s, int y)
+	{
+		return reinterpret_cast<pixel_t *>(s.pixels + y * s.pitch);
+	}
+
+	/*
+	 * Fill a rectangle.
+	 *
+	 * PARAMETERS IN
+	 * Surface &s - the destination
+	 * const Rectangle &rect - the area to be filled
+	 * pixel_t pixel - the packed color
+	 */
+	static void fill(const Surface &s, const Rectangle &rect, pixel_t pixel)
+	{
+		int x0 = std::max(rect.ul.x, 0);
+		int y0 = std::max(rect.ul.y, 0);
+		int x1 = std::min(rect.lr.x, s.width - 1);
+		int y1 = std::min(rect.lr.y, s.height - 1);
+
+		if ((x0 > x1) || (y0 > y1))
+			return;
+
+		for (int y = y0; y <= y1; y++)
+			std::fill_n(row(s, y) + x0, x1 - x0 + 1, pixel);
+	}
+
+	static inline void hline(const Surface &s, int x0, int x1, int y, pixel_t pixel)
+	{
+		fill(s, Rectangle(std::min(x0, x1), y, std::max(x0, x1), y), pixel);
+	}
+
+	static inline void vline(const Surface &s, int x, int y0, int y1, pixel_t pixel)
+	{
+		fill(s, Rectangle(x, std::min(y0, y1), x, std::max(y0, y1)), pixel);
+	}
+
+	/*
+	 * Trace a line from a to b, both ends included (Bresenham).
+	 */
+	static void line(const Surface &s, const Point &a, const Point &b, pixel_t pixel)
+	{
+		if (a.y == b.y)
+			return hline(s, a.x, b.x, a.y, pixel);
+		if (a.x == b.x)
+			return vline(s, a.x, a.y, b.y, pixel);
+
+		int dx = (b.x > a.x) ? (b.x - a.x) : (a.x - b.x);
+		int dy = (b.y > a.y) ? -(b.y - a.y) : -(a.y - b.y);
+		int sx = (a.x < b.x) ? 1 : -1;
+		int sy = (a.y < b.y) ? 1 : -1;
+		int err = dx + dy;
+		int x = a.x, y = a.y;
+
+		for (;;)
+		{
+			if ((x >= 0) && (y >= 0) && (x < s.width) && (y < s.height))
+				row(s, y)[x] = pixel;
+			if ((x == b.x) && (y == b.y))
+				break;
+
+			int e2 = 2 * err;
+			if (e2 >= dy)
+			{
+				err += dy;
+				x += sx;
+			}
+			if (e2 <= dx)
+			{
+				err += dx;
+				y += sy;
+			}
+		}
+	}
+
+	/*
+	 * Copy an area of src to dst, both surfaces have the same format.
+	 *
+	 * PARAMETERS IN
+	 * Surface &dst - the destination
+	 * Surface &src - the source
+	 * const Rectangle &area - the area to be copied, in src coordinates
+	 * const Point &to - the upper left corner of the copy, in dst coordinates
+	 */
+	static void blit(const Surface &dst, const Surface &src, const Rectangle &area, const Point &to)
+	{
+		int sx = area.ul.x, sy = area.ul.y;
+		int dx = to.x, dy = to.y;
+		int w = area.lr.x - area.ul.x + 1;
+		int h = area.lr.y - area.ul.y + 1;
+
+		// Clip against both surfaces
+		if (sx < 0)
+		{
+			w += sx;
+			dx -= sx;
+			sx = 0;
+		}
+		if (sy < 0)
+		{
+			h += sy;
+			dy -= sy;
+			sy = 0;
+		}
+		if (dx < 0)
+		{
+			w += dx;
+			sx -= dx;
+			dx = 0;
+		}
+		if (dy < 0)
+		{
+			h += dy;
+			sy -= dy;
+			dy = 0;
+		}
+		w = std::min(w, std::min(src.width - sx, dst.width - dx));
+		h = std::min(h, std::min(src.height - sy, dst.height - dy));
+
+		if ((w <= 0) || (h <= 0))
+			return;
+
+		for (int y = 0; y < h; y++)
+			memcpy(row(dst, dy + y) + dx, row(src, sy + y) + sx, w * sizeof(pixel_t));
+	}
+
+	/*
+	 * Expand a 1 bit per pixel glyph, most significant bit on the left.
+	 * Whole bytes clear or set are skipped or filled at once, the bits
+	 * are tested one by one only on the edges of the strokes.
+	 *
+	 * PARAMETERS IN
+	 * Surface &s - the destination
+	 * const uint8_t *bits - the glyph rows
+	 * int w, int h - the glyph size in pixels
+	 * int stride - the distance between rows of the glyph, in bytes
+	 * const Point &at - the upper left corner of the glyph
+	 * const Rectangle &clip - the area that can be drawn
+	 * pixel_t fg - the packed color of the pixels set
+	 * pixel_t bg - the packed color of the pixels clear
+	 * bool opaque - if false the pixels clear are left untouched
+	 */
+	static void glyph(const Surface &s, const uint8_t *bits, int w, int h, int stride,
+			  const Point &at, const Rectangle &clip, pixel_t fg, pixel_t bg, bool opaque)
+	{
+		int x0, y0, x1, y1;
+
+		if (!clipGlyph(s, w, h, at, clip, x0, y0, x1, y1))
+			return;
+
+		for (int y = y0; y < y1; y++)
+		{
+			const uint8_t *src = bits + y * stride;
+			pixel_t *dst = row(s, at.y + y) + at.x;
+			int x = x0;
+
+			while (x < x1)
+			{
+				uint8_t byte = src[x >> 3];
+
+				if (((x & 7) == 0) && (x + 8 <= x1) && ((byte == 0x00) || (byte == 0xFF)))
+				{
+					if (byte || opaque)
+						std::fill_n(dst + x, 8, (byte) ? fg : bg);
+					x += 8;
+					continue;
+				}
+
+				if (byte & (0x80 >> (x & 7)))
+					dst[x] = fg;
+				else if (opaque)
+					dst[x] = bg;
+				x++;
+			}
+		}
+	}
+
+	/*
+	 * Blend a glyph with 1 byte of coverage per pixel on the surface.
+	 * Pixels fully covered or not covered at all are not blended.
+	 *
+	 * PARAMETERS IN
+	 * Surface &s - the destination
+	 * const uint8_t *alpha - the glyph rows
+	 * int w, int h - the glyph size in pixels
+	 * int stride - the distance between rows of the glyph, in bytes
+	 * const Point &at - the upper left corner of the glyph
+	 * const Rectangle &clip - the area that can be drawn
+	 * uint32_t fcolor - the color of the glyph, 0xAARRGGBB
+	 */
+	static void glyphAlpha(const Surface &s, const uint8_t *alpha, int w, int h, int stride,
+			       const Point &at, const Rectangle &clip, uint32_t fcolor)
+	{
+		int x0, y0, x1, y1;
+		pixel_t fg = pack(fcolor);
+
+		if (!clipGlyph(s, w, h, at, clip, x0, y0, x1, y1))
+			return;
+
+		for (int y = y0; y < y1; y++)
+		{
+			const uint8_t *src = alpha + y * stride;
+			pixel_t *dst = row(s, at.y + y) + at.x;
+
+			for (int x = x0; x < x1; x++)
+			{
+				unsigned a = src[x];
+
+				if (a == 0)
+					continue;
+				if (a == 0xFF)
+				{
+					dst[x] = fg;
+					continue;
+				}
+
+				uint32_t back = Format::unpack(dst[x]);
+				uint32_t mixed = 0xFF000000;
+				for (int shift = 0; shift < 24; shift += 8)
+				{
+					int f = (fcolor >> shift) & 0xFF;
+					int b = (back >> shift) & 0xFF;
+					mixed |= (uint32_t)((b * 255 + (f - b) * (int)a + 127) / 255) << shift;
+				}
+				dst[x] = pack(mixed);
+			}
+		}
+	}
+
+	/*
+	 * Draw a string with a bitmap font (see bitmapfont.h), only the
+	 * pixels of the glyphs are written.
+	 * char strings are Latin-1, uint16_t strings are UCS-2.
+	 *
+	 * PARAMETERS IN
+	 * Surface &s - the destination
+	 * const BitmapFont &font - the font
+	 * const T *text - the string
+	 * Point pen - the start of the baseline
+	 * const Rectangle &clip - the area that can be drawn
+	 * uint32_t fcolor - the color of the text, 0xAARRGGBB
+	 */
+	template <class T>
+	static void text(const Surface &s, const BitmapFont &font, const T *text, Point pen,
+			 const Rectangle &clip, uint32_t fcolor)
+	{
+		pixel_t fg = pack(fcolor);
+
+		for (; *text && (pen.x <= clip.lr.x); text++)
+		{
+			const BitmapGlyph &g = font.find(static_cast<typename std::make_unsigned<T>::type>(*text));
+			Point at(pen.x + g.left, pen.y - g.top);
+
+			if (font.bitsPerPixel == BITMAP_FONT_MONO)
+				glyph(s, font.bits + g.offset, g.width, g.height, font.stride(g), at, clip, fg, fg, false);
+			else
+				glyphAlpha(s, font.bits + g.offset, g.width, g.height, font.stride(g), at, clip, fcolor);
+			pen.x += g.advance;
+		}
+	}
+
+private:
+	/*
+	 * Clip a glyph to the surface and to clip, the range of its pixels
+	 * to be drawn is returned, the ends excluded.
+	 */
+	static inline bool clipGlyph(const Surface &s, int w, int h, const Point &at, const Rectangle &clip,
+				     int &x0, int &y0, int &x1, int &y1)
+	{
+		x0 = std::max(std::max(0, clip.ul.x) - at.x, 0);
+		y0 = std::max(std::max(0, clip.ul.y) - at.y, 0);
+		x1 = std::min(std::min(s.width - 1, clip.lr.x) - at.x + 1, w);
+		y1 = std::min(std::min(s.height - 1, clip.lr.y) - at.y + 1, h);
+
+		return (x0 < x1) && (y0 < y1);
+	}
+};
+
+#endif
\ No newline at end of file
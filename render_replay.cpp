@@ -0,0 +1,123 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Capture replay tool.
+ * A capture written by ViewRenderCapture is played on the selected renderer
+ * as fast as possible, the time taken by each frame is reported.
+ *
+ * render_replay <capture> [hw|vga|vesa|lut|text] [repeat]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <SDL2/SDL.h>
+#include "viewrenderfactory.h"
+#include "viewrendercapture.h"
+
+static bool selectRenderer(const char *name, enum ViewRenderType &sel)
+{
+	if (!strcmp(name, "hw"))
+		sel = VRENDER_HW;
+	else if (!strcmp(name, "vga"))
+		sel = VRENDER_VGA;
+	else if (!strcmp(name, "vesa"))
+		sel = VRENDER_VESA;
+	else if (!strcmp(name, "lut"))
+		sel = VRENDER_LUT;
+	else if (!strcmp(name, "text"))
+		sel = VRENDER_TEXT;
+	else
+		return false;
+
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	enum ViewRenderType sel = VRENDER_HW;
+	int repeat = 1;
+
+	if ((argc < 2) || ((argc > 2) && !selectRenderer(argv[2], sel)))
+	{
+		std::cout << "usage: " << argv[0] << " <capture> [hw|vga|vesa|lut|text] [repeat]" << std::endl;
+		return 1;
+	}
+
+	if (argc > 3)
+		repeat = atoi(argv[3]);
+
+	SDL_Init(0);
+
+	RenderCapturePlayer player;
+	if (!player.open(argv[1]))
+	{
+		std::cout << argv[1] << " is not a valid capture" << std::endl;
+		return 1;
+	}
+
+	ViewRender *r = ViewRenderFactory::create(sel, player.getXRes(), player.getYRes(), player.getBitDepth());
+	if (!r)
+	{
+		std::cout << "Renderer not available" << std::endl;
+		return 1;
+	}
+
+	std::cout << "frame\trecords\tms" << std::endl;
+
+	unsigned frames = 0;
+	double total = 0, worst = 0, best = 0;
+	for (int pass = 0; pass < repeat; pass++)
+	{
+		if (pass && !player.open(argv[1]))
+			break;
+
+		for (;;)
+		{
+			auto start = std::chrono::steady_clock::now();
+			bool played = player.playFrame(r);
+			auto stop = std::chrono::steady_clock::now();
+
+			if (!played)
+				break;
+
+			double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+			std::cout << frames << "\t" << player.getFrameRecords() << "\t" << ms << std::endl;
+
+			if (!frames || (ms < best))
+				best = ms;
+			if (ms > worst)
+				worst = ms;
+			total += ms;
+			frames++;
+		}
+
+		player.close(r);
+	}
+
+	if (frames)
+		std::cout << frames << " frames, min " << best << " ms, avg " << total / frames << " ms, max " << worst << " ms" << std::endl;
+
+	delete r;
+	SDL_Quit();
+
+	return 0;
+}
\ No newline at end of file
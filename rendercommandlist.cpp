@@ -0,0 +1,334 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include "rendercommandlist.h"
+
+RenderCommandList::RenderCommandList() : commands(nullptr), size(0), capacity(0),
+					 rects(nullptr), rectsSize(0), rectsCapacity(0),
+					 points(nullptr), pointsSize(0), pointsCapacity(0),
+					 colors(nullptr), colorsSize(0), colorsCapacity(0),
+					 chars(nullptr), charsSize(0), charsCapacity(0),
+					 wchars(nullptr), wcharsSize(0), wcharsCapacity(0)
+{
+}
+
+RenderCommandList::~RenderCommandList()
+{
+	delete[] commands;
+	delete[] rects;
+	delete[] points;
+	delete[] colors;
+	delete[] chars;
+	delete[] wchars;
+}
+
+template <typename T>
+void RenderCommandList::reserve(T *&array, unsigned used, unsigned &capacity, unsigned needed)
+{
+	if (used + needed <= capacity)
+		return;
+
+	unsigned newCapacity = (capacity) ? (capacity * 2) : 16;
+	while (newCapacity < used + needed)
+		newCapacity *= 2;
+
+	T *newArray = new T[newCapacity];
+	for (unsigned i = 0; i < used; i++)
+		newArray[i] = array[i];
+
+	delete[] array;
+	array = newArray;
+	capacity = newCapacity;
+}
+
+RenderCommand &RenderCommandList::append(enum RenderOp op)
+{
+	reserve(commands, size, capacity, 1);
+
+	RenderCommand &cmd = commands[size++];
+	cmd.op = op;
+	cmd.len = 0;
+	cmd.inner = false;
+	cmd.ptr = nullptr;
+	cmd.first = cmd.count = 0;
+	return cmd;
+}
+
+void RenderCommandList::line(const Point &a, const Point &b, uint32_t color)
+{
+	RenderCommand &cmd = append(RCMD_LINE);
+	cmd.rect.ul = a;
+	cmd.rect.lr = b;
+	cmd.colors[0] = color;
+}
+
+void RenderCommandList::hline(const Point &a, int len, uint32_t color)
+{
+	RenderCommand &cmd = append(RCMD_HLINE);
+	cmd.rect.ul = a;
+	cmd.len = len;
+	cmd.colors[0] = color;
+}
+
+void RenderCommandList::vline(const Point &a, int len, uint32_t color)
+{
+	RenderCommand &cmd = append(RCMD_VLINE);
+	cmd.rect.ul = a;
+	cmd.len = len;
+	cmd.colors[0] = color;
+}
+
+void RenderCommandList::rectangle(const Rectangle &rect, int len, uint32_t color)
+{
+	RenderCommand &cmd = append(RCMD_RECTANGLE);
+	cmd.rect = rect;
+	cmd.len = len;
+	cmd.colors[0] = color;
+}
+
+void RenderCommandList::filledRectangle(const Rectangle &rect, uint32_t color)
+{
+	RenderCommand &cmd = append(RCMD_FILLED_RECTANGLE);
+	cmd.rect = rect;
+	cmd.colors[0] = color;
+}
+
+void RenderCommandList::filledRectangle2(const Rectangle &rect, uint32_t colors[2])
+{
+	RenderCommand &cmd = append(RCMD_FILLED_RECTANGLE2);
+	cmd.rect = rect;
+	cmd.colors[0] = colors[0];
+	cmd.colors[1] = colors[1];
+}
+
+void RenderCommandList::frame(const Rectangle &rect, int len, uint32_t colors[2], bool inner)
+{
+	RenderCommand &cmd = append(RCMD_FRAME);
+	cmd.rect = rect;
+	cmd.len = len;
+	cmd.colors[0] = colors[0];
+	cmd.colors[1] = colors[1];
+	cmd.inner = inner;
+}
+
+void RenderCommandList::fillRects(const Rectangle *rects, int n, uint32_t color)
+{
+	if (n <= 0)
+		return;
+
+	reserve(this->rects, rectsSize, rectsCapacity, n);
+	RenderCommand &cmd = append(RCMD_FILL_RECTS);
+	cmd.colors[0] = color;
+	cmd.first = rectsSize;
+	cmd.count = n;
+	for (int i = 0; i < n; i++)
+		this->rects[rectsSize++] = rects[i];
+}
+
+void RenderCommandList::fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors)
+{
+	if (n <= 0)
+		return;
+
+	reserve(this->rects, rectsSize, rectsCapacity, n);
+	reserve(this->colors, colorsSize, colorsCapacity, n);
+	RenderCommand &cmd = append(RCMD_FILL_RECTS_COLORED);
+	// Rectangles and colors are stored at the same index
+	cmd.first = rectsSize;
+	cmd.count = n;
+	cmd.len = colorsSize;
+	for (int i = 0; i < n; i++)
+	{
+		this->rects[rectsSize++] = rects[i];
+		this->colors[colorsSize++] = colors[i];
+	}
+}
+
+void RenderCommandList::lines(const Point *points, int n, uint32_t color)
+{
+	if (n <= 0)
+		return;
+
+	reserve(this->points, pointsSize, pointsCapacity, n);
+	RenderCommand &cmd = append(RCMD_LINES);
+	cmd.colors[0] = color;
+	cmd.first = pointsSize;
+	cmd.count = n;
+	for (int i = 0; i < n; i++)
+		this->points[pointsSize++] = points[i];
+}
+
+void RenderCommandList::text(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const char *text)
+{
+	if (!text)
+		return;
+
+	unsigned len = strlen(text) + 1;
+	reserve(chars, charsSize, charsCapacity, len);
+	RenderCommand &cmd = append(RCMD_TEXT);
+	cmd.rect = rect;
+	cmd.colors[0] = fcolor;
+	cmd.colors[1] = bcolor;
+	cmd.first = charsSize;
+	cmd.count = len;
+	memcpy(chars + charsSize, text, len);
+	charsSize += len;
+}
+
+void RenderCommandList::textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const uint16_t *text)
+{
+	if (!text)
+		return;
+
+	unsigned len = 0;
+	while (text[len++])
+		;
+
+	reserve(wchars, wcharsSize, wcharsCapacity, len);
+	RenderCommand &cmd = append(RCMD_TEXT_UNICODE);
+	cmd.rect = rect;
+	cmd.colors[0] = fcolor;
+	cmd.colors[1] = bcolor;
+	cmd.first = wcharsSize;
+	cmd.count = len;
+	memcpy(wchars + wcharsSize, text, len * sizeof(uint16_t));
+	wcharsSize += len;
+}
+
+void RenderCommandList::drawBMP(void *bmp, const Rectangle &rect)
+{
+	RenderCommand &cmd = append(RCMD_DRAW_BMP);
+	cmd.rect = rect;
+	cmd.ptr = bmp;
+}
+
+void RenderCommandList::start(void)
+{
+	append(RCMD_START);
+}
+
+void RenderCommandList::clear(uint32_t color)
+{
+	RenderCommand &cmd = append(RCMD_CLEAR);
+	cmd.colors[0] = color;
+}
+
+void RenderCommandList::setBuffer(const void *buffer)
+{
+	RenderCommand &cmd = append(RCMD_SET_BUFFER);
+	cmd.ptr = buffer;
+}
+
+void RenderCommandList::writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem)
+{
+	RenderCommand &cmd = append(RCMD_WRITE_BUFFER);
+	cmd.ptr = buffer;
+	cmd.rect = rect;
+	cmd.rect2 = vidmem;
+}
+
+void RenderCommandList::setClipping(const Rectangle *clip)
+{
+	RenderCommand &cmd = append(RCMD_SET_CLIPPING);
+	if (clip)
+	{
+		cmd.rect = *clip;
+		cmd.len = 1;
+	}
+}
+
+void RenderCommandList::replay(ViewRender *r, unsigned first, unsigned count) const
+{
+	unsigned last = (first + count > size) ? size : first + count;
+
+	for (unsigned i = first; i < last; i++)
+	{
+		const RenderCommand &cmd = commands[i];
+		uint32_t colors[2] = {cmd.colors[0], cmd.colors[1]};
+
+		switch (cmd.op)
+		{
+		case RCMD_LINE:
+			r->line(cmd.rect.ul, cmd.rect.lr, cmd.colors[0]);
+			break;
+		case RCMD_HLINE:
+			r->hline(cmd.rect.ul, cmd.len, cmd.colors[0]);
+			break;
+		case RCMD_VLINE:
+			r->vline(cmd.rect.ul, cmd.len, cmd.colors[0]);
+			break;
+		case RCMD_RECTANGLE:
+			r->rectangle(cmd.rect, cmd.len, cmd.colors[0]);
+			break;
+		case RCMD_FILLED_RECTANGLE:
+			r->filledRectangle(cmd.rect, cmd.colors[0]);
+			break;
+		case RCMD_FILLED_RECTANGLE2:
+			r->filledRectangle2(cmd.rect, colors);
+			break;
+		case RCMD_FRAME:
+			r->frame(cmd.rect, cmd.len, colors, cmd.inner);
+			break;
+		case RCMD_FILL_RECTS:
+			r->fillRects(rects + cmd.first, cmd.count, cmd.colors[0]);
+			break;
+		case RCMD_FILL_RECTS_COLORED:
+			r->fillRectsColored(rects + cmd.first, cmd.count, this->colors + cmd.len);
+			break;
+		case RCMD_LINES:
+			r->lines(points + cmd.first, cmd.count, cmd.colors[0]);
+			break;
+		case RCMD_TEXT:
+			r->text(cmd.rect, cmd.colors[0], cmd.colors[1], chars + cmd.first);
+			break;
+		case RCMD_TEXT_UNICODE:
+			r->textUNICODE(cmd.rect, cmd.colors[0], cmd.colors[1], wchars + cmd.first);
+			break;
+		case RCMD_DRAW_BMP:
+			r->drawBMP(const_cast<void *>(cmd.ptr), cmd.rect);
+			break;
+		case RCMD_START:
+			r->start();
+			break;
+		case RCMD_CLEAR:
+			r->clear(cmd.colors[0]);
+			break;
+		case RCMD_SET_BUFFER:
+			r->setBuffer(cmd.ptr);
+			break;
+		case RCMD_WRITE_BUFFER:
+			r->writeBuffer(cmd.ptr, cmd.rect, cmd.rect2);
+			break;
+		case RCMD_SET_CLIPPING:
+			r->setClipping((cmd.len) ? &cmd.rect : nullptr);
+			break;
+		}
+	}
+}
+
+void RenderCommandList::reset(void)
+{
+	size = 0;
+	rectsSize = 0;
+	pointsSize = 0;
+	colorsSize = 0;
+	charsSize = 0;
+	wcharsSize = 0;
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _RENDERCOMMANDLIST_H_
+#define _RENDERCOMMANDLIST_H_
+
+#include <cstdint>
+#include "geometry.h"
+#include "viewrender.h"
+
+/*
+ * The ViewRender operations a command list can store
+ */
+enum RenderOp
+{
+	RCMD_LINE,
+	RCMD_HLINE,
+	RCMD_VLINE,
+	RCMD_RECTANGLE,
+	RCMD_FILLED_RECTANGLE,
+	RCMD_FILLED_RECTANGLE2,
+	RCMD_FRAME,
+	RCMD_FILL_RECTS,
+	RCMD_FILL_RECTS_COLORED,
+	RCMD_LINES,
+	RCMD_TEXT,
+	RCMD_TEXT_UNICODE,
+	RCMD_DRAW_BMP,
+	RCMD_START,
+	RCMD_CLEAR,
+	RCMD_SET_BUFFER,
+	RCMD_WRITE_BUFFER,
+	RCMD_SET_CLIPPING
+};
+
+/*
+ * A recorded ViewRender call; parameters which do not fit in
+ * the command (arrays and strings) are stored in the command list
+ * and referred by first and count.
+ */
+struct RenderCommand
+{
+	enum RenderOp op;
+	// The rectangle, the line ends (ul, lr) or the writeBuffer() source
+	Rectangle rect;
+	// The writeBuffer() destination
+	Rectangle rect2;
+	uint32_t colors[2];
+	// Layers or line length, for RCMD_SET_CLIPPING 0 removes clipping
+	int len;
+	bool inner;
+	// The buffer or the bitmap
+	const void *ptr;
+	unsigned first, count;
+};
+
+/*
+ * RenderCommandList stores a sequence of ViewRender calls to be
+ * replayed later on a renderer. Arrays and strings are copied,
+ * callers can release them as soon as the call returns.
+ * Buffers and bitmaps are referred by pointer and MUST be valid
+ * when the list is replayed.
+ */
+class RenderCommandList
+{
+public:
+	RenderCommandList();
+	~RenderCommandList();
+
+	/*
+	 * Record a call, see ViewRender for the parameters
+	 */
+	void line(const Point &a, const Point &b, uint32_t color);
+	void hline(const Point &a, int len, uint32_t color);
+	void vline(const Point &a, int len, uint32_t color);
+	void rectangle(const Rectangle &rect, int len, uint32_t color);
+	void filledRectangle(const Rectangle &rect, uint32_t color);
+	void filledRectangle2(const Rectangle &rect, uint32_t colors[2]);
+	void frame(const Rectangle &rect, int len, uint32_t colors[2], bool inner);
+	void fillRects(const Rectangle *rects, int n, uint32_t color);
+	void fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors);
+	void lines(const Point *points, int n, uint32_t color);
+	void text(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const char *text);
+	void textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const uint16_t *text);
+	void drawBMP(void *bmp, const Rectangle &rect);
+	void start(void);
+	void clear(uint32_t color);
+	void setBuffer(const void *buffer);
+	void writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem);
+	void setClipping(const Rectangle *clip);
+
+	/*
+	 * Replay count commands starting from first on a renderer.
+	 *
+	 * PARAMETERS IN
+	 * ViewRender *r - the renderer
+	 * unsigned first - index of the first command
+	 * unsigned count - number of commands
+	 */
+	void replay(ViewRender *r, unsigned first, unsigned count) const;
+
+	/*
+	 * Replay all the commands on a renderer.
+	 *
+	 * PARAMETERS IN
+	 * ViewRender *r - the renderer
+	 */
+	inline void replay(ViewRender *r) const { replay(r, 0, size); }
+
+	/*
+	 * Remove all the commands, memory is retained for the next recording.
+	 */
+	void reset(void);
+
+	inline unsigned getSize(void) const { return size; }
+
+	inline const RenderCommand &operator[](unsigned index) const { return commands[index]; }
+
+private:
+	RenderCommandList(const RenderCommandList &other) = delete;
+	RenderCommandList &operator=(const RenderCommandList &other) = delete;
+
+	RenderCommand &append(enum RenderOp op);
+	template <typename T>
+	static void reserve(T *&array, unsigned used, unsigned &capacity, unsigned needed);
+
+	RenderCommand *commands;
+	unsigned size, capacity;
+
+	// Storage for arrays and strings
+	Rectangle *rects;
+	unsigned rectsSize, rectsCapacity;
+	Point *points;
+	unsigned pointsSize, pointsCapacity;
+	uint32_t *colors;
+	unsigned colorsSize, colorsCapacity;
+	char *chars;
+	unsigned charsSize, charsCapacity;
+	uint16_t *wchars;
+	unsigned wcharsSize, wcharsCapacity;
+};
+
+#endif
\ No newline at end of file
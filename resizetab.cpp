@@ -21,7 +21,7 @@
 #include "resizetab.h"
 #include "window_icon_palette.h"
 
-ResizeTab::ResizeTab(Rectangle &viewLimits) : View(viewLimits), resize(0, 0)
+ResizeTab::ResizeTab(Rectangle &viewLimits) : View(viewLimits), resize(0, 0), outline(0, 0, 0, 0)
 {
 	setResizeMode(VIEW_BOUNDED);
 	clearOptions(VIEW_OPT_VALIDATE);
@@ -30,7 +30,7 @@ ResizeTab::ResizeTab(Rectangle &viewLimits) : View(viewLimits), resize(0, 0)
 void ResizeTab::drawView()
 {
 	Rectangle viewRect;
-	ViewRender *r = GRenderer;
+	ViewRenderBackend *r = GRenderer;
 	Palette *p = GPaletteGroup->getPalette(PaletteGroup::PAL_WINICON);
 	getViewport(viewRect);
 
@@ -64,8 +64,14 @@ void ResizeTab::handleEvent(Event *evt)
 {
 	View::handleEvent(evt);
 
-	if (isEventPositionValid(evt))
+	/*
+	 * While resizing in outline mode the pointer leaves this view,
+	 * events are delivered anyway by the top view.
+	 */
+	if (isEventPositionValid(evt) || (isEventPositional(evt) && getParent()->getState(VIEW_STATE_DRAGGING)))
 	{
+		bool outlined = getTopView()->getResizeMode(VIEW_RESIZE_OUTLINE);
+
 		if (evt->testPositionalEventStatus(POS_EVT_DRAG))
 		{
 			bool pressed = (evt->testPositionalEventStatus(POS_EVT_PRESSED) && evt->testPositionalEventPos(POS_EVT_LEFT));
@@ -75,6 +81,30 @@ void ResizeTab::handleEvent(Event *evt)
 				if (!getParent()->getState(VIEW_STATE_DRAGGING))
 				{
 					getParent()->setState(VIEW_STATE_DRAGGING);
+					getParent()->getExtent(outline);
+					getParent()->globalize(outline);
+				}
+
+				if (outlined)
+				{
+					/*
+					 * Trace the outline only, the parent will be resized once
+					 * the buttons are released.
+					 */
+					Point min, max;
+					Rectangle resized;
+					resized = outline;
+					resized.lr.move(evt->getPositionalEvent()->xrel, evt->getPositionalEvent()->yrel);
+					getParent()->sizeLimits(min, max);
+					if ((resized.width() <= max.x) &&
+					    (resized.width() >= min.x) &&
+					    (resized.height() <= max.y) &&
+					    (resized.height() >= min.y))
+					{
+						outline = resized;
+						sendCommandToTopView(CMD_RESIZING, outline);
+					}
+					return;
 				}
 
 				Rectangle rect;
@@ -90,6 +120,17 @@ void ResizeTab::handleEvent(Event *evt)
 		{
 			/* Reset dragging */
 			getParent()->clearState(VIEW_STATE_DRAGGING);
+
+			if (outlined)
+			{
+				/*
+				 * Apply the outline size, the buffers are reallocated once
+				 */
+				Rectangle rect;
+				getParent()->getBorders(rect);
+				rect.lr.move(outline.width() - rect.width(), outline.height() - rect.height());
+				getParent()->setLocation(rect);
+			}
 			setChanged(VIEW_CHANGED_REDRAW);
 			/* Now ask for redrawing */
 			sendCommandToTopView(CMD_REDRAW);
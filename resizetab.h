@@ -33,6 +33,11 @@ public:
 
 protected:
 	Point resize;
+	/*
+	 * The outline of the parent being resized, in screen coordinates,
+	 * used in outline mode only.
+	 */
+	Rectangle outline;
 };
 
 #endif
\ No newline at end of file
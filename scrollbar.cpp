@@ -72,7 +72,7 @@ void ScrollBar::drawView()
 	unsigned color[2];
 	Rectangle viewRect;
 	getViewport(viewRect);
-	ViewRender *r = GRenderer;
+	ViewRenderBackend *r = GRenderer;
 	Palette *p = GPaletteGroup->getPalette(PaletteGroup::PAL_SCROLLBAR);
 
 	p->getPalette(SCROLLBAR_BRIGHT, color[0]);
@@ -19,7 +19,7 @@
 
 #include "systempaletteinstance.h"
 
-SystemPaletteInstance::SystemPaletteInstance() : pg(nullptr)
+SystemPaletteInstance::SystemPaletteInstance() : pg(nullptr), depth(0)
 {
 }
 
@@ -32,10 +32,15 @@ SystemPaletteInstance *SystemPaletteInstance::instance()
 
 void SystemPaletteInstance::configure(enum SystemColorPalette sel, int bitdepth)
 {
+	// Same bit depth: load the new colors into the existing palette
+	if (pg && (bitdepth == depth) && SystemPaletteFactory::reload(pg, sel))
+		return;
+
 	if (pg)
 		delete pg;
 
 	pg = SystemPaletteFactory::create(sel, bitdepth);
+	depth = (pg) ? bitdepth : 0;
 }
 
 class Palette *SystemPaletteInstance::get()
@@ -37,6 +37,11 @@ public:
 	 */
 	class Palette *get();
 
+	/*
+	 * Retrieve the configured bit depth, 0 if not configured.
+	 */
+	inline int getBitDepth(void) const { return depth; }
+
 	/*
 	 * Retrieve the singleton instance.
 	 */
@@ -44,6 +49,7 @@ public:
 
 private:
 	class Palette *pg;
+	int depth;
 
 	SystemPaletteInstance();
 };
@@ -17,11 +17,24 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
 #include "desktopapp.h"
 
 int main(int argc, char *argv[])
 {
-    DesktopApp myApp;
+    // testsys --capture <file> writes a capture for render_replay
+    // testsys --command-list draws through the command list recorder
+    const char *capture = nullptr;
+    bool commandList = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--capture") && (i + 1 < argc))
+            capture = argv[++i];
+        else if (!strcmp(argv[i], "--command-list"))
+            commandList = true;
+    }
+
+    DesktopApp myApp(capture, commandList);
     Rectangle win(10, 10, 700, 400);
 
     myApp.createWindow(win, "My Window");
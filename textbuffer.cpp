@@ -17,59 +17,303 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
 #include "textbuffer.h"
 
+/*
+ * Fill n cells with the same value, 4 cells for each 64 bit store.
+ */
+static void fillCells(uint16_t *dst, int n, uint16_t value)
+{
+	uint64_t pattern = value * 0x0001000100010001ULL;
+
+	for (; (n > 0) && ((uintptr_t)dst & 7); n--)
+		*dst++ = value;
+	for (; n >= 4; n -= 4, dst += 4)
+		memcpy(dst, &pattern, sizeof(pattern));
+	for (; n > 0; n--)
+		*dst++ = value;
+}
+
+/*
+ * Clip a copy between buffers of the given sizes, the area and both
+ * positions are updated.
+ */
+static bool clipCopy(int sxres, int syres, int dxres, int dyres, int &sx, int &sy, int &w, int &h, int &dx, int &dy)
+{
+	int offset;
+
+	offset = std::max(std::max(-sx, -dx), 0);
+	sx += offset;
+	dx += offset;
+	w -= offset;
+	offset = std::max(std::max(-sy, -dy), 0);
+	sy += offset;
+	dy += offset;
+	h -= offset;
+
+	w = std::min(w, std::min(sxres - sx, dxres - dx));
+	h = std::min(h, std::min(syres - sy, dyres - dy));
+	return (w > 0) && (h > 0);
+}
+
+/*
+ * Byte masks of the 8 pixels of a glyph row, in memory order, for each
+ * value of the row: a row is drawn with a 64 bit select.
+ */
+static uint8_t expandMask[256][8];
+static bool expandReady = false;
+
+static void buildExpandMask(void)
+{
+	for (int bits = 0; bits < 256; bits++)
+		for (int i = 0; i < 8; i++)
+			expandMask[bits][i] = (bits & (0x80 >> i)) ? 0xFF : 0x00;
+	expandReady = true;
+}
+
 TextBuffer::TextBuffer(int xres, int yres) : xres(xres), yres(yres)
 {
 	bufferSize = xres * yres;
 	buffer = new uint16_t[bufferSize];
+	dirtyRows = new uint32_t[(yres + 31) / 32];
+	dirtyFirst = new int[yres];
+	dirtyLast = new int[yres];
+	setDirty();
 }
 
 TextBuffer::~TextBuffer()
 {
 	delete[] buffer;
+	delete[] dirtyRows;
+	delete[] dirtyFirst;
+	delete[] dirtyLast;
 }
 
-void TextBuffer::setBuffer(uint16_t value)
+bool TextBuffer::clip(int &x, int &y, int &w, int &h) const
 {
-	int counter;
-	unsigned *destination = (unsigned *)(buffer);
-	unsigned temp = value;
-	temp |= (temp << 16);
+	if (x < 0)
+	{
+		w += x;
+		x = 0;
+	}
+	if (y < 0)
+	{
+		h += y;
+		y = 0;
+	}
+	w = std::min(w, xres - x);
+	h = std::min(h, yres - y);
 
-	for (counter = bufferSize; counter > 1; counter -= 2)
-		*destination++ = temp;
+	return (w > 0) && (h > 0);
+}
 
-	if (counter)
+void TextBuffer::markDirty(int x, int y, int w, int h)
+{
+	for (int row = y; row < y + h; row++)
 	{
-		buffer[bufferSize - 1] = value;
+		dirtyRows[row / 32] |= 1u << (row % 32);
+		dirtyFirst[row] = std::min(dirtyFirst[row], x);
+		dirtyLast[row] = std::max(dirtyLast[row], x + w - 1);
 	}
 }
 
+void TextBuffer::setBuffer(uint16_t value)
+{
+	fillCells(buffer, bufferSize, value);
+	setDirty();
+}
+
 void TextBuffer::setBufferXY(int x, int y, uint16_t value)
 {
-	int offset = y * xres + x;
+	if ((x < 0) || (x >= xres) || (y < 0) || (y >= yres))
+		return;
 
-	if (offset < bufferSize)
-		buffer[offset] = value;
+	buffer[y * xres + x] = value;
+	markDirty(x, y, 1, 1);
 }
 
 void TextBuffer::setBufferXY(int x, int y, uint16_t *value, int len)
 {
+	if ((x < 0) || (x >= xres) || (y < 0) || (y >= yres))
+		return;
+
+	// The cells wrap to the next rows
 	int offset = y * xres + x;
 
-	while (len && (offset < bufferSize))
+	len = std::min(len, bufferSize - offset);
+	if (len <= 0)
+		return;
+
+	memcpy(buffer + offset, value, len * sizeof(uint16_t));
+	if (x + len <= xres)
+		markDirty(x, y, len, 1);
+	else
+		markDirty(0, y, xres, (offset + len - 1) / xres - y + 1);
+}
+
+void TextBuffer::setText(int x, int y, const uint8_t *text, int len, uint8_t attr)
+{
+	if ((y < 0) || (y >= yres) || (x < 0) || (x >= xres))
+		return;
+
+	len = std::min(len, xres - x);
+	if (len <= 0)
+		return;
+
+	uint16_t *dst = buffer + y * xres + x;
+	uint16_t high = attr << 8;
+
+	for (int i = 0; i < len; i++)
+		dst[i] = text[i] | high;
+	markDirty(x, y, len, 1);
+}
+
+uint16_t TextBuffer::getBufferXY(int x, int y)
+{
+	if ((x < 0) || (x >= xres) || (y < 0) || (y >= yres))
+		return 0;
+
+	return buffer[y * xres + x];
+}
+
+void TextBuffer::fill(int x, int y, int w, int h, uint16_t value)
+{
+	if (!clip(x, y, w, h))
+		return;
+
+	for (int row = y; row < y + h; row++)
+		fillCells(getRow(row) + x, w, value);
+	markDirty(x, y, w, h);
+}
+
+void TextBuffer::copy(const TextBuffer &src, int sx, int sy, int w, int h, int dx, int dy)
+{
+	if (!clipCopy(src.xres, src.yres, xres, yres, sx, sy, w, h, dx, dy))
+		return;
+
+	for (int row = 0; row < h; row++)
+		memcpy(getRow(dy + row) + dx, src.getRow(sy + row) + sx, w * sizeof(uint16_t));
+	markDirty(dx, dy, w, h);
+}
+
+void TextBuffer::move(int sx, int sy, int w, int h, int dx, int dy)
+{
+	if (!clipCopy(xres, yres, xres, yres, sx, sy, w, h, dx, dy))
+		return;
+
+	// Moving down the rows are copied bottom up, not to overwrite the source
+	if (dy > sy)
+	{
+		for (int row = h - 1; row >= 0; row--)
+			memmove(getRow(dy + row) + dx, getRow(sy + row) + sx, w * sizeof(uint16_t));
+	}
+	else
 	{
-		--len;
-		buffer[offset++] = *value++;
+		for (int row = 0; row < h; row++)
+			memmove(getRow(dy + row) + dx, getRow(sy + row) + sx, w * sizeof(uint16_t));
 	}
+	markDirty(dx, dy, w, h);
 }
 
-uint16_t TextBuffer::getBufferXY(int x, int y)
+void TextBuffer::scroll(int y0, int y1, int lines, uint16_t value)
 {
-	int offset = y * xres + x;
+	y0 = std::max(y0, 0);
+	y1 = std::min(y1, yres - 1);
+
+	int rows = y1 - y0 + 1;
+	if ((rows <= 0) || !lines)
+		return;
+
+	if (std::abs(lines) >= rows)
+		fill(0, y0, xres, rows, value);
+	else if (lines > 0)
+	{
+		move(0, y0 + lines, xres, rows - lines, 0, y0);
+		fill(0, y1 - lines + 1, xres, lines, value);
+	}
+	else
+	{
+		move(0, y0, xres, rows + lines, 0, y0 - lines);
+		fill(0, y0, xres, -lines, value);
+	}
+}
+
+void TextBuffer::blitBuffer(int x, int y, int w, int h, const TextGlyphs &glyphs, uint8_t *dest, int pitch)
+{
+	int cx = x, cy = y;
 
-	if (offset < bufferSize)
-		return (buffer[offset]);
-	return 0;
+	if (!clip(x, y, w, h))
+		return;
+
+	if (!expandReady)
+		buildExpandMask();
+
+	// The cells clipped away are not drawn, skip their pixels
+	dest += (y - cy) * glyphs.height * pitch + (x - cx) * 8;
+
+	for (int row = y; row < y + h; row++)
+	{
+		const uint16_t *cells = getRow(row) + x;
+
+		for (int gy = 0; gy < glyphs.height; gy++)
+		{
+			uint8_t *pixels = dest + ((row - y) * glyphs.height + gy) * pitch;
+
+			for (int i = 0; i < w; i++, pixels += 8)
+			{
+				uint16_t cell = cells[i];
+				uint64_t mask, fg, bg;
+
+				memcpy(&mask, expandMask[glyphs.bits[(cell & 0xFF) * glyphs.height + gy]], sizeof(mask));
+				fg = ((cell >> 8) & 0x0F) * 0x0101010101010101ULL;
+				bg = (cell >> 12) * 0x0101010101010101ULL;
+				fg = (fg & mask) | (bg & ~mask);
+				memcpy(pixels, &fg, sizeof(fg));
+			}
+		}
+	}
+}
+
+int TextBuffer::nextDirtyRow(int y) const
+{
+	if (y < 0)
+		y = 0;
+
+	for (int word = y / 32; word < (yres + 31) / 32; word++)
+	{
+		uint32_t bits = dirtyRows[word];
+
+		// Rows before y in the first word
+		if (word == y / 32)
+			bits &= ~0u << (y % 32);
+		if (!bits)
+			continue;
+
+		int row = word * 32;
+		while (!(bits & 1))
+		{
+			bits >>= 1;
+			row++;
+		}
+		return row;
+	}
+
+	return -1;
+}
+
+void TextBuffer::setDirty()
+{
+	clearDirty();
+	markDirty(0, 0, xres, yres);
+}
+
+void TextBuffer::clearDirty()
+{
+	memset(dirtyRows, 0, ((yres + 31) / 32) * sizeof(uint32_t));
+	std::fill_n(dirtyFirst, yres, xres);
+	std::fill_n(dirtyLast, yres, -1);
 }
\ No newline at end of file
@@ -22,27 +22,153 @@
 
 #include <cstdint>
 
+/*
+ * A font for TextBuffer::blitBuffer(): 256 glyphs 8 pixels wide, each row
+ * of a glyph is a byte with bit 7 the leftmost pixel.
+ */
+struct TextGlyphs
+{
+	const uint8_t *bits;
+	int height;
+};
+
+/*
+ * A grid of xres * yres cells, each holding a character in the low byte
+ * and its attribute in the high byte (VGA text mode layout).
+ * Rows written since the last clearDirty() are marked dirty together with
+ * the columns written, so that only the changed cells are sent to the
+ * display.
+ * Areas are clipped to the buffer.
+ */
 class TextBuffer
 {
 public:
 	TextBuffer(int xres, int yres);
-	~TextBuffer();
+	virtual ~TextBuffer();
 
 	uint16_t *getBuffer(void) const { return buffer; }
+	inline uint16_t *getRow(int y) const { return buffer + y * xres; }
 
 	void setBuffer(uint16_t value);
 
 	void setBufferXY(int x, int y, uint16_t value);
 	void setBufferXY(int x, int y, uint16_t *value, int len);
 
+	/*
+	 * Write characters with the same attribute, the text is clipped to the
+	 * end of the row.
+	 *
+	 * PARAMETERS IN
+	 *  int x, int y - the first cell
+	 *  const uint8_t *text - the characters
+	 *  int len - the number of characters
+	 *  uint8_t attr - the attribute
+	 */
+	void setText(int x, int y, const uint8_t *text, int len, uint8_t attr);
+
 	uint16_t getBufferXY(int x, int y);
 
-	virtual void blitBuffer(int srcx, int srcy, int dstx, int dsty, char *dest) {};
+	/*
+	 * Fill an area with the same cell.
+	 *
+	 * PARAMETERS IN
+	 *  int x, int y - top left cell
+	 *  int w, int h - size of the area in cells
+	 *  uint16_t value - the cell
+	 */
+	void fill(int x, int y, int w, int h, uint16_t value);
+
+	/*
+	 * Copy an area of another buffer.
+	 *
+	 * PARAMETERS IN
+	 *  const TextBuffer &src - the source buffer, MUST NOT be this
+	 *  int sx, int sy - top left cell of the area in src
+	 *  int w, int h - size of the area in cells
+	 *  int dx, int dy - top left cell of the destination
+	 */
+	void copy(const TextBuffer &src, int sx, int sy, int w, int h, int dx, int dy);
+
+	/*
+	 * Move an area within the buffer, source and destination can overlap.
+	 *
+	 * PARAMETERS IN
+	 *  int sx, int sy - top left cell of the area
+	 *  int w, int h - size of the area in cells
+	 *  int dx, int dy - top left cell of the destination
+	 */
+	void move(int sx, int sy, int w, int h, int dx, int dy);
+
+	/*
+	 * Scroll the rows y0 - y1 by lines, up if positive and down if negative;
+	 * the rows left free are filled with value.
+	 */
+	void scroll(int y0, int y1, int lines, uint16_t value);
+
+	/*
+	 * Draw cells as pixels, the foreground and background colors of the
+	 * attribute set the pixels of the glyph and the others.
+	 * Pixels are one byte each, holding the color index 0 - 15.
+	 *
+	 * PARAMETERS IN
+	 *  int x, int y - top left cell
+	 *  int w, int h - size of the area in cells
+	 *  const TextGlyphs &glyphs - the font
+	 *  int pitch - the distance between rows of dest, in bytes
+	 *
+	 * PARAMETERS OUT
+	 *  uint8_t *dest - the pixel of the top left cell
+	 */
+	virtual void blitBuffer(int x, int y, int w, int h, const TextGlyphs &glyphs, uint8_t *dest, int pitch);
+
+	inline int getXRes(void) const { return xres; }
+	inline int getYRes(void) const { return yres; }
+
+	/*
+	 * Check if a row was written since the last clearDirty().
+	 */
+	inline bool isRowDirty(int y) const { return (dirtyRows[y / 32] >> (y % 32)) & 1; }
+
+	/*
+	 * Find the first dirty row starting from y.
+	 *
+	 * RETURN
+	 * the row, or -1 if no row from y on is dirty
+	 */
+	int nextDirtyRow(int y) const;
+
+	/*
+	 * Get the columns written in a dirty row.
+	 *
+	 * PARAMETERS OUT
+	 *  int &first, int &last - the first and the last column written
+	 */
+	inline void getDirtySpan(int y, int &first, int &last) const
+	{
+		first = dirtyFirst[y];
+		last = dirtyLast[y];
+	}
+
+	/*
+	 * Mark all the rows as dirty, e.g. when the display must be refreshed.
+	 */
+	void setDirty(void);
+
+	/*
+	 * Mark all the rows as clean, call it after the rows are displayed.
+	 */
+	void clearDirty(void);
 
 private:
+	bool clip(int &x, int &y, int &w, int &h) const;
+	void markDirty(int x, int y, int w, int h);
+
 	uint16_t *buffer;
 	int bufferSize;
 	int xres, yres;
+	// A bit for each row, and the columns written in each row
+	uint32_t *dirtyRows;
+	int *dirtyFirst, *dirtyLast;
 };
 
 #endif
\ No newline at end of file
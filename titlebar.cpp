@@ -23,7 +23,7 @@
 #include "titlebar.h"
 #include "titlebar_palette.h"
 
-TitleBar::TitleBar(Rectangle &rect, const char *title) : View(rect), title(title), lastPressure(0, 0)
+TitleBar::TitleBar(Rectangle &rect, const char *title) : View(rect), title(title), lastPressure(0, 0), outline(0, 0, 0, 0)
 {
 	setOptions(VIEW_OPT_SELECTABLE);
 	setResizeMode(VIEW_RESIZE_LX);
@@ -33,7 +33,7 @@ void TitleBar::drawView()
 {
 	unsigned color[2];
 	Rectangle viewRect;
-	ViewRender *r = GRenderer;
+	ViewRenderBackend *r = GRenderer;
 	Palette *p = GPaletteGroup->getPalette(PaletteGroup::PAL_TITLEBAR);
 	getViewport(viewRect);
 
@@ -98,6 +98,8 @@ void TitleBar::handleEvent(Event *evt)
 			{
 				lastPressure = newPressure;
 				getParent()->setState(VIEW_STATE_DRAGGING);
+				getParent()->getExtent(outline);
+				getParent()->globalize(outline);
 			}
 			else if (lastPressure != newPressure)
 			{
@@ -105,15 +107,70 @@ void TitleBar::handleEvent(Event *evt)
 				deltaPressure -= lastPressure;
 				lastPressure = newPressure;
 
-				getParent()->moveLocation(deltaPressure);
-				/* Now ask for redrawing */
-				sendCommandToTopView(CMD_DRAW);
+				if (getTopView()->getResizeMode(VIEW_RESIZE_OUTLINE))
+				{
+					/*
+					 * Trace the outline only, the parent will be moved once
+					 * the buttons are released.
+					 */
+					Rectangle moved, current;
+					moved = outline;
+					moved.move(deltaPressure.x, deltaPressure.y);
+					getParent()->getExtent(current);
+					getParent()->globalize(current);
+					Point delta(moved.ul);
+					delta -= current.ul;
+					// The limits of the parent are checked when the move is applied
+					if (getParent()->canMoveLocation(delta))
+					{
+						outline = moved;
+						sendCommandToTopView(CMD_DRAGGING, outline);
+					}
+					return;
+				}
+
+				/*
+				 * Moving does not change the contents of the parent, only the area
+				 * covered before and after the move need to be recomposed.
+				 */
+				Rectangle damage, moved;
+				getParent()->getExtent(damage);
+				getParent()->globalize(damage);
+				if (getParent()->moveLocation(deltaPressure))
+				{
+					getParent()->getExtent(moved);
+					getParent()->globalize(moved);
+					damage.join(moved);
+					/* Now ask for redrawing the damaged area */
+					sendCommandToTopView(CMD_DRAGGING, damage);
+				}
 			}
 		}
 		else if (getParent()->getState(VIEW_STATE_DRAGGING))
 		{
 			/* Reset dragging */
 			getParent()->clearState(VIEW_STATE_DRAGGING);
+
+			if (getTopView()->getResizeMode(VIEW_RESIZE_OUTLINE))
+			{
+				/*
+				 * Apply the outline location, and redraw to remove the outline
+				 */
+				Rectangle current;
+				getParent()->getExtent(current);
+				getParent()->globalize(current);
+				Point deltaPressure(outline.ul);
+				deltaPressure -= current.ul;
+				if (!getParent()->moveLocation(deltaPressure))
+				{
+					/*
+					 * The limits changed since the outline was traced, the
+					 * parent stays where it was
+					 */
+					outline = current;
+				}
+				sendCommandToTopView(CMD_DRAW);
+			}
 		}
 	}
 }
@@ -38,6 +38,11 @@ public:
 private:
 	std::string title;
 	Point lastPressure;
+	/*
+	 * The outline of the parent being moved, in screen coordinates,
+	 * used in outline mode only.
+	 */
+	Rectangle outline;
 };
 
 #endif
\ No newline at end of file
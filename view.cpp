@@ -19,22 +19,25 @@
 
 #include "view.h"
 #include "viewinstances.h"
+#include "rendercommandlist.h"
 #include "background_palette.h"
 #include "frame_palette.h"
 
 View::View(Rectangle &limits, unsigned char flags, View *parent) : parentView(parent),
 								   topView(nullptr),
-								   nextView(nullptr),
-								   prevView(nullptr),
+								   groupIndex(0),
 								   borders(limits),
 								   extent(0, 0, limits.width() - 1, limits.height() - 1),
 								   viewport(0, 0, limits.width() - 1, limits.height() - 1),
+								   globalOrigin(0, 0),
+								   originValid(false),
 								   rflags(0),
 								   sflags(VIEW_STATE_VISIBLE | VIEW_STATE_EXPOSED),
 								   oflags(0),
 								   cflags(VIEW_CHANGED_REDRAW),
 								   aflags(flags),
-								   renderBuffer(nullptr)
+								   renderBuffer(nullptr),
+								   displayList(nullptr)
 {
 	updateViewport();
 	updateRenderBuffer();
@@ -42,10 +45,17 @@ View::View(Rectangle &limits, unsigned char flags, View *parent) : parentView(pa
 
 View::~View()
 {
-	parentView = nextView = prevView = nullptr;
+	parentView = nullptr;
+
+	// No bitmap loaded in background is delivered to a deleted view
+	ViewRenderBackend *r = GRenderer;
+	if (r)
+		r->cancelBMPAsync(this);
 
 	if (renderBuffer)
 		GRenderer->releaseBuffer(renderBuffer);
+
+	delete displayList;
 }
 
 void View::sizeLimits(Point &min, Point &max)
@@ -84,16 +94,23 @@ bool View::setLocation(const Rectangle &loc)
 
 bool View::moveLocation(const Point &delta)
 {
-	Rectangle temp(borders);
-	temp.move(delta.x, delta.y);
-
-	if (parentView && !parentView->borders.includes(temp))
+	if (!canMoveLocation(delta))
 		return false;
 
+	Rectangle temp(borders);
+	temp.move(delta.x, delta.y);
 	changeBorders(temp);
 	return true;
 }
 
+bool View::canMoveLocation(const Point &delta)
+{
+	Rectangle temp(borders);
+	temp.move(delta.x, delta.y);
+
+	return !parentView || parentView->borders.includes(temp);
+}
+
 void View::getOrigin(Point &origin) const
 {
 	origin = borders.ul;
@@ -122,19 +139,20 @@ void View::globalize(Rectangle &rect)
 void View::setParent(View *par)
 {
 	parentView = par;
+	invalidateOrigin();
 }
 
-void View::setNext(View *par)
+void View::invalidateOrigin(void)
 {
-	nextView = par;
+	originValid = false;
 }
 
-void View::setPrev(View *par)
+void View::setGroupIndex(unsigned index)
 {
-	prevView = par;
+	groupIndex = index;
 }
 
-static const unsigned char RVALIDATE = (VIEW_BOUNDED | VIEW_ZOOMED);
+static const unsigned char RVALIDATE = (VIEW_BOUNDED | VIEW_ZOOMED | VIEW_RESIZE_OUTLINE);
 
 void View::setResizeMode(unsigned char flags)
 {
@@ -214,7 +232,12 @@ static const unsigned char SVALIDATE = (VIEW_STATE_VISIBLE |
 void View::setState(unsigned char flags)
 {
 	if (flags & SVALIDATE)
+	{
+		if ((flags & VIEW_STATE_VISIBLE) && !(sflags & VIEW_STATE_VISIBLE))
+			invalidateViewExposure();
+
 		sflags |= flags;
+	}
 }
 
 bool View::getState(unsigned char flags) const
@@ -241,11 +264,18 @@ unsigned char View::getState() const
 void View::clearState(unsigned char flags)
 {
 	if (flags & SVALIDATE)
+	{
+		if ((flags & VIEW_STATE_VISIBLE) && (sflags & VIEW_STATE_VISIBLE))
+			invalidateViewExposure();
+
 		sflags &= ~flags;
+	}
 }
 
 static const unsigned char CVALIDATE = (VIEW_CHANGED_REDRAW |
-					VIEW_CHANGED_DATA);
+					VIEW_CHANGED_DATA |
+					VIEW_CHANGED_BUFFER |
+					VIEW_CHANGED_LOST);
 
 void View::setChanged(unsigned char flags)
 {
@@ -321,7 +351,7 @@ void View::clearAttribute(unsigned char flags)
 
 void View::drawView()
 {
-	ViewRender *r = GRenderer;
+	ViewRenderBackend *r = GRenderer;
 
 	if (aflags & VIEW_IS_SOLID)
 	{
@@ -358,11 +388,13 @@ void View::drawView()
 		 *    DDDDDDDDD
 		 */
 
-		r->frame(temp, 2, color, false);
+		Rectangle rects[24];
+		uint32_t rcolors[24];
+		int n = ViewRender::frameRects(temp, 2, color, false, rects, rcolors);
 		// The frame, width 2 pixels
 		p->getPalette(FRAME_MAIN, color[0]);
 		temp.zoom(-2, -2);
-		r->rectangle(temp, 2, color[0]);
+		n += ViewRender::rectangleRects(temp, 2, color[0], rects + n, rcolors + n);
 
 		// Inner shadow, 2 pixels
 
@@ -375,7 +407,9 @@ void View::drawView()
 		 */
 
 		temp.zoom(-2, -2);
-		r->frame(temp, 2, color, true);
+		n += ViewRender::frameRects(temp, 2, color, true, rects + n, rcolors + n);
+		// The whole border goes to the renderer in a single batch
+		r->fillRectsColored(rects, n, rcolors);
 	}
 	if (aflags & VIEW_IS_SHADOWED)
 	{
@@ -388,6 +422,14 @@ void View::draw()
 	{
 		Rectangle exposed;
 
+		/*
+		 * The view was resized but not redrawn yet, the buffer
+		 * does not match the extent or was released, or the view changed
+		 * while hidden.
+		 */
+		if (cflags & (VIEW_CHANGED_BUFFER | VIEW_CHANGED_LOST | VIEW_CHANGED_REDRAW))
+			View::reDraw();
+
 		if (getParent())
 		{
 			exposed = borders;
@@ -400,21 +442,83 @@ void View::draw()
 		{
 			exposed = extent;
 		}
-		Rectangle dest = exposed;
-		makeGlobal(dest.ul);
-		makeGlobal(dest.lr);
-		GRenderer->writeBuffer(renderBuffer, exposed, dest);
+
+		/*
+		 * Compose the visible region only, parts covered by other views
+		 * would be overdrawn.
+		 */
+		for (unsigned i = 0; i < visible.size(); i++)
+		{
+			Rectangle src;
+			src = visible[i];
+			localize(src);
+			if (!src.intersect(exposed))
+				continue;
+
+			src.intersection(exposed);
+			Rectangle dest;
+			dest = src;
+			globalize(dest);
+			GRenderer->writeBuffer(renderBuffer, src, dest);
+		}
 	}
 }
 
 void View::reDraw()
 {
+	/*
+	 * Hidden views are drawn when exposed again, see draw()
+	 */
+	if (!getState(VIEW_STATE_EXPOSED))
+		return;
+
 	if (getChanged(VIEW_CHANGED_REDRAW))
 	{
+		if (getChanged(VIEW_CHANGED_BUFFER | VIEW_CHANGED_LOST))
+			updateRenderBuffer();
+
 		GRenderer->setBuffer(renderBuffer);
+#ifdef VRENDER_STATIC
+		// Display lists cannot be recorded, lost buffers are drawn again
+		drawView();
+#else
+		if (!displayList)
+			displayList = new RenderCommandList();
+
+		displayList->reset();
+		ViewRenderInstance::instance()->beginDisplayList(displayList);
 		drawView();
+		ViewRenderInstance::instance()->endDisplayList();
+#endif
 		clearChanged(VIEW_CHANGED_REDRAW);
 	}
+	else if (getChanged(VIEW_CHANGED_LOST))
+	{
+		/*
+		 * The contents did not change, restore them without
+		 * running the widget logic again.
+		 */
+		updateRenderBuffer();
+		GRenderer->setBuffer(renderBuffer);
+		displayList->replay(GRenderer);
+	}
+}
+
+void View::releaseRenderBuffer()
+{
+	if (!renderBuffer)
+		return;
+
+	GRenderer->releaseBuffer(renderBuffer);
+	renderBuffer = nullptr;
+
+	/*
+	 * Without a display list the view is drawn from scratch
+	 */
+	if (displayList)
+		cflags |= VIEW_CHANGED_LOST;
+	else
+		setChanged(VIEW_CHANGED_REDRAW);
 }
 
 void View::handleEvent(Event *evt)
@@ -524,17 +628,74 @@ void View::sendCommandToTopView(const uint16_t command)
 	sendEvent(&evt);
 }
 
+void View::sendCommandToTopView(const uint16_t command, const Rectangle &area)
+{
+	Event evt;
+	MessageEvent cmd = {command, 0, this, getTopView(), getTopView(), {(uint32_t)area.ul.x, (uint32_t)area.ul.y, (uint32_t)area.lr.x, (uint32_t)area.lr.y}};
+	evt.setMessageEvent(cmd);
+	sendEvent(&evt);
+}
+
 void View::computeExposure()
 {
 	Rectangle temp(extent);
 	globalize(temp);
 
-	setExposed(!GZBuffer->isAreaSet(temp));
+	/*
+	 * Nothing changed around this view, keep the cached state
+	 */
+	if (!GZBuffer->intersectsClipping(temp))
+		return;
+
+	clipVisibleRegion();
+	addVisibleArea(temp);
+	setExposed(hasVisibleArea());
 
 	if (getState(VIEW_STATE_EXPOSED))
 		GZBuffer->set(temp);
 }
 
+void View::hideExposure()
+{
+	Rectangle temp(extent);
+	globalize(temp);
+
+	if (!GZBuffer->intersectsClipping(temp))
+		return;
+
+	clipVisibleRegion();
+	setExposed(hasVisibleArea());
+}
+
+void View::addVisibleArea(Rectangle &area)
+{
+	if (getState(VIEW_STATE_VISIBLE))
+		GZBuffer->getClearArea(area, visible);
+}
+
+void View::clipVisibleRegion()
+{
+	Rectangle damage;
+
+	if (getState(VIEW_STATE_VISIBLE) && GZBuffer->getClipping(damage))
+		visible.subtract(damage);
+	else
+		visible.clear();
+}
+
+void View::invalidateExposure(Rectangle &area)
+{
+	if (parentView)
+		parentView->invalidateExposure(area);
+}
+
+void View::invalidateViewExposure()
+{
+	Rectangle temp(extent);
+	globalize(temp);
+	invalidateExposure(temp);
+}
+
 void View::sendEvent(Event *evt)
 {
 	if (isCommandForMe(evt->getMessageEvent()))
@@ -543,6 +704,14 @@ void View::sendEvent(Event *evt)
 		getTopView()->sendEvent(evt);
 }
 
+void View::postEvent(Event *evt)
+{
+	if (getTopView() != this)
+		getTopView()->sendEvent(evt);
+	else
+		sendEvent(evt);
+}
+
 bool View::isEventPositional(Event *evt)
 {
 	/* If the event is positional return true */
@@ -660,16 +829,38 @@ void View::setBorders(const Rectangle &newrect)
 {
 	if (borders != newrect)
 	{
+		/*
+		 * Both the old and the new area need their exposure recomputed
+		 */
+		Rectangle damage(extent);
+		globalize(damage);
+
+		if (borders.ul != newrect.ul)
+			invalidateOrigin();
+
 		borders = newrect;
 
-		// View was resized
+		/*
+		 * View was resized, a view being moved keeps the contents
+		 * of its buffer and need not be redrawn.
+		 * The buffer is not reallocated here, the view can be resized
+		 * several times before the next frame is built.
+		 */
 		if (!borders.superpose(extent))
 		{
 			extent.lr = Point(borders.width() - 1, borders.height() - 1);
 			updateViewport();
-			updateRenderBuffer();
+			cflags |= VIEW_CHANGED_BUFFER;
+			setChanged(VIEW_CHANGED_REDRAW);
 		}
-		setChanged(VIEW_CHANGED_REDRAW);
+
+		if (parentView)
+			parentView->updateChildBorders(this);
+
+		Rectangle temp(extent);
+		globalize(temp);
+		damage.join(temp);
+		invalidateExposure(damage);
 	}
 }
 
@@ -698,20 +889,28 @@ void View::changeBorders(const Rectangle &newrect)
 
 void View::makeLocal(Point &origin)
 {
-	if (parentView)
-	{
-		parentView->makeLocal(origin);
-	}
-	origin -= borders.ul;
+	origin -= getGlobalOrigin();
 }
 
 void View::makeGlobal(Point &origin)
 {
-	if (parentView)
+	origin += getGlobalOrigin();
+}
+
+void View::updateChildBorders(View * /*child*/)
+{
+}
+
+const Point &View::getGlobalOrigin(void)
+{
+	if (!originValid)
 	{
-		parentView->makeGlobal(origin);
+		globalOrigin = borders.ul;
+		if (parentView)
+			globalOrigin += parentView->getGlobalOrigin();
+		originValid = true;
 	}
-	origin += borders.ul;
+	return globalOrigin;
 }
 
 void View::setExposed(bool exposed)
@@ -761,6 +960,7 @@ void View::updateRenderBuffer()
 		GRenderer->releaseBuffer(renderBuffer);
 
 	renderBuffer = GRenderer->createBuffer(extent);
+	clearChanged(VIEW_CHANGED_BUFFER | VIEW_CHANGED_LOST);
 }
 
 void View::updateViewport()
@@ -43,7 +43,14 @@ enum
 	VIEW_RESIZE_LY = (1 << 3),
 	VIEW_RESIZEABLE = (VIEW_RESIZE_LX | VIEW_RESIZE_LY),
 	VIEW_BOUNDED = (VIEW_RESIZE_UX | VIEW_RESIZE_UY | VIEW_RESIZE_LX | VIEW_RESIZE_LY),
-	VIEW_ZOOMED = (1 << 4)
+	VIEW_ZOOMED = (1 << 4),
+	/*
+	 * Views are moved or resized by tracing an outline, the new location
+	 * is applied once, when the operation ends.
+	 * The flag is meant to be set on the view running the event loop,
+	 * and applies to all views in its tree.
+	 */
+	VIEW_RESIZE_OUTLINE = (1 << 5)
 };
 
 /*
@@ -109,7 +116,18 @@ enum
 	/* View need to be redrawn */
 	VIEW_CHANGED_REDRAW = (1 << 0),
 	/* View has updated data */
-	VIEW_CHANGED_DATA = (1 << 1)
+	VIEW_CHANGED_DATA = (1 << 1),
+	/*
+	 * View was resized and the buffer must be reallocated before drawing.
+	 * This flag is NOT propagated to the parent view.
+	 */
+	VIEW_CHANGED_BUFFER = (1 << 2),
+	/*
+	 * The buffer was released while the contents of the view did not change,
+	 * the buffer is restored replaying the display list.
+	 * This flag is NOT propagated to the parent view.
+	 */
+	VIEW_CHANGED_LOST = (1 << 3)
 };
 
 /*
@@ -125,6 +143,8 @@ enum
 	VIEW_IS_SHADOWED = (1 << 2)
 };
 
+class RenderCommandList;
+
 /*
  * Class View is the basic interface to a graphical - or text view.
  * Coordinates are referred to the owner's origin.
@@ -198,6 +218,18 @@ public:
 	 */
 	virtual bool moveLocation(const Point &delta);
 
+	/*
+	 * Validate the location computed by moveLocation() without applying
+	 * it, e.g. to trace an outline of the view where it can be moved.
+	 *
+	 * PARAMETERS IN
+	 * const Point &delta - delta coordinates to be added to the origin
+	 *
+	 * RETURN
+	 * true if moveLocation() would accept the new location
+	 */
+	bool canMoveLocation(const Point &delta);
+
 	/*
 	 * Copy the upper left point of borders into origin.
 	 * Origin is relative to the owner's origin.
@@ -258,20 +290,48 @@ public:
 	void setParent(View *par);
 
 	/*
-	 * Set the sibling view (another view in a collection or a group).
+	 * Mark the cached global origin of the view as stale, it will be
+	 * computed again at the next coordinates conversion.
+	 * Groups propagate the invalidation to their children.
+	 * Called whenever the view or one of its owners is moved.
+	 */
+	virtual void invalidateOrigin(void);
+
+	/*
+	 * Release the rendering buffer to save memory, e.g. for views
+	 * which are not going to be shown for a while.
+	 * The buffer is allocated again when the view is drawn, and its contents
+	 * restored by replaying the display list recorded by the last
+	 * drawView(), without running drawView() again.
+	 * Groups release the buffers of their children as well.
+	 */
+	virtual void releaseRenderBuffer(void);
+
+	/*
+	 * Set the position of this view in the collection of its owner.
+	 * Only the owner group is expected to call this method.
 	 *
 	 * PARAMETERS IN
-	 * View *par - pointer to a View instance in background
+	 * unsigned index - the index in the owner's collection
 	 */
-	void setNext(View *par);
+	void setGroupIndex(unsigned index);
 
 	/*
-	 * Set the sibling view (another view in a collection or a group).
+	 * Return the position of this view in the collection of its owner.
+	 */
+	inline unsigned getGroupIndex(void) const { return groupIndex; }
+
+	/*
+	 * Verify if the view is owned by a view.
 	 *
 	 * PARAMETERS IN
-	 * View *par - pointer to a View instance in foreground
+	 * const View *owner - the candidate owner
+	 *
+	 * RETURN
+	 * true if owner is the parent of this view
+	 * false in any other case
 	 */
-	void setPrev(View *par);
+	inline bool isOwnedBy(const View *owner) const { return (parentView == owner); }
 
 	/*
 	 * Set state to foreground, this view is visible and on top
@@ -353,12 +413,22 @@ public:
 	 * contents to the video memory.
 	 * In case the buffer is NULL, rendering output goes directly
 	 * in the video memory so no copy takes place.
+	 * A buffer left out of date while the view was hidden is
+	 * redrawn first.
 	 */
 	virtual void draw(void);
 
 	/*
 	 * Draw the graphics of the view if VIEW_CHANGED_REDRAW is set.
 	 * After drawing the view the flag is reset.
+	 * If the view was resized (VIEW_CHANGED_BUFFER is set) renderBuffer
+	 * is reallocated first, so that several resizes in between two frames
+	 * cost a single reallocation.
+	 * Views not exposed are not drawn and keep VIEW_CHANGED_REDRAW set,
+	 * they are drawn once when exposed again.
+	 * The primitives sent by drawView() are kept in a display list; if only
+	 * the buffer was lost (VIEW_CHANGED_LOST is set) the list is replayed
+	 * into the new buffer instead of invoking drawView().
 	 * Drawing use renderBuffer as target, if it is NULL then the
 	 * output goes to the video memory.
 	 * This method invokes drawView() and draw().
@@ -411,9 +481,32 @@ public:
 	 * First the Z-Buffer is checked, if the covered area is partially or totally clear
 	 * then setExposed(true) is called, otherwise setExposed(false) is called.
 	 * After this operation the view area must be set in the Z-Buffer.
+	 * The clear parts of the area are stored as the visible region of the view,
+	 * draw() composes only the visible region.
+	 * Exposure is cached: when the Z-Buffer is clipped to a damaged area,
+	 * views outside the area keep their state, and the visible region of
+	 * views partially outside the area is updated inside the area only.
 	 */
 	virtual void computeExposure(void);
 
+	/*
+	 * computeExposure() for a view behind views covering the whole
+	 * Z-Buffer: the view is hidden inside the damaged area, no area is
+	 * tested nor set.
+	 */
+	virtual void hideExposure(void);
+
+	/*
+	 * Report that the exposure of the views covering area may have changed,
+	 * because a view was moved, resized, added, removed, raised or hidden.
+	 * The report is forwarded to the parent up to the root view, which
+	 * recomputes the exposure of the damaged area at the next frame.
+	 *
+	 * PARAMETERS IN
+	 * Rectangle &area - the damaged area in screen coordinates
+	 */
+	virtual void invalidateExposure(Rectangle &area);
+
 	/*
 	 * Try to get the focus to this view.
 	 * If the view is selectable, and selection is successful, then grab the focus
@@ -481,10 +574,6 @@ public:
 	 */
 	virtual bool isEventPositionInRange(Event *evt);
 
-	inline View *getNext(void) { return nextView; }
-
-	inline View *getPrev(void) { return prevView; }
-
 	/*
 	 * Copy viewport into rect.
 	 *
@@ -493,6 +582,25 @@ public:
 	 */
 	void getViewport(Rectangle &rect);
 
+	/*
+	 * Send an event to the root view, which queues it while running the
+	 * event loop even if this view is the destination: the event is
+	 * processed later by the thread running the event loop.
+	 * It walks up the tree: other threads MUST call it only on the root,
+	 * or use ViewExec::postUpdate().
+	 * NO memory management is to be performed on evt.
+	 *
+	 * PARAMETERS IN
+	 * Event *evt - a pointer to an event object
+	 */
+	void postEvent(Event *evt);
+
+	/*
+	 * Get the view running the event loop this view belongs to, the root
+	 * view if none is running it.
+	 */
+	View *getTopView(void);
+
 protected:
 	/*
 	 * View constructor.
@@ -511,12 +619,40 @@ protected:
 	/*
 	 * Apply new coordinates.
 	 * Borders are stored in a rectangle in owners coordinates.
+	 * Only geometry is updated, if the view was resized the
+	 * buffer reallocation is deferred to the next reDraw().
 	 *
 	 * PARAMETERS IN
 	 * const Rectangle &newrect - new view borders
 	 */
 	void setBorders(const Rectangle &newrect);
 
+	/*
+	 * Report the area covered by this view to invalidateExposure().
+	 */
+	void invalidateViewExposure(void);
+
+	/*
+	 * Drop the part of the visible region falling inside the damaged area
+	 * (the Z-Buffer clipping), the rest is still valid.
+	 * Called by computeExposure() before adding the new visible parts.
+	 */
+	void clipVisibleRegion(void);
+
+	/*
+	 * Add the parts of area found clear in the Z-Buffer to the visible region,
+	 * nothing is added if the view is not visible.
+	 *
+	 * PARAMETERS IN
+	 * Rectangle &area - the area in screen coordinates
+	 */
+	void addVisibleArea(Rectangle &area);
+
+	/*
+	 * Return true if the visible region is not empty.
+	 */
+	inline bool hasVisibleArea(void) const { return !visible.isEmpty(); }
+
 	/*
 	 * Apply new coordinates and set the view for re-drawing.
 	 * Borders are stored in a rectangle in owners coordinates.
@@ -551,6 +687,7 @@ protected:
 	/*
 	 * Converts coordinates from global (root parent)
 	 * to local (referred to the origin of the calling view).
+	 * Uses the cached global origin, see getGlobalOrigin().
 	 * origin is assumed to be valorized with root parent coordinates,
 	 * so that input origin(0,0) is the origin of the root parent, which
 	 * is usually the size of the screen.
@@ -566,6 +703,7 @@ protected:
 	/*
 	 * Converts coordinates from local (referred to the origin of the calling view)
 	 * to global (screen coordinates).
+	 * Uses the cached global origin, see getGlobalOrigin().
 	 * origin is assumed to be valorized with view coordinates,
 	 * so that input origin(0,0) is the upper left view corner.
 	 *
@@ -577,6 +715,26 @@ protected:
 	 */
 	void makeGlobal(Point &origin);
 
+	/*
+	 * Notify the owner that the borders of a child view changed.
+	 * Groups use this to keep their collection up to date,
+	 * views have no children and do nothing.
+	 *
+	 * PARAMETERS IN
+	 * View *child - the child view that was moved or resized
+	 */
+	virtual void updateChildBorders(View *child);
+
+	/*
+	 * Return the origin of the view in global (screen) coordinates.
+	 * The origin is cached, it is computed from the owner's origin
+	 * only after the view or one of its owners was moved.
+	 *
+	 * RETURN
+	 * the upper left corner of the view in screen coordinates
+	 */
+	const Point &getGlobalOrigin(void);
+
 	/*
 	 * Verify that the event is a valid command, i.e. has destination and sender
 	 * set to a valid pointer.
@@ -711,9 +869,18 @@ protected:
 	 */
 	void sendCommandToTopView(const uint16_t command);
 
-	inline View *getParent(void) { return parentView; }
+	/*
+	 * Create an event carrying an area in screen coordinates and send it
+	 * up to the root parent view.
+	 * The area is stored in the message payload as ul.x, ul.y, lr.x, lr.y.
+	 *
+	 * PARAMETERS IN
+	 * uint16_t command - the command code
+	 * const Rectangle &area - the area in screen coordinates
+	 */
+	void sendCommandToTopView(const uint16_t command, const Rectangle &area);
 
-	View *getTopView(void);
+	inline View *getParent(void) { return parentView; }
 
 	void updateRenderBuffer(void);
 
@@ -734,13 +901,10 @@ private:
 	 */
 	View *topView;
 	/*
-	 * The siblings of this view, can be nullptr.
-	 * These fields can be used to link views in a collection
-	 * (a group).
-	 * nextView points to the next view in list - going background.
-	 * prevView points to the previous view in list - going foreground.
+	 * The position of this view in the collection of its owner (a group),
+	 * index 0 is the last background view.
 	 */
-	View *nextView, *prevView;
+	unsigned groupIndex;
 	/*
 	 * borders is expressed in owner's coordinates,
 	 * and is the area covered by this view in owner's space.
@@ -756,6 +920,17 @@ private:
 	 * It refers to extent NOT to borders.
 	 */
 	Rectangle viewport;
+	/*
+	 * Cached upper left corner of borders in global (screen) coordinates,
+	 * valid only when originValid is true.
+	 */
+	Point globalOrigin;
+	bool originValid;
+	/*
+	 * The parts of the view not covered by other views, in global (screen)
+	 * coordinates, see computeExposure().
+	 */
+	Region visible;
 	/*
 	 * resize flags, state flags, option flags, changed flags, attributes flags
 	 */
@@ -764,6 +939,10 @@ private:
 	 * Rendering buffer, see viewrenderer.h
 	 */
 	void *renderBuffer;
+	/*
+	 * The primitives drawn by the last drawView(), allocated on first draw
+	 */
+	RenderCommandList *displayList;
 };
 
 #endif
\ No newline at end of file
@@ -21,13 +21,122 @@
 #include "viewexec.h"
 #include "background.h"
 #include "event_keyboard.h"
+#include "frame_palette.h"
 
 #include <iostream>
+#include <algorithm>
+#include <mutex>
+#include <vector>
 
-ViewExec::ViewExec(Rectangle &limits, ViewEventManager *evt, View *parent) : ViewGroup(limits, 0, parent), evtM(evt)
+/*
+ * The views waiting for postUpdate(), the ones being served, and the loop
+ * serving them.
+ */
+static std::mutex updateLock;
+static std::vector<View *> updates, delivering;
+static ViewExec *updateLoop = nullptr;
+
+/*
+ * The message waking up the loop, queued directly to its event manager.
+ */
+static void wakeupMessage(ViewExec *loop, Event &evt)
+{
+	MessageEvent cmd = {CMD_UPDATE, 0, loop, loop, loop, {0, 0, 0, 0}};
+
+	evt.setMessageEvent(cmd);
+}
+
+ViewExec::ViewExec(Rectangle &limits, ViewEventManager *evt, View *parent) : ViewGroup(limits, 0, parent), evtM(evt), grab(nullptr), exposureDamage(0, 0, 0, 0), exposureDirty(true)
 {
+	getExtent(exposureDamage);
 	clearOptions(VIEW_OPT_ALL);
 	setState(VIEW_STATE_SELECTED | VIEW_STATE_EVLOOP | VIEW_STATE_FOCUSED);
+
+	std::lock_guard<std::mutex> lock(updateLock);
+	updateLoop = this;
+	// Updates requested before the loop existed
+	if (!updates.empty())
+	{
+		Event evt;
+		wakeupMessage(this, evt);
+		evtM->put(&evt);
+	}
+}
+
+ViewExec::~ViewExec()
+{
+	std::lock_guard<std::mutex> lock(updateLock);
+	if (updateLoop == this)
+		updateLoop = nullptr;
+}
+
+void ViewExec::postUpdate(View *view)
+{
+	std::lock_guard<std::mutex> lock(updateLock);
+
+	if (std::find(updates.begin(), updates.end(), view) != updates.end())
+		return;
+
+	// A wakeup is already queued if other views are waiting
+	updates.push_back(view);
+	if ((updates.size() == 1) && updateLoop)
+	{
+		Event evt;
+		wakeupMessage(updateLoop, evt);
+		updateLoop->evtM->put(&evt);
+	}
+}
+
+void ViewExec::cancelUpdate(View *view)
+{
+	std::lock_guard<std::mutex> lock(updateLock);
+
+	updates.erase(std::remove(updates.begin(), updates.end(), view), updates.end());
+	std::replace(delivering.begin(), delivering.end(), view, (View *)nullptr);
+}
+
+bool ViewExec::handleWakeup(Event *evt)
+{
+	MessageEvent *msg = evt->getMessageEvent();
+
+	if (!evt->isEventCommand() || (msg->command != CMD_UPDATE) || (msg->destObject != this))
+		return false;
+
+	GRenderer->completeBMPAsync();
+
+	/*
+	 * The views waiting now are served, the ones asking again wait for
+	 * the next wakeup: other events go on meanwhile.
+	 */
+	{
+		std::lock_guard<std::mutex> lock(updateLock);
+		delivering.swap(updates);
+	}
+
+	for (size_t i = 0;; i++)
+	{
+		View *view;
+		{
+			std::lock_guard<std::mutex> lock(updateLock);
+			if (i >= delivering.size())
+			{
+				delivering.clear();
+				break;
+			}
+			view = delivering[i];
+		}
+
+		// Cancelled meanwhile
+		if (!view)
+			continue;
+
+		Event update;
+		MessageEvent cmd = {CMD_UPDATE, 0, this, view, view, {0, 0, 0, 0}};
+		update.setMessageEvent(cmd);
+		handleEvent(&update);
+	}
+
+	return true;
 }
 
 void ViewExec::run()
@@ -40,6 +149,8 @@ void ViewExec::run()
 	{
 		while (evtM->wait(&event, 1000))
 		{
+			if (handleWakeup(&event))
+				continue;
 			handleEvent(&event);
 			if (!event.isEventUnknown())
 				event.print();
@@ -51,8 +162,7 @@ void ViewExec::draw()
 {
 	if (getState(VIEW_STATE_EVLOOP))
 	{
-		GZBuffer->clear();
-		computeExposure();
+		updateExposure();
 		GRenderer->start();
 		GRenderer->clear(0);
 		ViewGroup::draw();
@@ -64,8 +174,7 @@ void ViewExec::reDraw()
 {
 	if (getState(VIEW_STATE_EVLOOP))
 	{
-		GZBuffer->clear();
-		computeExposure();
+		updateExposure();
 		GRenderer->start();
 		GRenderer->clear(0);
 		ViewGroup::reDraw();
@@ -74,9 +183,83 @@ void ViewExec::reDraw()
 	}
 }
 
-void ViewExec::sendEvent(Event *evt)
+void ViewExec::drawArea(Rectangle &area)
 {
 	if (getState(VIEW_STATE_EVLOOP))
+	{
+		updateExposure();
+		GRenderer->setClipping(&area);
+		GRenderer->start();
+		GRenderer->clear(0);
+		ViewGroup::draw();
+		GRenderer->setClipping(nullptr);
+		GRenderer->show();
+	}
+}
+
+void ViewExec::invalidateExposure(Rectangle &area)
+{
+	if (exposureDirty)
+		exposureDamage.join(area);
+	else
+		exposureDamage = area;
+
+	exposureDirty = true;
+}
+
+void ViewExec::updateExposure()
+{
+	Rectangle screen;
+
+	if (!exposureDirty)
+		return;
+
+	exposureDirty = false;
+
+	getExtent(screen);
+	if (!exposureDamage.intersect(screen))
+		return;
+	exposureDamage.intersection(screen);
+
+	/*
+	 * Only views intersecting the damaged area are tested,
+	 * the others keep their exposure.
+	 */
+	GZBuffer->setClipping(exposureDamage);
+	GZBuffer->clear(exposureDamage);
+	computeExposure();
+	GZBuffer->resetClipping();
+}
+
+void ViewExec::drawOutline(Rectangle &area)
+{
+	if (getState(VIEW_STATE_EVLOOP))
+	{
+		Palette *p = GPaletteGroup->getPalette(PaletteGroup::PAL_FRAME);
+		unsigned color;
+
+		p->getPalette(FRAME_DRAGGING, color);
+		GRenderer->showOutline(area, color);
+	}
+}
+
+void ViewExec::setOutlineMode(bool enable)
+{
+	if (enable)
+		setResizeMode(VIEW_RESIZE_OUTLINE);
+	else
+		clearResizeMode(VIEW_RESIZE_OUTLINE);
+}
+
+void ViewExec::sendEvent(Event *evt)
+{
+	MessageEvent *msg = evt->getMessageEvent();
+
+	/*
+	 * The renderer wakes up the loop from other threads, its messages are
+	 * always queued, see ViewRender::loadBMPAsync().
+	 */
+	if ((evt->isEventCommand() && (msg->command == CMD_UPDATE) && (msg->destObject == this)) || getState(VIEW_STATE_EVLOOP))
 	{
 		evtM->put(evt);
 	}
@@ -86,7 +269,20 @@ void ViewExec::sendEvent(Event *evt)
 
 void ViewExec::handleEvent(Event *evt)
 {
-	if (evt->isEventKey())
+	if (grab && evt->isEventPositional())
+	{
+		View *target = grab;
+
+		/*
+		 * Buttons released, the operation is over
+		 */
+		if (!evt->testPositionalEventStatus(POS_EVT_PRESSED))
+			grab = nullptr;
+
+		target->handleEvent(evt);
+		evt->clear();
+	}
+	else if (evt->isEventKey())
 	{
 		KeybEvent *key = evt->getKeyDownEvent();
 		switch (key->keyCode)
@@ -101,6 +297,31 @@ void ViewExec::handleEvent(Event *evt)
 			break;
 		}
 	}
+	else if (evt->isEventCommand())
+	{
+		MessageEvent *msg = evt->getMessageEvent();
+		if (isCommandForMe(msg) && ((msg->command == CMD_DRAGGING) || (msg->command == CMD_RESIZING)))
+		{
+			/*
+			 * A view is being moved or resized: in outline mode the payload holds
+			 * the outline, otherwise the area damaged by the move.
+			 */
+			Rectangle area((int)msg->payload[0], (int)msg->payload[1], (int)msg->payload[2], (int)msg->payload[3]);
+			grab = reinterpret_cast<View *>(msg->senderObject);
+			if (getResizeMode(VIEW_RESIZE_OUTLINE))
+				drawOutline(area);
+			else
+				drawArea(area);
+			evt->clear();
+		}
+		else if ((msg->command == CMD_CLOSE) || (msg->command == CMD_QUIT))
+		{
+			/*
+			 * The grabbing view might be going away
+			 */
+			grab = nullptr;
+		}
+	}
 
 	ViewGroup::handleEvent(evt);
 }
\ No newline at end of file
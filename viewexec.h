@@ -33,14 +33,103 @@ public:
 
 	virtual void draw(void) override;
 	virtual void reDraw(void) override;
+
+	/*
+	 * Recompose the area of the screen described by area, leaving the rest
+	 * of the screen untouched.
+	 * Views are composed from their buffers, only the ones whose buffer is
+	 * stale (resized, released or changed while hidden) are redrawn into it
+	 * first: this is meant for views changing position but not contents.
+	 *
+	 * PARAMETERS IN
+	 * Rectangle &area - the damaged area in screen coordinates
+	 */
+	void drawArea(Rectangle &area);
+
+	/*
+	 * Show the last composed frame with the outline of area traced on top.
+	 * No view is drawn or composed.
+	 *
+	 * PARAMETERS IN
+	 * Rectangle &area - the outline in screen coordinates
+	 */
+	void drawOutline(Rectangle &area);
+
+	/*
+	 * Select the interaction mode for moving and resizing views.
+	 * If enabled, views being moved or resized are traced as an outline
+	 * on top of the last frame, and the new location is applied when
+	 * the operation ends; if disabled views are moved and resized live.
+	 * The mode is stored as VIEW_RESIZE_OUTLINE in the resize flags.
+	 *
+	 * PARAMETERS IN
+	 * bool enable - true to enable outline mode, false for live mode
+	 */
+	void setOutlineMode(bool enable);
+
+	/*
+	 * Accumulate the areas whose exposure need to be recomputed,
+	 * see updateExposure().
+	 */
+	virtual void invalidateExposure(Rectangle &area) override;
+
 	virtual void sendEvent(Event *evt) override;
 
 	virtual void handleEvent(Event *evt) override;
 
+	/*
+	 * Have the thread running the event loop send a CMD_UPDATE message to
+	 * view, e.g. when work done in background is ready. Any thread can call
+	 * it: the view is not reached through the tree, and the message is
+	 * delivered only if the view did not cancel it meanwhile. Requests made
+	 * before the delivery are merged.
+	 * The loop is the last ViewExec created.
+	 *
+	 * PARAMETERS IN
+	 * View *view - the destination
+	 */
+	static void postUpdate(View *view);
+
+	/*
+	 * Forget the request of postUpdate() for view, a view using
+	 * postUpdate() MUST call it when destroyed.
+	 */
+	static void cancelUpdate(View *view);
+
 	ViewExec(Rectangle &limits, ViewEventManager *evt, View *parent = nullptr);
+	virtual ~ViewExec();
 
 protected:
 	ViewEventManager *evtM;
+	/*
+	 * The view moving or resizing another view, positional events
+	 * are delivered to it until the buttons are released.
+	 */
+	View *grab;
+
+	/*
+	 * Recompute the exposure of the views inside the damaged area collected
+	 * since the last frame. If nothing was moved, resized, added, removed,
+	 * raised or hidden the cached exposure is used as is.
+	 */
+	void updateExposure(void);
+
+	/*
+	 * Handle the messages waking up the loop from other threads: the
+	 * bitmaps loaded in background and the views of postUpdate() are
+	 * served.
+	 *
+	 * RETURN
+	 * true if evt was one of them
+	 */
+	bool handleWakeup(Event *evt);
+
+	/*
+	 * The area whose exposure need to be recomputed, in screen coordinates,
+	 * valid if exposureDirty is true.
+	 */
+	Rectangle exposureDamage;
+	bool exposureDirty;
 };
 
 #endif
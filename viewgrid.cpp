@@ -0,0 +1,148 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "viewgrid.h"
+
+ViewGrid::ViewGrid(Rectangle &area, unsigned cellSize) : area(area),
+							 cellSize((cellSize) ? cellSize : 1),
+							 columns(0),
+							 rows(0),
+							 cells(nullptr)
+{
+	columns = (area.width() + this->cellSize - 1) / this->cellSize;
+	rows = (area.height() + this->cellSize - 1) / this->cellSize;
+	if (!columns)
+		columns = 1;
+	if (!rows)
+		rows = 1;
+
+	cells = new Cell[columns * rows];
+	for (unsigned i = 0; i < columns * rows; i++)
+	{
+		cells[i].items = nullptr;
+		cells[i].size = cells[i].capacity = 0;
+	}
+}
+
+ViewGrid::~ViewGrid()
+{
+	for (unsigned i = 0; i < columns * rows; i++)
+		delete[] cells[i].items;
+
+	delete[] cells;
+	cells = nullptr;
+}
+
+unsigned ViewGrid::cellIndex(int x, int y)
+{
+	unsigned col = (x < 0) ? 0 : x / cellSize;
+	unsigned row = (y < 0) ? 0 : y / cellSize;
+
+	if (col >= columns)
+		col = columns - 1;
+	if (row >= rows)
+		row = rows - 1;
+
+	return row * columns + col;
+}
+
+bool ViewGrid::cellRange(Rectangle &rect, unsigned &firstCol, unsigned &firstRow, unsigned &lastCol, unsigned &lastRow)
+{
+	if ((rect.lr.x < area.ul.x) ||
+	    (rect.lr.y < area.ul.y) ||
+	    (rect.ul.x > area.lr.x) ||
+	    (rect.ul.y > area.lr.y))
+		return false;
+
+	unsigned first = cellIndex(rect.ul.x - area.ul.x, rect.ul.y - area.ul.y);
+	unsigned last = cellIndex(rect.lr.x - area.ul.x, rect.lr.y - area.ul.y);
+
+	firstCol = first % columns;
+	firstRow = first / columns;
+	lastCol = last % columns;
+	lastRow = last / columns;
+
+	return true;
+}
+
+void ViewGrid::insert(View *view, Rectangle &rect)
+{
+	unsigned firstCol, firstRow, lastCol, lastRow;
+
+	if (!view || !cellRange(rect, firstCol, firstRow, lastCol, lastRow))
+		return;
+
+	for (unsigned row = firstRow; row <= lastRow; row++)
+	{
+		for (unsigned col = firstCol; col <= lastCol; col++)
+		{
+			Cell &cell = cells[row * columns + col];
+
+			if (cell.size == cell.capacity)
+			{
+				unsigned newCapacity = (cell.capacity) ? (cell.capacity * 2) : 4;
+				View **newItems = new View *[newCapacity];
+
+				for (unsigned i = 0; i < cell.size; i++)
+					newItems[i] = cell.items[i];
+
+				delete[] cell.items;
+				cell.items = newItems;
+				cell.capacity = newCapacity;
+			}
+
+			cell.items[cell.size++] = view;
+		}
+	}
+}
+
+void ViewGrid::remove(View *view, Rectangle &rect)
+{
+	unsigned firstCol, firstRow, lastCol, lastRow;
+
+	if (!view || !cellRange(rect, firstCol, firstRow, lastCol, lastRow))
+		return;
+
+	for (unsigned row = firstRow; row <= lastRow; row++)
+	{
+		for (unsigned col = firstCol; col <= lastCol; col++)
+		{
+			Cell &cell = cells[row * columns + col];
+
+			/*
+			 * Order inside a cell does not matter, replace
+			 * the removed view with the last one.
+			 */
+			for (unsigned i = 0; i < cell.size; i++)
+			{
+				if (cell.items[i] == view)
+				{
+					cell.items[i] = cell.items[--cell.size];
+					break;
+				}
+			}
+		}
+	}
+}
+
+void ViewGrid::clear()
+{
+	for (unsigned i = 0; i < columns * rows; i++)
+		cells[i].size = 0;
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VIEWGRID_H_
+#define _VIEWGRID_H_
+
+#include "geometry.h"
+
+class View;
+
+/*
+ * ViewGrid is a uniform grid indexing the children of a group by their borders.
+ * The area of the group is split in square cells, each cell stores the views
+ * overlapping it, so that hit-testing only needs to look at the views
+ * registered in the cell including the event position.
+ * The grid does not know about z-order, the group is in charge of it.
+ * All rectangles and points passed to the methods MUST BE in the coordinates
+ * of the group owning the grid.
+ */
+class ViewGrid
+{
+public:
+	/*
+	 * PARAMETERS IN
+	 * Rectangle &area - the area covered by the grid (the group extent)
+	 * unsigned cellSize - width and height of a cell, in pixels
+	 */
+	ViewGrid(Rectangle &area, unsigned cellSize);
+	~ViewGrid();
+
+	/*
+	 * Register view in all cells overlapped by rect.
+	 *
+	 * PARAMETERS IN
+	 * View *view - the view
+	 * Rectangle &rect - the borders of the view
+	 */
+	void insert(View *view, Rectangle &rect);
+
+	/*
+	 * Remove view from all cells overlapped by rect.
+	 * rect must be the same rectangle used for insert().
+	 *
+	 * PARAMETERS IN
+	 * View *view - the view
+	 * Rectangle &rect - the borders of the view when it was inserted
+	 */
+	void remove(View *view, Rectangle &rect);
+
+	/*
+	 * Remove all views from the grid.
+	 */
+	void clear(void);
+
+	inline unsigned getCellSize(void) const { return cellSize; }
+
+	/*
+	 * Call function f passing every view registered in the cell including where.
+	 * Views are passed in no particular order.
+	 *
+	 * PARAMETERS IN
+	 * Point &where - the point to look up
+	 * void f(View *) - a function call, either a pointer or a lambda function
+	 */
+	template <typename FV>
+	void forEachViewAt(Point &where, FV &&f)
+	{
+		if (!area.includes(where))
+			return;
+
+		Cell &cell = cells[cellIndex(where.x - area.ul.x, where.y - area.ul.y)];
+		for (unsigned i = 0; i < cell.size; i++)
+			f(cell.items[i]);
+	}
+
+private:
+	struct Cell
+	{
+		View **items;
+		unsigned size, capacity;
+	};
+
+	/*
+	 * Return the index of the cell including the point (x, y),
+	 * coordinates are relative to the upper left corner of area and are
+	 * clamped to the grid.
+	 */
+	unsigned cellIndex(int x, int y);
+
+	/*
+	 * Compute the range of cells overlapped by rect.
+	 * Return false if rect falls completely outside the grid.
+	 */
+	bool cellRange(Rectangle &rect, unsigned &firstCol, unsigned &firstRow, unsigned &lastCol, unsigned &lastRow);
+
+	Rectangle area;
+	unsigned cellSize;
+	unsigned columns, rows;
+	Cell *cells;
+};
+
+#endif
\ No newline at end of file
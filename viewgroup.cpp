@@ -24,9 +24,11 @@
 ViewGroup::ViewGroup(Rectangle &limits, unsigned char flags, View *parent) : View(limits, flags, parent),
 									     lastLimits(limits),
 									     actual(nullptr),
-									     listHead(nullptr),
-									     listTail(nullptr),
+									     views(nullptr),
+									     bounds(nullptr),
 									     listSize(0),
+									     listCapacity(0),
+									     grid(nullptr),
 									     lastrflags(0)
 {
 	setOptions(VIEW_OPT_SELECTABLE);
@@ -34,15 +36,33 @@ ViewGroup::ViewGroup(Rectangle &limits, unsigned char flags, View *parent) : Vie
 
 ViewGroup::~ViewGroup()
 {
-	while (listHead)
+	deleteAll();
+
+	delete[] views;
+	delete[] bounds;
+	delete grid;
+	views = nullptr;
+	bounds = nullptr;
+	grid = nullptr;
+	listCapacity = 0;
+}
+
+void ViewGroup::deleteAll()
+{
+	if (grid)
+		grid->clear();
+
+	if (listSize)
+		invalidateViewExposure();
+
+	while (listSize)
 	{
-		View *next = listHead->getNext();
-		delete listHead;
-		listHead = next;
+		listSize--;
+		delete views[listSize];
+		views[listSize] = nullptr;
 	}
 
-	actual = listHead = listTail = nullptr;
-	listSize = 0;
+	actual = nullptr;
 }
 
 bool ViewGroup::setLocation(const Rectangle &loc)
@@ -70,6 +90,12 @@ bool ViewGroup::setLocation(const Rectangle &loc)
 	delta.y = loc.height() - update.height();
 	setBorders(loc);
 
+	/*
+	 * The grid covers the extent, rebuild it if the group was resized
+	 */
+	if (grid && (delta.x || delta.y))
+		setSpatialIndex(grid->getCellSize());
+
 	forEachView([&delta, &update](View *head)
 		    {
 			head->calcLimits(delta, update);
@@ -94,7 +120,11 @@ void ViewGroup::draw()
 
 void ViewGroup::reDraw()
 {
-	if (getChanged(VIEW_CHANGED_REDRAW))
+	/*
+	 * A hidden group keeps its children out of date,
+	 * they are drawn when exposed again.
+	 */
+	if (getChanged(VIEW_CHANGED_REDRAW) && getState(VIEW_STATE_EXPOSED))
 	{
 		View::reDraw();
 		// Update buffers
@@ -125,8 +155,7 @@ void ViewGroup::handleEvent(Event *evt)
 	 */
 	if (isEventPositionValid(evt))
 	{
-		View *toHandle = forEachViewUntilTrue([evt](View *head) -> bool
-						      { return head->isEventPositionInRange(evt); });
+		View *toHandle = viewAt(evt);
 
 		if (toHandle)
 			toHandle->handleEvent(evt);
@@ -266,18 +295,24 @@ void ViewGroup::handleEvent(Event *evt)
 						/*
 						 * If the target is BROADCAST_OBJECT close all views
 						 */
-						while (listHead)
+						if (grid)
+							grid->clear();
+
+						if (listSize)
+							invalidateViewExposure();
+
+						while (listSize)
 						{
-							View *next = listHead->getNext();
-							if (listHead->getState(VIEW_STATE_FOCUSED))
+							View *head = views[listSize - 1];
+							if (head->getState(VIEW_STATE_FOCUSED))
 								focusNext(true);
-							else if (listHead->getState(VIEW_STATE_SELECTED))
+							else if (head->getState(VIEW_STATE_SELECTED))
 								selectNext(true);
-							delete listHead;
-							listHead = next;
+							listSize--;
+							delete head;
+							views[listSize] = nullptr;
 						}
 						actual = nullptr;
-						listSize = 0;
 						evt->clear();
 					}
 					break;
@@ -466,14 +501,7 @@ bool ViewGroup::executeCommand(const uint16_t command, View *caller)
 			return true;
 
 		case CMD_QUIT:
-			while (listHead)
-			{
-				View *next = listHead->getNext();
-				delete listHead;
-				listHead = next;
-			}
-			actual = nullptr;
-			listSize = 0;
+			deleteAll();
 			return true;
 		}
 	}
@@ -524,6 +552,20 @@ void ViewGroup::setForeground()
 		    { head->setForeground(); });
 }
 
+void ViewGroup::invalidateOrigin()
+{
+	View::invalidateOrigin();
+	forEachView([](View *head)
+		    { head->invalidateOrigin(); });
+}
+
+void ViewGroup::releaseRenderBuffer()
+{
+	View::releaseRenderBuffer();
+	forEachView([](View *head)
+		    { head->releaseRenderBuffer(); });
+}
+
 void ViewGroup::setBackground()
 {
 	View::setBackground();
@@ -535,51 +577,178 @@ void ViewGroup::insert(View *newView)
 {
 	if (newView)
 	{
+		if (listSize == listCapacity)
+		{
+			/*
+			 * Grow the collection, doubling its size
+			 */
+			unsigned newCapacity = (listCapacity) ? (listCapacity * 2) : 8;
+			View **newViews = new View *[newCapacity];
+			Rectangle *newBounds = new Rectangle[newCapacity];
+
+			for (unsigned i = 0; i < listSize; i++)
+			{
+				newViews[i] = views[i];
+				newBounds[i] = bounds[i];
+			}
+
+			delete[] views;
+			delete[] bounds;
+			views = newViews;
+			bounds = newBounds;
+			listCapacity = newCapacity;
+		}
+
 		newView->setParent(this);
 		/*
-		 * Insert to the front of the list, i.e. in foreground
+		 * Insert to the end of the collection, i.e. in foreground
 		 */
-		if (listHead)
-		{
-			newView->setNext(listHead);
-			newView->setPrev(nullptr);
-			listHead->setPrev(newView);
-			listHead = newView;
-		}
-		else
-		{
-			newView->setNext(nullptr);
-			newView->setPrev(nullptr);
-			listHead = listTail = newView;
-		}
+		newView->setGroupIndex(listSize);
+		newView->getBorders(bounds[listSize]);
+		views[listSize] = newView;
+		if (grid)
+			grid->insert(newView, bounds[listSize]);
 		listSize++;
+		invalidateChildExposure(newView);
 	}
 }
 
 bool ViewGroup::remove(View *target)
 {
-	if (!target || !listSize)
+	if (!thisViewIsMine(target))
 		return false;
 
-	if (target == listHead)
-		listHead = listHead->getNext();
-	else if (target == listTail)
-		listTail = listTail->getPrev();
+	if (grid)
+		grid->remove(target, bounds[target->getGroupIndex()]);
+	invalidateChildExposure(target);
 
-	View *next = target->getNext();
-	View *prev = target->getPrev();
-	if (next)
-		next->setPrev(prev);
-	if (prev)
-		prev->setNext(next);
+	/*
+	 * Compact the collection, views in foreground of target
+	 * move one step towards the background.
+	 */
+	for (unsigned i = target->getGroupIndex() + 1; i < listSize; i++)
+	{
+		views[i - 1] = views[i];
+		bounds[i - 1] = bounds[i];
+		views[i - 1]->setGroupIndex(i - 1);
+	}
 
-	target->setNext(nullptr);
-	target->setPrev(nullptr);
 	listSize--;
+	views[listSize] = nullptr;
+	target->setParent(nullptr);
+	target->setGroupIndex(0);
 
 	return true;
 }
 
+void ViewGroup::raise(unsigned index)
+{
+	if (index >= listSize)
+		return;
+
+	View *target = views[index];
+	Rectangle targetBounds;
+	targetBounds = bounds[index];
+
+	for (unsigned i = index + 1; i < listSize; i++)
+	{
+		views[i - 1] = views[i];
+		bounds[i - 1] = bounds[i];
+		views[i - 1]->setGroupIndex(i - 1);
+	}
+
+	views[listSize - 1] = target;
+	bounds[listSize - 1] = targetBounds;
+	target->setGroupIndex(listSize - 1);
+	invalidateChildExposure(target);
+}
+
+void ViewGroup::invalidateChildExposure(View *child)
+{
+	Rectangle temp;
+	child->getExtent(temp);
+	child->globalize(temp);
+	invalidateExposure(temp);
+}
+
+void ViewGroup::updateChildBorders(View *child)
+{
+	if (thisViewIsMine(child))
+	{
+		Rectangle &rect = bounds[child->getGroupIndex()];
+
+		if (grid)
+			grid->remove(child, rect);
+		child->getBorders(rect);
+		if (grid)
+			grid->insert(child, rect);
+	}
+}
+
+void ViewGroup::setSpatialIndex(unsigned cellSize)
+{
+	delete grid;
+	grid = nullptr;
+
+	if (cellSize)
+	{
+		Rectangle ext;
+		getExtent(ext);
+		grid = new ViewGrid(ext, cellSize);
+
+		for (unsigned i = 0; i < listSize; i++)
+			grid->insert(views[i], bounds[i]);
+	}
+}
+
+View *ViewGroup::viewAt(Event *evt)
+{
+	Point where(evt->getPositionalEvent()->x, evt->getPositionalEvent()->y);
+
+	makeLocal(where);
+
+	if (!grid)
+	{
+		/*
+		 * Walk the packed borders from foreground to background, views
+		 * are asked only if the event falls inside their borders.
+		 */
+		for (unsigned i = listSize; i > 0; i--)
+		{
+			if (bounds[i - 1].includes(where) && views[i - 1]->isEventPositionInRange(evt))
+				return views[i - 1];
+		}
+
+		return nullptr;
+	}
+
+	/*
+	 * Look up the views registered in the cell, the topmost view including
+	 * the event is asked first. If it refuses the event (e.g. a frame has
+	 * a hole) look for the topmost view below it.
+	 */
+	unsigned limit = listSize;
+	while (true)
+	{
+		View *best = nullptr;
+
+		grid->forEachViewAt(where, [this, &where, &best, limit](View *candidate)
+				    {
+			unsigned index = candidate->getGroupIndex();
+			if ((index < limit) && bounds[index].includes(where) &&
+			    (!best || (index > best->getGroupIndex())))
+				best = candidate; });
+
+		if (!best)
+			return nullptr;
+
+		if (best->isEventPositionInRange(evt))
+			return best;
+
+		limit = best->getGroupIndex();
+	}
+}
+
 View *ViewGroup::actualView()
 {
 	return actual;
@@ -594,15 +763,17 @@ bool ViewGroup::focusNext(bool forward)
 
 	if (actual == nullptr)
 	{
-		temp = listHead;
+		temp = views[listSize - 1];
 	}
 	else
 	{
 		if (forward)
 		{
-			temp = actual->getNext();
-			if (temp == nullptr)
-				temp = listHead;
+			/*
+			 * Next view going background, wrap to the foreground
+			 */
+			unsigned index = actual->getGroupIndex();
+			temp = (index) ? views[index - 1] : views[listSize - 1];
 		}
 		else
 		{
@@ -621,15 +792,17 @@ void ViewGroup::selectNext(bool forward)
 
 	if (actual == nullptr)
 	{
-		temp = listHead;
+		temp = views[listSize - 1];
 	}
 	else
 	{
 		if (forward)
 		{
-			temp = actual->getNext();
-			if (temp == nullptr)
-				temp = listHead;
+			/*
+			 * Next view going background, wrap to the foreground
+			 */
+			unsigned index = actual->getGroupIndex();
+			temp = (index) ? views[index - 1] : views[listSize - 1];
 		}
 		else
 		{
@@ -671,15 +844,15 @@ bool ViewGroup::selectView(View *target)
 
 void ViewGroup::toForeground(View *target)
 {
-	if (listHead != target)
+	if (views[listSize - 1] != target)
 	{
 		/*
 		 * Update Foreground/Background status
 		 */
-		listHead->setBackground();
+		views[listSize - 1]->setBackground();
 
-		if (remove(target))
-			insert(target);
+		if (thisViewIsMine(target))
+			raise(target->getGroupIndex());
 	}
 
 	target->setForeground();
@@ -741,8 +914,14 @@ void ViewGroup::restore()
 
 bool ViewGroup::thisViewIsMine(View *who)
 {
-	return forEachViewUntilTrue([who](View *head) -> bool
-				    { return (head == who) ? true : false; });
+	/*
+	 * Ownership is stored in the view itself, check the index too
+	 * so that views removed from the collection are not claimed.
+	 */
+	if (!who || (who == BROADCAST_OBJECT) || !who->isOwnedBy(this))
+		return false;
+
+	return ((who->getGroupIndex() < listSize) && (views[who->getGroupIndex()] == who));
 }
 
 void ViewGroup::setExposed(bool exposed)
@@ -756,20 +935,65 @@ void ViewGroup::setExposed(bool exposed)
 void ViewGroup::computeExposure()
 {
 	bool exposed = false;
+	Rectangle temp;
+
+	/*
+	 * Children are inside the group, if the group is outside the
+	 * damaged area all of them keep their cached state.
+	 */
+	getExtent(temp);
+	globalize(temp);
+	if (!GZBuffer->intersectsClipping(temp))
+		return;
 	/*
-	 * Set in the Z buffer the layer depth of each view
+	 * Set in the Z buffer the layer depth of each view, front to back: once
+	 * the damaged area is covered the views behind are hidden there.
 	 */
 	forEachView([&exposed](View *head)
 		    {
-		     head->computeExposure();
+		     if (GZBuffer->isFull())
+			head->hideExposure();
+		     else
+			head->computeExposure();
 		     if (head->getState(VIEW_STATE_EXPOSED))
 		     {
 			exposed = true;
 		     } });
 
 	/*
-	 * true or false does not matter, the value is
-	 * recomputed by the method.
+	 * The parts of the group not covered by its children nor by other views
+	 * show the buffer of the group.
 	 */
+	clipVisibleRegion();
+	addVisibleArea(temp);
+	if (hasVisibleArea())
+	{
+		exposed = true;
+		GZBuffer->set(temp);
+	}
+
 	View::setExposed(exposed);
+}
+
+void ViewGroup::hideExposure()
+{
+	bool exposed = false;
+	Rectangle temp;
+
+	getExtent(temp);
+	globalize(temp);
+	if (!GZBuffer->intersectsClipping(temp))
+		return;
+
+	forEachView([&exposed](View *head)
+		    {
+		     head->hideExposure();
+		     if (head->getState(VIEW_STATE_EXPOSED))
+		     {
+			exposed = true;
+		     } });
+
+	// Parts outside the damaged area may still show
+	clipVisibleRegion();
+	View::setExposed(exposed || hasVisibleArea());
 }
\ No newline at end of file
@@ -21,6 +21,7 @@
 #define _VIEWGROUP_H_
 
 #include "view.h"
+#include "viewgrid.h"
 
 class ViewGroup : public View
 {
@@ -40,6 +41,8 @@ public:
 	virtual bool setLocation(const Rectangle &loc) override;
 
 	virtual void setExposed(bool exposed) override;
+	virtual void invalidateOrigin(void) override;
+	virtual void releaseRenderBuffer(void) override;
 
 	virtual void draw(void) override;
 	virtual void reDraw(void) override;
@@ -62,6 +65,32 @@ public:
 	bool remove(View *target);
 	View *actualView(void);
 
+	/*
+	 * Enable or disable the spatial index used for hit-testing.
+	 * Groups with many children should enable it, for a few children
+	 * the linear walk of the collection is faster.
+	 * The index is kept up to date by insert(), remove() and by any
+	 * change of the children borders.
+	 *
+	 * PARAMETERS IN
+	 * unsigned cellSize - the size of a grid cell in pixels,
+	 *                     0 disables the index
+	 */
+	void setSpatialIndex(unsigned cellSize);
+
+	/*
+	 * Find the child view accepting a positional event,
+	 * looking from the foreground to the background.
+	 *
+	 * PARAMETERS IN
+	 * Event *evt - a positional event
+	 *
+	 * RETURN
+	 * the child view in range of the event
+	 * nullptr if no child view is in range
+	 */
+	View *viewAt(Event *evt);
+
 	/*
 	 * Call function f passing every child view as parameter.
 	 * This way the effect of f() are applied to all views.
@@ -72,12 +101,8 @@ public:
 	template <typename FV>
 	void forEachView(FV &&f)
 	{
-		View *head = listHead;
-		while (head)
-		{
-			f(head);
-			head = head->getNext();
-		}
+		for (unsigned i = listSize; i > 0; i--)
+			f(views[i - 1]);
 	}
 
 	/*
@@ -91,12 +116,8 @@ public:
 	template <typename FV>
 	void forEachViewR(FV &&f)
 	{
-		View *tail = listTail;
-		while (tail)
-		{
-			f(tail);
-			tail = tail->getPrev();
-		}
+		for (unsigned i = 0; i < listSize; i++)
+			f(views[i]);
 	}
 
 	/*
@@ -121,16 +142,13 @@ public:
 	template <typename FB>
 	View *forEachViewUntilTrue(FB &&f)
 	{
-		View *head = listHead;
-		while (head)
+		for (unsigned i = listSize; i > 0; i--)
 		{
-			if (f(head))
-				break;
-
-			head = head->getNext();
+			if (f(views[i - 1]))
+				return views[i - 1];
 		}
 
-		return head;
+		return nullptr;
 	}
 
 protected:
@@ -145,6 +163,32 @@ protected:
 	bool thisViewIsMine(View *who);
 
 	virtual void computeExposure(void) override;
+	virtual void hideExposure(void) override;
+	virtual void updateChildBorders(View *child) override;
+
+	/*
+	 * Move the view stored at index to the foreground,
+	 * i.e. to the end of the collection.
+	 * The cost is O(n) in the views in front of it: they shift down by
+	 * one slot and their group index is updated.
+	 *
+	 * PARAMETERS IN
+	 * unsigned index - the index of the view in the collection
+	 */
+	void raise(unsigned index);
+
+	/*
+	 * Delete all views in the collection.
+	 */
+	void deleteAll(void);
+
+	/*
+	 * Report the area covered by a child view to invalidateExposure().
+	 *
+	 * PARAMETERS IN
+	 * View *child - the child view
+	 */
+	void invalidateChildExposure(View *child);
 
 	Rectangle lastLimits;
 
@@ -153,15 +197,23 @@ protected:
 	 */
 	View *actual;
 	/*
-	 * siblings list, views collection of this group.
-	 * listHead points to the foreground view.
-	 * listTail to the last background view.
+	 * Views collection of this group, ordered from background to foreground:
+	 * views[0] is the last background view, views[listSize - 1] is the
+	 * foreground view.
+	 * bounds is packed along views and stores the borders of each view,
+	 * so that hit-testing does not need to dereference the views.
+	 * Views are owned by the group, each view stores its own index.
+	 */
+	View **views;
+	Rectangle *bounds;
+	/*
+	 * Number of siblings in the views collection, and allocated slots
 	 */
-	View *listHead, *listTail;
+	unsigned listSize, listCapacity;
 	/*
-	 * Number of siblings in the views collection
+	 * Optional spatial index of the views collection, can be nullptr.
 	 */
-	unsigned listSize;
+	ViewGrid *grid;
 	/*
 	 * Store the previously used resize flags to restore them later.
 	 * This is useful for resizing/zooming operations.
@@ -25,7 +25,7 @@
 #include "systempaletteinstance.h"
 #include "viewzbuffer.h"
 
-#define GRenderer ViewRenderInstance::instance()->get()
+#define GRenderer ViewRenderInstance::instance()->backend()
 #define GPaletteGroup PaletteGroupInstance::instance()->get()
 #define GZBuffer ViewZBuffer::instance()
 #define GSystemPalette SystemPaletteInstance::instance()->get()
@@ -0,0 +1,132 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "viewrender.h"
+#include "view.h"
+
+int ViewRender::frameRects(const Rectangle &rect, int len, const uint32_t colors[2], bool inner, Rectangle *rects, uint32_t *rcolors)
+{
+	int x = rect.ul.x;
+	int y = rect.ul.y;
+	int w = rect.width() - 1;
+	int h = rect.height() - 1;
+	int n = 0;
+
+	/*
+	 * Each layer is made of 2 lines for each color, see frame() for
+	 * the corner pixels.
+	 */
+	while (len-- && (w > 0) && (h > 0))
+	{
+		if (inner)
+		{
+			rects[n] = Rectangle(x, y, x, y + h);
+			rcolors[n++] = colors[1];
+			rects[n] = Rectangle(x, y, x + w - 1, y);
+			rcolors[n++] = colors[1];
+			rects[n] = Rectangle(x + 1, y + h, x + w, y + h);
+			rcolors[n++] = colors[0];
+			rects[n] = Rectangle(x + w, y, x + w, y + h);
+			rcolors[n++] = colors[0];
+		}
+		else
+		{
+			rects[n] = Rectangle(x, y, x + w, y);
+			rcolors[n++] = colors[0];
+			rects[n] = Rectangle(x, y, x, y + h - 1);
+			rcolors[n++] = colors[0];
+			rects[n] = Rectangle(x, y + h, x + w, y + h);
+			rcolors[n++] = colors[1];
+			rects[n] = Rectangle(x + w, y + 1, x + w, y + h);
+			rcolors[n++] = colors[1];
+		}
+
+		x++;
+		y++;
+		w -= 2;
+		h -= 2;
+	}
+
+	return n;
+}
+
+int ViewRender::rectangleRects(const Rectangle &rect, int len, uint32_t color, Rectangle *rects, uint32_t *rcolors)
+{
+	int x = rect.ul.x;
+	int y = rect.ul.y;
+	int w = rect.width();
+	int h = rect.height();
+	int n = 0;
+
+	while (len-- && (w > 0) && (h > 0))
+	{
+		rects[n++] = Rectangle(x, y, x + w - 1, y);
+		rects[n++] = Rectangle(x, y + h - 1, x + w - 1, y + h - 1);
+		if (h > 2)
+		{
+			rects[n++] = Rectangle(x, y + 1, x, y + h - 2);
+			rects[n++] = Rectangle(x + w - 1, y + 1, x + w - 1, y + h - 2);
+		}
+
+		x++;
+		y++;
+		w -= 2;
+		h -= 2;
+	}
+
+	if (rcolors)
+	{
+		for (int i = 0; i < n; i++)
+			rcolors[i] = color;
+	}
+
+	return n;
+}
+
+void ViewRender::loadBMPAsync(const char *name, View *requester, BitmapCallback callback)
+{
+	if (!requester)
+		return;
+
+	void *bmp = loadBMP(name);
+
+	if (callback)
+		callback(bmp);
+	notifyBMPReady(requester);
+}
+
+void ViewRender::postBMPReady(View *root)
+{
+	Event evt;
+	MessageEvent cmd = {CMD_UPDATE, 0, this, root, root, {0, 0, 0, 0}};
+
+	// Queued by the root view, it does not walk the tree
+	evt.setMessageEvent(cmd);
+	root->postEvent(&evt);
+}
+
+void ViewRender::notifyBMPReady(View *requester)
+{
+	Event evt;
+	MessageEvent cmd = {CMD_UPDATE, 0, this, requester, requester, {0, 0, 0, 0}};
+
+	// Delivered at once, as the group running the event loop would do
+	evt.setMessageEvent(cmd);
+	requester->getTopView()->handleEvent(&evt);
+}
\ No newline at end of file
@@ -21,8 +21,17 @@
 #define _VIEWRENDER_H_
 
 #include <cstdint>
+#include <functional>
 #include "geometry.h"
 
+class View;
+
+/*
+ * Receives a bitmap loaded by ViewRender::loadBMPAsync(), nullptr if it
+ * could not be loaded.
+ */
+typedef std::function<void(void *bmp)> BitmapCallback;
+
 /*
  * ViewRender is merely an interface; actual implementations are declared elsehere
  * and MUST be retrieved invoking the ViewRenderFactory object get() method.
@@ -117,6 +126,35 @@ public:
 	 *                     first color is applied to the border, second color is used to fill the rectangle.
 	 */
 	virtual void frame(const Rectangle &rect, int len, uint32_t colors[2], bool inner) = 0;
+	/*
+	 * Fill n rectangles with the specified color in a single operation.
+	 *
+	 * PARAMETER IN
+	 *  const Rectangle *rects - array of n rectangles
+	 *  int n - number of rectangles
+	 *  uint32_t color - the color to be used (bit depth depends on the renderer)
+	 */
+	virtual void fillRects(const Rectangle *rects, int n, uint32_t color) = 0;
+	/*
+	 * Fill n rectangles, each one with its own color, in a single operation.
+	 * Rectangles are filled in order, later rectangles cover earlier ones.
+	 *
+	 * PARAMETER IN
+	 *  const Rectangle *rects - array of n rectangles
+	 *  int n - number of rectangles
+	 *  const uint32_t *colors - array of n colors, colors[i] is used for rects[i]
+	 */
+	virtual void fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors) = 0;
+	/*
+	 * Trace a polyline joining n points with the specified color in a single operation.
+	 * n points trace n - 1 lines.
+	 *
+	 * PARAMETER IN
+	 *  const Point *points - array of n points
+	 *  int n - number of points
+	 *  uint32_t color - the color to be used (bit depth depends on the renderer)
+	 */
+	virtual void lines(const Point *points, int n, uint32_t color) = 0;
 	/*
 	 * Write the specified text using the coordinates stored in rect with the specified color.
 	 * The rectangle is filled in height and width with respect to the font size and aspect ratio.
@@ -153,6 +191,36 @@ public:
 	virtual void *loadBMP(const char *name) = 0;
 	virtual bool unloadBMP(void *bmp) = 0;
 	virtual void drawBMP(void *bmp, const Rectangle &rect) = 0;
+	/*
+	 * Load a bitmap without blocking the thread running the event loop.
+	 * The file is decoded in background; when it is ready the thread
+	 * running the event loop uploads it with completeBMPAsync(), invokes
+	 * callback with it and sends a CMD_UPDATE message to requester. The
+	 * bitmap is then released with unloadBMP(), as the ones returned by
+	 * loadBMP().
+	 * The default implementation loads the bitmap at once, invokes
+	 * callback and sends the message before returning.
+	 * requester MUST be in a group running the event loop, nothing is
+	 * loaded without it.
+	 *
+	 * PARAMETER IN
+	 *  const char *name - the bitmap file
+	 *  View *requester - the view notified
+	 *  BitmapCallback callback - receives the bitmap, can be empty
+	 */
+	virtual void loadBMPAsync(const char *name, View *requester, BitmapCallback callback);
+	/*
+	 * Upload the bitmaps decoded in background, invoke their callbacks
+	 * and notify their views.
+	 * It is called by the thread running the event loop when the renderer
+	 * wakes it up, see ViewExec.
+	 */
+	virtual void completeBMPAsync(void) {}
+	/*
+	 * Forget the requests of a view, no message nor callback will follow.
+	 * It is called by the View destructor.
+	 */
+	virtual void cancelBMPAsync(View * /*requester*/) {}
 	/*
 	 * Start rendering phase. This method need to be called before drawing to buffers.
 	 */
@@ -162,6 +230,17 @@ public:
 	 * and writes directly to video memory.
 	 */
 	virtual void show(void) = 0;
+	/*
+	 * Show on screen the video buffer with the outline of a rectangle traced on top of it.
+	 * The outline is not stored in the video buffer, the next call to show() or showOutline()
+	 * removes it; this is meant to trace views being moved or resized without composing
+	 * a new frame.
+	 *
+	 * PARAMETER IN
+	 *  Rectangle &rect - reference to the rectangle on screen
+	 *  uint32_t color - the color to be used (bit depth depends on the renderer)
+	 */
+	virtual void showOutline(const Rectangle &rect, uint32_t color) = 0;
 	/*
 	 * Clear the screen using the specified color.
 	 *
@@ -219,10 +298,77 @@ public:
 	 * Rectangle &vidmem - reference to a rectangle describing the area to be copied (inside the video memory).
 	 */
 	virtual void writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem) = 0;
+	/*
+	 * Restrict writing to the video memory to the area described by clip.
+	 * Only writeBuffer() and clear() are affected, drawing to buffers is not clipped.
+	 * The video memory outside the clipping area retains the contents of the
+	 * previous frame, so that a damaged area can be recomposed without redrawing
+	 * the whole screen.
+	 * If the function is invoked passing NULL as parameter, clipping is removed.
+	 *
+	 * PARAMETER IN
+	 * const Rectangle *clip - the clipping area in screen coordinates, or NULL.
+	 */
+	virtual void setClipping(const Rectangle *clip) = 0;
+
+	/*
+	 * Build the rectangles tracing a frame, with the same pixels and colors
+	 * frame() would draw, to be used with fillRectsColored().
+	 * 4 rectangles are stored for each of the len layers.
+	 *
+	 * PARAMETER IN
+	 *  Rectangle &rect - reference to the rectangle on screen
+	 *  int len - number of layers
+	 *  uint32_t colors[] - the colors of the frame, see frame()
+	 *  bool inner - the drawing schema, see frame()
+	 *
+	 * PARAMETER OUT
+	 *  Rectangle *rects - the rectangles, room for 4 * len items is required
+	 *  uint32_t *rcolors - the color of each rectangle
+	 *
+	 * RETURN
+	 * the number of rectangles stored
+	 */
+	static int frameRects(const Rectangle &rect, int len, const uint32_t colors[2], bool inner, Rectangle *rects, uint32_t *rcolors);
+	/*
+	 * Build the rectangles tracing a rectangle of len pixels, with the same pixels
+	 * rectangle() would draw, to be used with fillRects() or fillRectsColored().
+	 * 4 rectangles are stored for each of the len layers.
+	 *
+	 * PARAMETER IN
+	 *  Rectangle &rect - reference to the rectangle on screen
+	 *  int len - number of layers
+	 *  uint32_t color - the color of the rectangle
+	 *
+	 * PARAMETER OUT
+	 *  Rectangle *rects - the rectangles, room for 4 * len items is required
+	 *  uint32_t *rcolors - the color of each rectangle, can be nullptr
+	 *
+	 * RETURN
+	 * the number of rectangles stored
+	 */
+	static int rectangleRects(const Rectangle &rect, int len, uint32_t color, Rectangle *rects, uint32_t *rcolors);
+
+	inline int getXRes(void) const { return xres; }
+	inline int getYRes(void) const { return yres; }
+	inline int getBitDepth(void) const { return bitDepth; }
 
 protected:
 	ViewRender(int xres, int yres, int bitdepth) : xres(xres), yres(yres), bitDepth(bitdepth) {}
 
+	/*
+	 * Wake up the event loop run by root, from any thread: a CMD_UPDATE
+	 * message sent to root makes ViewExec call completeBMPAsync().
+	 */
+	void postBMPReady(View *root);
+
+	/*
+	 * Send the CMD_UPDATE message of loadBMPAsync() to requester, it is
+	 * handled before returning.
+	 * Only the thread running the event loop can call it.
+	 */
+	void notifyBMPReady(View *requester);
+
 	int xres, yres, bitDepth;
 };
 
@@ -0,0 +1,757 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <iostream>
+#include "viewrendercapture.h"
+#include "rendercommandlist.h"
+
+ViewRenderCapture::ViewRenderCapture(ViewRender *target, const char *path) : ViewRender(target->getXRes(), target->getYRes(), target->getBitDepth()),
+									     target(target), file(nullptr), self(std::make_shared<ViewRenderCapture *>(this)),
+									     nextBuffer(1), nextBitmap(1), nextString(0)
+{
+	file = fopen(path, "wb");
+	if (!file)
+	{
+		std::cout << "Capture file " << path << " could not be created!" << std::endl;
+		return;
+	}
+
+	fwrite(CAPTURE_MAGIC, 1, 4, file);
+	putUnsigned(CAPTURE_VERSION);
+	putUnsigned(xres);
+	putUnsigned(yres);
+	putUnsigned(bitDepth);
+}
+
+ViewRenderCapture::~ViewRenderCapture()
+{
+	if (file)
+		fclose(file);
+}
+
+void ViewRenderCapture::putOp(unsigned op)
+{
+	if (file)
+		fputc(op, file);
+}
+
+void ViewRenderCapture::putUnsigned(uint32_t value)
+{
+	if (!file)
+		return;
+
+	while (value >= 0x80)
+	{
+		fputc((value & 0x7F) | 0x80, file);
+		value >>= 7;
+	}
+	fputc(value, file);
+}
+
+void ViewRenderCapture::putSigned(int32_t value)
+{
+	putUnsigned(((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+void ViewRenderCapture::putPoint(const Point &point)
+{
+	putSigned(point.x);
+	putSigned(point.y);
+}
+
+void ViewRenderCapture::putRect(const Rectangle &rect)
+{
+	putPoint(rect.ul);
+	putPoint(rect.lr);
+}
+
+uint32_t ViewRenderCapture::bufferIndex(const void *buffer)
+{
+	if (!buffer)
+		return 0;
+
+	auto it = buffers.find(buffer);
+	if (it != buffers.end())
+		return it->second;
+
+	uint32_t index = nextBuffer++;
+	buffers[buffer] = index;
+	putOp(CAP_CREATE_BUFFER);
+	putUnsigned(index);
+	putRect(Rectangle(0, 0, xres - 1, yres - 1));
+	return index;
+}
+
+uint32_t ViewRenderCapture::stringIndex(const char *text)
+{
+	std::string key(text);
+	auto it = strings.find(key);
+	if (it != strings.end())
+		return it->second;
+
+	uint32_t index = nextString++;
+	strings[key] = index;
+	putOp(CAP_STRING);
+	putUnsigned(index);
+	putUnsigned(key.size());
+	if (file)
+		fwrite(key.data(), 1, key.size(), file);
+	return index;
+}
+
+uint32_t ViewRenderCapture::stringIndex(const uint16_t *text)
+{
+	std::u16string key;
+	while (*text)
+		key.push_back(*text++);
+
+	auto it = ustrings.find(key);
+	if (it != ustrings.end())
+		return it->second;
+
+	uint32_t index = nextString++;
+	ustrings[key] = index;
+	putOp(CAP_STRING_UNICODE);
+	putUnsigned(index);
+	putUnsigned(key.size());
+	for (char16_t c : key)
+		putUnsigned(c);
+	return index;
+}
+
+void ViewRenderCapture::line(const Point &a, const Point &b, uint32_t color)
+{
+	putOp(RCMD_LINE);
+	putPoint(a);
+	putPoint(b);
+	putUnsigned(color);
+	target->line(a, b, color);
+}
+
+void ViewRenderCapture::hline(const Point &a, int len, uint32_t color)
+{
+	putOp(RCMD_HLINE);
+	putPoint(a);
+	putSigned(len);
+	putUnsigned(color);
+	target->hline(a, len, color);
+}
+
+void ViewRenderCapture::vline(const Point &a, int len, uint32_t color)
+{
+	putOp(RCMD_VLINE);
+	putPoint(a);
+	putSigned(len);
+	putUnsigned(color);
+	target->vline(a, len, color);
+}
+
+void ViewRenderCapture::rectangle(const Rectangle &rect, int len, uint32_t color)
+{
+	putOp(RCMD_RECTANGLE);
+	putRect(rect);
+	putSigned(len);
+	putUnsigned(color);
+	target->rectangle(rect, len, color);
+}
+
+void ViewRenderCapture::filledRectangle(const Rectangle &rect, uint32_t color)
+{
+	putOp(RCMD_FILLED_RECTANGLE);
+	putRect(rect);
+	putUnsigned(color);
+	target->filledRectangle(rect, color);
+}
+
+void ViewRenderCapture::filledRectangle2(const Rectangle &rect, uint32_t colors[2])
+{
+	putOp(RCMD_FILLED_RECTANGLE2);
+	putRect(rect);
+	putUnsigned(colors[0]);
+	putUnsigned(colors[1]);
+	target->filledRectangle2(rect, colors);
+}
+
+void ViewRenderCapture::frame(const Rectangle &rect, int len, uint32_t colors[2], bool inner)
+{
+	putOp(RCMD_FRAME);
+	putRect(rect);
+	putSigned(len);
+	putUnsigned(colors[0]);
+	putUnsigned(colors[1]);
+	putUnsigned(inner);
+	target->frame(rect, len, colors, inner);
+}
+
+void ViewRenderCapture::fillRects(const Rectangle *rects, int n, uint32_t color)
+{
+	if (n > 0)
+	{
+		putOp(RCMD_FILL_RECTS);
+		putUnsigned(n);
+		for (int i = 0; i < n; i++)
+			putRect(rects[i]);
+		putUnsigned(color);
+	}
+	target->fillRects(rects, n, color);
+}
+
+void ViewRenderCapture::fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors)
+{
+	if (n > 0)
+	{
+		putOp(RCMD_FILL_RECTS_COLORED);
+		putUnsigned(n);
+		for (int i = 0; i < n; i++)
+		{
+			putRect(rects[i]);
+			putUnsigned(colors[i]);
+		}
+	}
+	target->fillRectsColored(rects, n, colors);
+}
+
+void ViewRenderCapture::lines(const Point *points, int n, uint32_t color)
+{
+	if (n > 0)
+	{
+		putOp(RCMD_LINES);
+		putUnsigned(n);
+		for (int i = 0; i < n; i++)
+			putPoint(points[i]);
+		putUnsigned(color);
+	}
+	target->lines(points, n, color);
+}
+
+void ViewRenderCapture::textBox(const char *text, Rectangle &out)
+{
+	target->textBox(text, out);
+}
+
+void ViewRenderCapture::text(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const char *text)
+{
+	if (text)
+	{
+		uint32_t index = stringIndex(text);
+		putOp(RCMD_TEXT);
+		putRect(rect);
+		putUnsigned(fcolor);
+		putUnsigned(bcolor);
+		putUnsigned(index);
+	}
+	target->text(rect, fcolor, bcolor, text);
+}
+
+void ViewRenderCapture::textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const uint16_t *text)
+{
+	if (text)
+	{
+		uint32_t index = stringIndex(text);
+		putOp(RCMD_TEXT_UNICODE);
+		putRect(rect);
+		putUnsigned(fcolor);
+		putUnsigned(bcolor);
+		putUnsigned(index);
+	}
+	target->textUNICODE(rect, fcolor, bcolor, text);
+}
+
+void ViewRenderCapture::putLoadBMP(void *bmp, const char *name)
+{
+	if (bmp && name)
+	{
+		uint32_t index = stringIndex(name);
+		bitmaps[bmp] = nextBitmap;
+		putOp(CAP_LOAD_BMP);
+		putUnsigned(nextBitmap++);
+		putUnsigned(index);
+	}
+}
+
+void *ViewRenderCapture::loadBMP(const char *name)
+{
+	void *bmp = target->loadBMP(name);
+
+	putLoadBMP(bmp, name);
+	return bmp;
+}
+
+bool ViewRenderCapture::unloadBMP(void *bmp)
+{
+	auto it = bitmaps.find(bmp);
+	if (it != bitmaps.end())
+	{
+		putOp(CAP_UNLOAD_BMP);
+		putUnsigned(it->second);
+		bitmaps.erase(it);
+	}
+
+	return target->unloadBMP(bmp);
+}
+
+void ViewRenderCapture::drawBMP(void *bmp, const Rectangle &rect)
+{
+	auto it = bitmaps.find(bmp);
+	if (it != bitmaps.end())
+	{
+		putOp(RCMD_DRAW_BMP);
+		putUnsigned(it->second);
+		putRect(rect);
+	}
+	target->drawBMP(bmp, rect);
+}
+
+void ViewRenderCapture::loadBMPAsync(const char *name, View *requester, BitmapCallback callback)
+{
+	std::weak_ptr<ViewRenderCapture *> capture = self;
+	std::string path = (name) ? name : "";
+
+	// The load is captured when the bitmap is delivered, if still capturing
+	target->loadBMPAsync(name, requester, [capture, path, callback](void *bmp)
+			     {
+		std::shared_ptr<ViewRenderCapture *> c = capture.lock();
+		if (c)
+			(*c)->putLoadBMP(bmp, path.c_str());
+		if (callback)
+			callback(bmp); });
+}
+
+void ViewRenderCapture::completeBMPAsync(void)
+{
+	target->completeBMPAsync();
+}
+
+void ViewRenderCapture::cancelBMPAsync(View *requester)
+{
+	target->cancelBMPAsync(requester);
+}
+
+void ViewRenderCapture::start(void)
+{
+	putOp(RCMD_START);
+	target->start();
+}
+
+void ViewRenderCapture::show(void)
+{
+	putOp(CAP_SHOW);
+	target->show();
+}
+
+void ViewRenderCapture::showOutline(const Rectangle &rect, uint32_t color)
+{
+	putOp(CAP_SHOW_OUTLINE);
+	putRect(rect);
+	putUnsigned(color);
+	target->showOutline(rect, color);
+}
+
+void ViewRenderCapture::clear(uint32_t color)
+{
+	putOp(RCMD_CLEAR);
+	putUnsigned(color);
+	target->clear(color);
+}
+
+void *ViewRenderCapture::createBuffer(const Rectangle &rect)
+{
+	void *buffer = target->createBuffer(rect);
+
+	if (buffer)
+	{
+		buffers[buffer] = nextBuffer;
+		putOp(CAP_CREATE_BUFFER);
+		putUnsigned(nextBuffer++);
+		putRect(rect);
+	}
+
+	return buffer;
+}
+
+void ViewRenderCapture::releaseBuffer(const void *buffer)
+{
+	auto it = buffers.find(buffer);
+	if (it != buffers.end())
+	{
+		putOp(CAP_RELEASE_BUFFER);
+		putUnsigned(it->second);
+		buffers.erase(it);
+	}
+	target->releaseBuffer(buffer);
+}
+
+void ViewRenderCapture::setBuffer(const void *buffer)
+{
+	uint32_t index = bufferIndex(buffer);
+	putOp(RCMD_SET_BUFFER);
+	putUnsigned(index);
+	target->setBuffer(buffer);
+}
+
+void ViewRenderCapture::writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem)
+{
+	uint32_t index = bufferIndex(buffer);
+	putOp(RCMD_WRITE_BUFFER);
+	putUnsigned(index);
+	putRect(rect);
+	putRect(vidmem);
+	target->writeBuffer(buffer, rect, vidmem);
+}
+
+void ViewRenderCapture::setClipping(const Rectangle *clip)
+{
+	putOp(RCMD_SET_CLIPPING);
+	putUnsigned(clip != nullptr);
+	if (clip)
+		putRect(*clip);
+	target->setClipping(clip);
+}
+
+RenderCapturePlayer::RenderCapturePlayer() : file(nullptr), size(0), xres(0), yres(0), bitDepth(0), records(0)
+{
+}
+
+RenderCapturePlayer::~RenderCapturePlayer()
+{
+	if (file)
+		fclose(file);
+}
+
+bool RenderCapturePlayer::open(const char *path)
+{
+	char magic[4];
+	uint32_t version, x, y, depth;
+
+	file = fopen(path, "rb");
+	if (!file)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if ((fread(magic, 1, 4, file) != 4) || memcmp(magic, CAPTURE_MAGIC, 4) ||
+	    !getUnsigned(version) || (version != CAPTURE_VERSION) ||
+	    !getUnsigned(x) || !getUnsigned(y) || !getUnsigned(depth))
+	{
+		fclose(file);
+		file = nullptr;
+		return false;
+	}
+
+	xres = x;
+	yres = y;
+	bitDepth = depth;
+	return true;
+}
+
+bool RenderCapturePlayer::getUnsigned(uint32_t &value)
+{
+	int c, shift = 0;
+
+	value = 0;
+	do
+	{
+		c = fgetc(file);
+		if ((c == EOF) || (shift > 28))
+			return false;
+
+		value |= (uint32_t)(c & 0x7F) << shift;
+		shift += 7;
+	} while (c & 0x80);
+
+	return true;
+}
+
+/*
+ * Check that n items, each encoded in bytes at least, can be in the rest
+ * of the file: the counts read from a damaged capture are not allocated.
+ */
+bool RenderCapturePlayer::fits(uint32_t n, unsigned bytes)
+{
+	long pos = ftell(file);
+
+	return (pos >= 0) && (pos <= size) && ((uint64_t)n * bytes <= (uint64_t)(size - pos));
+}
+
+bool RenderCapturePlayer::getSigned(int32_t &value)
+{
+	uint32_t u;
+
+	if (!getUnsigned(u))
+		return false;
+
+	value = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+	return true;
+}
+
+bool RenderCapturePlayer::getPoint(Point &point)
+{
+	int32_t x, y;
+
+	if (!getSigned(x) || !getSigned(y))
+		return false;
+
+	point.x = x;
+	point.y = y;
+	return true;
+}
+
+bool RenderCapturePlayer::getRect(Rectangle &rect)
+{
+	return getPoint(rect.ul) && getPoint(rect.lr);
+}
+
+bool RenderCapturePlayer::playFrame(ViewRender *r)
+{
+	int op;
+
+	records = 0;
+	if (!file)
+		return false;
+
+	while ((op = fgetc(file)) != EOF)
+	{
+		if (!play(r, op))
+		{
+			std::cout << "Capture damaged, record " << op << " at offset " << ftell(file) << std::endl;
+			return false;
+		}
+
+		records++;
+		if (op == CAP_SHOW)
+			return true;
+	}
+
+	return false;
+}
+
+bool RenderCapturePlayer::play(ViewRender *r, int op)
+{
+	Rectangle rect, rect2;
+	Point a, b;
+	int32_t len;
+	uint32_t color, colors[2], index, n;
+
+	switch (op)
+	{
+	case RCMD_LINE:
+		if (!getPoint(a) || !getPoint(b) || !getUnsigned(color))
+			return false;
+		r->line(a, b, color);
+		break;
+	case RCMD_HLINE:
+	case RCMD_VLINE:
+		if (!getPoint(a) || !getSigned(len) || !getUnsigned(color))
+			return false;
+		if (op == RCMD_HLINE)
+			r->hline(a, len, color);
+		else
+			r->vline(a, len, color);
+		break;
+	case RCMD_RECTANGLE:
+		if (!getRect(rect) || !getSigned(len) || !getUnsigned(color))
+			return false;
+		r->rectangle(rect, len, color);
+		break;
+	case RCMD_FILLED_RECTANGLE:
+		if (!getRect(rect) || !getUnsigned(color))
+			return false;
+		r->filledRectangle(rect, color);
+		break;
+	case RCMD_FILLED_RECTANGLE2:
+		if (!getRect(rect) || !getUnsigned(colors[0]) || !getUnsigned(colors[1]))
+			return false;
+		r->filledRectangle2(rect, colors);
+		break;
+	case RCMD_FRAME:
+		if (!getRect(rect) || !getSigned(len) || !getUnsigned(colors[0]) ||
+		    !getUnsigned(colors[1]) || !getUnsigned(n))
+			return false;
+		r->frame(rect, len, colors, n != 0);
+		break;
+	case RCMD_FILL_RECTS:
+	case RCMD_FILL_RECTS_COLORED:
+	{
+		// A rectangle is 4 bytes at least
+		if (!getUnsigned(n) || !fits(n, 4))
+			return false;
+
+		Rectangle *rects = new Rectangle[n];
+		uint32_t *rcolors = new uint32_t[n];
+		bool valid = true;
+		for (uint32_t i = 0; valid && (i < n); i++)
+		{
+			valid = getRect(rects[i]);
+			if (valid && (op == RCMD_FILL_RECTS_COLORED))
+				valid = getUnsigned(rcolors[i]);
+		}
+		if (valid && (op == RCMD_FILL_RECTS))
+		{
+			valid = getUnsigned(color);
+			if (valid)
+				r->fillRects(rects, n, color);
+		}
+		else if (valid)
+			r->fillRectsColored(rects, n, rcolors);
+
+		delete[] rects;
+		delete[] rcolors;
+		return valid;
+	}
+	case RCMD_LINES:
+	{
+		// A point is 2 bytes at least
+		if (!getUnsigned(n) || !fits(n, 2))
+			return false;
+
+		Point *points = new Point[n];
+		bool valid = true;
+		for (uint32_t i = 0; valid && (i < n); i++)
+			valid = getPoint(points[i]);
+		if (valid)
+			valid = getUnsigned(color);
+		if (valid)
+			r->lines(points, n, color);
+
+		delete[] points;
+		return valid;
+	}
+	case RCMD_TEXT:
+		if (!getRect(rect) || !getUnsigned(colors[0]) || !getUnsigned(colors[1]) || !getUnsigned(index))
+			return false;
+		r->text(rect, colors[0], colors[1], strings[index].c_str());
+		break;
+	case RCMD_TEXT_UNICODE:
+		if (!getRect(rect) || !getUnsigned(colors[0]) || !getUnsigned(colors[1]) || !getUnsigned(index))
+			return false;
+		r->textUNICODE(rect, colors[0], colors[1], reinterpret_cast<const uint16_t *>(ustrings[index].c_str()));
+		break;
+	case RCMD_DRAW_BMP:
+		if (!getUnsigned(index) || !getRect(rect))
+			return false;
+		r->drawBMP(bitmaps[index], rect);
+		break;
+	case RCMD_START:
+		r->start();
+		break;
+	case RCMD_CLEAR:
+		if (!getUnsigned(color))
+			return false;
+		r->clear(color);
+		break;
+	case RCMD_SET_BUFFER:
+		if (!getUnsigned(index))
+			return false;
+		r->setBuffer((index) ? buffers[index] : nullptr);
+		break;
+	case RCMD_WRITE_BUFFER:
+		if (!getUnsigned(index) || !getRect(rect) || !getRect(rect2))
+			return false;
+		r->writeBuffer((index) ? buffers[index] : nullptr, rect, rect2);
+		break;
+	case RCMD_SET_CLIPPING:
+		if (!getUnsigned(n) || (n && !getRect(rect)))
+			return false;
+		r->setClipping((n) ? &rect : nullptr);
+		break;
+	case CAP_SHOW:
+		r->show();
+		break;
+	case CAP_SHOW_OUTLINE:
+		if (!getRect(rect) || !getUnsigned(color))
+			return false;
+		r->showOutline(rect, color);
+		break;
+	case CAP_CREATE_BUFFER:
+		// Index 0 is the video memory, a live index would leak its buffer
+		if (!getUnsigned(index) || !getRect(rect) || !index || buffers.count(index))
+			return false;
+		buffers[index] = r->createBuffer(rect);
+		break;
+	case CAP_RELEASE_BUFFER:
+		if (!getUnsigned(index))
+			return false;
+		r->releaseBuffer(buffers[index]);
+		buffers.erase(index);
+		break;
+	case CAP_LOAD_BMP:
+		if (!getUnsigned(index) || !getUnsigned(n) || !index || bitmaps.count(index))
+			return false;
+		bitmaps[index] = r->loadBMP(strings[n].c_str());
+		break;
+	case CAP_UNLOAD_BMP:
+		if (!getUnsigned(index))
+			return false;
+		r->unloadBMP(bitmaps[index]);
+		bitmaps.erase(index);
+		break;
+	case CAP_STRING:
+	{
+		if (!getUnsigned(index) || !getUnsigned(n) || !fits(n, 1))
+			return false;
+
+		std::string text(n, '\0');
+		if (n && (fread(&text[0], 1, n, file) != n))
+			return false;
+		strings[index] = text;
+		break;
+	}
+	case CAP_STRING_UNICODE:
+	{
+		if (!getUnsigned(index) || !getUnsigned(n))
+			return false;
+
+		std::u16string text;
+		for (uint32_t i = 0; i < n; i++)
+		{
+			if (!getUnsigned(color))
+				return false;
+			text.push_back(color);
+		}
+		ustrings[index] = text;
+		break;
+	}
+	default:
+		return false;
+	}
+
+	return true;
+}
+
+void RenderCapturePlayer::close(ViewRender *r)
+{
+	for (auto &buffer : buffers)
+		r->releaseBuffer(buffer.second);
+	for (auto &bitmap : bitmaps)
+		r->unloadBMP(bitmap.second);
+
+	buffers.clear();
+	bitmaps.clear();
+	strings.clear();
+	ustrings.clear();
+
+	if (file)
+	{
+		fclose(file);
+		file = nullptr;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VIEWRENDERCAPTURE_H_
+#define _VIEWRENDERCAPTURE_H_
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "viewrender.h"
+
+/*
+ * Capture file layout.
+ * The file starts with the CAPTURE_MAGIC bytes followed by the version,
+ * the resolution and the bit depth; then records follow, each one made of
+ * an operation code byte and its parameters.
+ * Integers are stored as LEB128 variable length values, signed values
+ * (coordinates and lengths) are zigzag encoded first.
+ * Strings are sent once in a string record and then referred by index;
+ * buffers and bitmaps are referred by index as well, index 0 is the
+ * video memory (no buffer).
+ * Drawing records use the RenderOp codes, see rendercommandlist.h.
+ */
+#define CAPTURE_MAGIC "DGRC"
+#define CAPTURE_VERSION 1
+
+enum CaptureOp
+{
+	CAP_SHOW = 64,
+	CAP_SHOW_OUTLINE,
+	CAP_CREATE_BUFFER,
+	CAP_RELEASE_BUFFER,
+	CAP_LOAD_BMP,
+	CAP_UNLOAD_BMP,
+	CAP_STRING,
+	CAP_STRING_UNICODE
+};
+
+/*
+ * ViewRenderCapture forwards all calls to a renderer and writes them to
+ * a capture file, to be played back later by RenderCapturePlayer
+ * (see the render_replay tool).
+ */
+class ViewRenderCapture : public ViewRender
+{
+public:
+	/*
+	 * PARAMETERS IN
+	 * ViewRender *target - the renderer receiving the calls, it is not
+	 *                      owned by the capture
+	 * const char *path - the capture file, it is overwritten
+	 */
+	ViewRenderCapture(ViewRender *target, const char *path);
+	virtual ~ViewRenderCapture();
+	virtual void line(const Point &a, const Point &b, uint32_t color) override;
+	virtual void hline(const Point &a, int len, uint32_t color) override;
+	virtual void vline(const Point &a, int len, uint32_t color) override;
+	virtual void rectangle(const Rectangle &rect, int len, uint32_t color) override;
+	virtual void filledRectangle(const Rectangle &rect, uint32_t color) override;
+	virtual void filledRectangle2(const Rectangle &rect, uint32_t colors[2]) override;
+	virtual void frame(const Rectangle &rect, int len, uint32_t colors[2], bool inner) override;
+	virtual void fillRects(const Rectangle *rects, int n, uint32_t color) override;
+	virtual void fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors) override;
+	virtual void lines(const Point *points, int n, uint32_t color) override;
+	virtual void textBox(const char *text, Rectangle &out) override;
+	virtual void text(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const char *text) override;
+	virtual void textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const uint16_t *text) override;
+	virtual void *loadBMP(const char *name) override;
+	virtual bool unloadBMP(void *bmp) override;
+	virtual void drawBMP(void *bmp, const Rectangle &rect) override;
+	virtual void loadBMPAsync(const char *name, View *requester, BitmapCallback callback) override;
+	virtual void completeBMPAsync(void) override;
+	virtual void cancelBMPAsync(View *requester) override;
+	virtual void start(void) override;
+	virtual void show(void) override;
+	virtual void showOutline(const Rectangle &rect, uint32_t color) override;
+	virtual void clear(uint32_t color) override;
+	virtual void *createBuffer(const Rectangle &rect) override;
+	virtual void releaseBuffer(const void *buffer) override;
+	virtual void setBuffer(const void *buffer) override;
+	virtual void writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem) override;
+	virtual void setClipping(const Rectangle *clip) override;
+
+	inline ViewRender *getTarget(void) { return target; }
+
+	/*
+	 * RETURN
+	 * true if the capture file could be created
+	 */
+	inline bool isOpen(void) const { return (file != nullptr); }
+
+private:
+	void putOp(unsigned op);
+	void putUnsigned(uint32_t value);
+	void putSigned(int32_t value);
+	void putPoint(const Point &point);
+	void putRect(const Rectangle &rect);
+	void putLoadBMP(void *bmp, const char *name);
+	/*
+	 * Get the index of a buffer, buffers created before the capture
+	 * started are declared with the size of the screen.
+	 */
+	uint32_t bufferIndex(const void *buffer);
+	uint32_t stringIndex(const char *text);
+	uint32_t stringIndex(const uint16_t *text);
+
+	ViewRender *target;
+	FILE *file;
+	// Referred weakly by the callbacks of loadBMPAsync(), they can outlive the capture
+	std::shared_ptr<ViewRenderCapture *> self;
+	std::unordered_map<const void *, uint32_t> buffers;
+	std::unordered_map<const void *, uint32_t> bitmaps;
+	std::unordered_map<std::string, uint32_t> strings;
+	std::unordered_map<std::u16string, uint32_t> ustrings;
+	uint32_t nextBuffer, nextBitmap, nextString;
+};
+
+/*
+ * RenderCapturePlayer reads a capture file and plays it on a renderer,
+ * one frame at a time.
+ */
+class RenderCapturePlayer
+{
+public:
+	RenderCapturePlayer();
+	~RenderCapturePlayer();
+
+	/*
+	 * Open a capture file and read its header.
+	 *
+	 * PARAMETERS IN
+	 * const char *path - the capture file
+	 *
+	 * RETURN
+	 * true if the file is a valid capture
+	 */
+	bool open(const char *path);
+
+	/*
+	 * Play the records up to the next show(), included.
+	 *
+	 * PARAMETERS IN
+	 * ViewRender *r - the renderer
+	 *
+	 * RETURN
+	 * true if a frame was played, false at the end of the capture or
+	 * if the capture is damaged
+	 */
+	bool playFrame(ViewRender *r);
+
+	/*
+	 * Release the buffers and bitmaps still allocated on r and close the file.
+	 *
+	 * PARAMETERS IN
+	 * ViewRender *r - the renderer the capture was played on
+	 */
+	void close(ViewRender *r);
+
+	inline int getXRes(void) const { return xres; }
+	inline int getYRes(void) const { return yres; }
+	inline int getBitDepth(void) const { return bitDepth; }
+
+	/*
+	 * RETURN
+	 * the number of records played by the last playFrame()
+	 */
+	inline unsigned getFrameRecords(void) const { return records; }
+
+private:
+	RenderCapturePlayer(const RenderCapturePlayer &other) = delete;
+	RenderCapturePlayer &operator=(const RenderCapturePlayer &other) = delete;
+
+	bool getUnsigned(uint32_t &value);
+	bool getSigned(int32_t &value);
+	bool getPoint(Point &point);
+	bool getRect(Rectangle &rect);
+	bool fits(uint32_t n, unsigned bytes);
+	bool play(ViewRender *r, int op);
+
+	FILE *file;
+	// Size of the capture file
+	long size;
+	int xres, yres, bitDepth;
+	unsigned records;
+	std::unordered_map<uint32_t, void *> buffers;
+	std::unordered_map<uint32_t, void *> bitmaps;
+	std::unordered_map<uint32_t, std::string> strings;
+	std::unordered_map<uint32_t, std::u16string> ustrings;
+};
+
+#endif
\ No newline at end of file
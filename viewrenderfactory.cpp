@@ -19,16 +19,52 @@
 
 #include "viewrenderfactory.h"
 #include "viewrenderhw.h"
+#include "viewrendersw.h"
+#include "viewrenderlut.h"
+#include "viewrendervga.h"
+#include "viewrendertext.h"
 
 class ViewRender *ViewRenderFactory::create(enum ViewRenderType sel, int xres, int yres, int bitdepth)
 {
 	switch (sel)
 	{
 	case VRENDER_VGA:
+		// Always 16 colors, the bit depth does not matter
+		return new ViewRenderVGA(xres, yres);
 	case VRENDER_VESA:
+		switch (bitdepth)
+		{
+		case 32:
+			return new ViewRenderSW<PixelARGB8888>(xres, yres, bitdepth);
+		case 24:
+			return new ViewRenderSW<PixelRGB888>(xres, yres, bitdepth);
+		case 16:
+			return new ViewRenderSW<PixelRGB565>(xres, yres, bitdepth);
+		case 8:
+			// 8 bits colors are indexed colors, see PALETTE_INDEXED_DEPTH
+			return new ViewRenderLUT<PixelIndexed8>(xres, yres);
+		default:
+			break;
+		}
 		break;
 	case VRENDER_HW:
 		return new ViewRenderHW(xres, yres, bitdepth);
+	case VRENDER_LUT:
+		// The bit depth is the one of the video memory
+		switch (bitdepth)
+		{
+		case 32:
+			return new ViewRenderLUT<PixelARGB8888>(xres, yres);
+		case 24:
+			return new ViewRenderLUT<PixelRGB888>(xres, yres);
+		case 16:
+			return new ViewRenderLUT<PixelRGB565>(xres, yres);
+		default:
+			break;
+		}
+		break;
+	case VRENDER_TEXT:
+		return new ViewRenderText(xres, yres);
 	default:
 		break;
 	}
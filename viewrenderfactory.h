@@ -26,7 +26,11 @@ enum ViewRenderType
 {
 	VRENDER_VGA,
 	VRENDER_VESA,
-	VRENDER_HW
+	VRENDER_HW,
+	// Software renderer drawing indexed colors, see viewrenderlut.h
+	VRENDER_LUT,
+	// Character cells, see viewrendertext.h
+	VRENDER_TEXT
 };
 
 class ViewRenderFactory
@@ -18,10 +18,23 @@
  */
 
 #include <SDL2/SDL.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include "viewrenderhw.h"
+#include "view.h"
 #include "color_utils.h"
+#include "builtinfont.h"
+#include "fontcache.h"
+#include "assetpack.h"
 #include "SDL_ttf.h"
 
 static inline void to_SDL_Point(const Point &point, SDL_Point &spoint)
@@ -46,6 +59,13 @@ inline void to_SDL_Color(const uint32_t ARGB, SDL_Color *clr)
 	clr->a = (ARGB >> 24) & 0xFF;
 }
 
+// Maximum number of primitives sent to the renderer in a single call
+#define BATCH_SIZE 64
+
+// The font of the text
+#define FONT_FILE "C:\\windows\\fonts\\segoeui.ttf"
+#define FONT_SIZE 14
+
 // The window we'll be rendering to
 static SDL_Window *window = NULL;
 // The renderer
@@ -54,6 +74,275 @@ static SDL_Renderer *renderer = NULL;
 static Uint32 textureFormat = 0;
 // The font
 static TTF_Font *font = NULL;
+static bool fontOpened = false;
+/*
+ * The glyphs of the font found in the font cache, or the builtin font if
+ * no TTF font is available; the glyphs are uploaded to a texture.
+ */
+static FontCache fontCache;
+static BitmapFont cachedFont;
+static const BitmapFont *bitmapFont = &builtinFont;
+static SDL_Texture *fontAtlas = NULL;
+// Bitmaps in the format of the renderer, see packassets.cpp
+static AssetPack assets;
+
+/*
+ * Bitmaps are shared: a file loaded again, synchronously or not, gets the
+ * same texture, destroyed when the last user unloads it.
+ */
+struct CachedBitmap
+{
+	SDL_Texture *texture;
+	int refs;
+};
+static std::unordered_map<std::string, CachedBitmap> bitmaps;
+static std::unordered_map<SDL_Texture *, std::string> bitmapNames;
+
+/*
+ * A file loaded in background and the views waiting for it, one job for
+ * each file. The worker fills decoded and moves the job to doneJobs, the
+ * thread running the event loop uploads it, notifies the views still
+ * waiting and deletes the job.
+ */
+struct BitmapWaiter
+{
+	View *requester;
+	BitmapCallback callback;
+};
+
+struct BitmapJob
+{
+	std::string name;
+	std::vector<BitmapWaiter> waiters;
+	SDL_Surface *decoded;
+	// The file is decoded by the worker, else it is cached or packed
+	bool decode;
+	bool done;
+};
+
+/*
+ * The jobs and the worker decoding them, created by the first request.
+ * It is not a set of statics: the worker must not be running when they
+ * are destroyed at exit.
+ */
+struct BitmapLoader
+{
+	std::mutex lock;
+	std::condition_variable queued;
+	std::unordered_map<std::string, BitmapJob *> jobs;
+	std::deque<BitmapJob *> decodeQueue;
+	std::deque<BitmapJob *> doneJobs;
+	// The view running the event loop, woken up when jobs are done
+	View *root;
+	// The view whose callback is running, cleared if it is cancelled
+	View *notifying;
+	std::thread worker;
+	bool quit = false;
+};
+static BitmapLoader *loader = NULL;
+
+static int atlasCellWidth, atlasCellHeight;
+// The video buffer, it retains the last composed frame
+static SDL_Texture *screen = NULL;
+// The clipping area applied to the video buffer
+static Rectangle clipping;
+static bool clipped = false;
+
+/*
+ * Shadow copies of the renderer state, SDL is called only when
+ * the state is really going to change.
+ */
+static uint32_t drawColor;
+static bool drawColorValid = false;
+static SDL_Texture *target = NULL;
+static bool targetValid = false;
+static SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+static bool blendModeValid = false;
+static ViewRenderHW::StateCounters counters;
+
+static void setDrawColor(uint32_t color)
+{
+	if (drawColorValid && (drawColor == color))
+	{
+		counters.colorSkipped++;
+		return;
+	}
+
+	union ARGBColor c;
+	toARGBColor(color, &c);
+	SDL_SetRenderDrawColor(renderer, c.colorARGB.r, c.colorARGB.g, c.colorARGB.b, SDL_ALPHA_OPAQUE);
+	drawColor = color;
+	drawColorValid = true;
+	counters.colorIssued++;
+}
+
+static bool setTarget(SDL_Texture *texture)
+{
+	if (targetValid && (target == texture))
+	{
+		counters.targetSkipped++;
+		return true;
+	}
+
+	counters.targetIssued++;
+	if (SDL_SetRenderTarget(renderer, texture))
+	{
+		targetValid = false;
+		return false;
+	}
+
+	target = texture;
+	targetValid = true;
+	return true;
+}
+
+static void setBlendMode(SDL_BlendMode mode)
+{
+	if (blendModeValid && (blendMode == mode))
+	{
+		counters.blendSkipped++;
+		return;
+	}
+
+	SDL_SetRenderDrawBlendMode(renderer, mode);
+	blendMode = mode;
+	blendModeValid = true;
+	counters.blendIssued++;
+}
+
+// Glyphs in a row of the font atlas
+#define ATLAS_COLUMNS 64
+
+/*
+ * Upload the glyphs of bitmapFont to a texture, white with the coverage in
+ * the alpha channel: the text color is applied with the color modulation.
+ * Glyph n is in the cell n of a grid of ATLAS_COLUMNS columns.
+ */
+static bool createFontAtlas(void)
+{
+	const BitmapFont &f = *bitmapFont;
+
+	atlasCellWidth = atlasCellHeight = 1;
+	for (int i = 0; i < f.numGlyphs; i++)
+	{
+		atlasCellWidth = std::max(atlasCellWidth, (int)f.glyphs[i].width);
+		atlasCellHeight = std::max(atlasCellHeight, (int)f.glyphs[i].height);
+	}
+
+	int w = atlasCellWidth * std::min((int)f.numGlyphs, ATLAS_COLUMNS);
+	int h = atlasCellHeight * ((f.numGlyphs + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS);
+	uint32_t *pixels = new uint32_t[w * h]();
+
+	for (int i = 0; i < f.numGlyphs; i++)
+	{
+		const BitmapGlyph &g = f.glyphs[i];
+		const uint8_t *bits = f.bits + g.offset;
+		uint32_t *cell = pixels + (i / ATLAS_COLUMNS) * atlasCellHeight * w + (i % ATLAS_COLUMNS) * atlasCellWidth;
+
+		for (int y = 0; y < g.height; y++, bits += f.stride(g))
+			for (int x = 0; x < g.width; x++)
+			{
+				uint32_t alpha = (f.bitsPerPixel == BITMAP_FONT_MONO) ? ((bits[x >> 3] & (0x80 >> (x & 7))) ? 0xFF : 0) : bits[x];
+				cell[y * w + x] = (alpha << 24) | 0x00FFFFFF;
+			}
+	}
+
+	fontAtlas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, w, h);
+	if (fontAtlas)
+	{
+		SDL_UpdateTexture(fontAtlas, NULL, pixels, w * sizeof(uint32_t));
+		SDL_SetTextureBlendMode(fontAtlas, SDL_BLENDMODE_BLEND);
+	}
+	else
+		std::cout << "Font atlas could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+
+	delete[] pixels;
+	return fontAtlas != NULL;
+}
+
+/*
+ * Draw text with bitmapFont, laid out as the SW renderers do: the
+ * background fills rect, the line is centered vertically and starts at
+ * the left side; the glyphs out of rect are clipped.
+ */
+template <class T>
+static void bitmapText(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const T *text)
+{
+	const BitmapFont &f = *bitmapFont;
+	SDL_Rect srect;
+
+	to_SDL_Rect(rect, srect);
+	setDrawColor(bcolor);
+	SDL_RenderFillRect(renderer, &srect);
+
+	if (!fontAtlas && !createFontAtlas())
+		return;
+
+	union ARGBColor c;
+	toARGBColor(fcolor, &c);
+	SDL_SetTextureColorMod(fontAtlas, c.colorARGB.r, c.colorARGB.g, c.colorARGB.b);
+
+	int penX = rect.ul.x;
+	int baseline = rect.ul.y + (rect.height() - f.height) / 2 + f.ascent;
+	for (; *text && (penX <= rect.lr.x); text++)
+	{
+		const BitmapGlyph &g = f.find(static_cast<typename std::make_unsigned<T>::type>(*text));
+		int index = (int)(&g - f.glyphs);
+		SDL_Rect src = {(index % ATLAS_COLUMNS) * atlasCellWidth, (index / ATLAS_COLUMNS) * atlasCellHeight, g.width, g.height};
+		SDL_Rect dst = {penX + g.left, baseline - g.top, g.width, g.height};
+
+		penX += g.advance;
+
+		// Clip the glyph to rect
+		int left = std::max(rect.ul.x - dst.x, 0);
+		int top = std::max(rect.ul.y - dst.y, 0);
+		src.x += left;
+		src.y += top;
+		dst.x += left;
+		dst.y += top;
+		dst.w = src.w = std::min(g.width - left, rect.lr.x - dst.x + 1);
+		dst.h = src.h = std::min(g.height - top, rect.lr.y - dst.y + 1);
+		if ((dst.w > 0) && (dst.h > 0))
+			SDL_RenderCopy(renderer, fontAtlas, &src, &dst);
+	}
+}
+
+/*
+ * Open the TTF font, once. With a font cache the font engine is started
+ * only when a text has characters not in the cache.
+ */
+static void openFont(void)
+{
+	if (fontOpened)
+		return;
+
+	fontOpened = true;
+	if (TTF_Init())
+	{
+		std::cout << "Font could not be inited! SDL_Error: " << TTF_GetError() << std::endl;
+	}
+
+	font = TTF_OpenFont(FONT_FILE, FONT_SIZE);
+	if (!font)
+	{
+		std::cout << "Font could not be loaded! SDL_Error: " << TTF_GetError() << std::endl;
+		std::cout << "Text is drawn with a bitmap font" << std::endl;
+	}
+}
+
+/*
+ * Check if a text is drawn with bitmapFont: the cached glyphs are used
+ * when they cover the text, the builtin font when the TTF font is missing.
+ */
+template <class T>
+static bool useBitmapFont(const T *text)
+{
+	if ((bitmapFont == &cachedFont) && cachedFont.covers(text))
+		return true;
+
+	openFont();
+	return font == NULL;
+}
 
 ViewRenderHW::ViewRenderHW(int xres, int yres, int bitdepth) : ViewRender(xres, yres, bitdepth)
 {
@@ -128,23 +417,57 @@ ViewRenderHW::ViewRenderHW(int xres, int yres, int bitdepth) : ViewRender(xres,
 		std::cout << std::endl;
 	}
 
-	// Initialize Font
-	if (TTF_Init())
+	screen = SDL_CreateTexture(renderer, textureFormat, SDL_TEXTUREACCESS_TARGET, xres, yres);
+	if (screen == NULL)
 	{
-		std::cout << "Font could not be inited! SDL_Error: " << TTF_GetError() << std::endl;
+		std::cout << "Video buffer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
 	}
 
-	font = TTF_OpenFont("C:\\windows\\fonts\\segoeui.ttf", 14);
-	if (!font)
+	// Pre-rasterized glyphs spare the font engine at start up, see fontbake.cpp
+	if (fontCache.open(FONTCACHE_FILE) && fontCache.find(FONT_FILE, FONT_SIZE, cachedFont))
+		bitmapFont = &cachedFont;
+	else
+		openFont();
+
+	if (assets.open(ASSETPACK_FILE) && (assets.getPixelFormat() != textureFormat))
 	{
-		std::cout << "Font could not be loaded! SDL_Error: " << TTF_GetError() << std::endl;
+		std::cout << "The asset pack holds " << SDL_GetPixelFormatName(assets.getPixelFormat())
+			  << " bitmaps, they are converted when loaded" << std::endl;
 	}
 
+	setBlendMode(SDL_BLENDMODE_NONE);
 	SDL_RenderClear(renderer);
 }
 
 ViewRenderHW::~ViewRenderHW()
 {
+	if (loader)
+	{
+		{
+			std::lock_guard<std::mutex> lock(loader->lock);
+			loader->quit = true;
+		}
+		loader->queued.notify_all();
+		loader->worker.join();
+
+		for (auto &j : loader->jobs)
+		{
+			if (j.second->decoded)
+				SDL_FreeSurface(j.second->decoded);
+			delete j.second;
+		}
+		delete loader;
+		loader = NULL;
+	}
+	// The textures are destroyed with the renderer
+	bitmaps.clear();
+	bitmapNames.clear();
+
+	if (screen)
+		SDL_DestroyTexture(screen);
+	if (fontAtlas)
+		SDL_DestroyTexture(fontAtlas);
+
 	if (renderer && window)
 	{
 		SDL_DestroyRenderer(renderer);
@@ -156,6 +479,13 @@ ViewRenderHW::~ViewRenderHW()
 	renderer = NULL;
 	window = NULL;
 	font = NULL;
+	fontOpened = false;
+	fontAtlas = NULL;
+	fontCache.close();
+	bitmapFont = &builtinFont;
+	assets.close();
+	screen = NULL;
+	drawColorValid = targetValid = blendModeValid = false;
 
 	if (TTF_WasInit())
 		TTF_Quit();
@@ -165,136 +495,177 @@ ViewRenderHW::~ViewRenderHW()
 
 void ViewRenderHW::line(const Point &a, const Point &b, uint32_t color)
 {
-	union ARGBColor c;
-	toARGBColor(color, &c);
-	SDL_SetRenderDrawColor(renderer, c.colorARGB.r, c.colorARGB.g, c.colorARGB.b, SDL_ALPHA_OPAQUE);
+	setDrawColor(color);
 	SDL_RenderDrawLine(renderer, a.x, a.y, b.x, b.y);
 }
 
 void ViewRenderHW::hline(const Point &a, int len, uint32_t color)
 {
-	union ARGBColor c;
-	toARGBColor(color, &c);
-	SDL_SetRenderDrawColor(renderer, c.colorARGB.r, c.colorARGB.g, c.colorARGB.b, SDL_ALPHA_OPAQUE);
+	setDrawColor(color);
 	SDL_RenderDrawLine(renderer, a.x, a.y, a.x + len, a.y);
 }
 
 void ViewRenderHW::vline(const Point &a, int len, uint32_t color)
 {
-	union ARGBColor c;
-	toARGBColor(color, &c);
-	SDL_SetRenderDrawColor(renderer, c.colorARGB.r, c.colorARGB.g, c.colorARGB.b, SDL_ALPHA_OPAQUE);
+	setDrawColor(color);
 	SDL_RenderDrawLine(renderer, a.x, a.y, a.x, a.y + len);
 }
 
 void ViewRenderHW::rectangle(const Rectangle &rect, int len, uint32_t color)
 {
-	union ARGBColor c;
-	toARGBColor(color, &c);
-	SDL_Rect srect;
-	to_SDL_Rect(rect, srect);
-	SDL_SetRenderDrawColor(renderer, c.colorARGB.r, c.colorARGB.g, c.colorARGB.b, SDL_ALPHA_OPAQUE);
-	while (len--)
+	Rectangle rects[BATCH_SIZE];
+	Rectangle layer;
+	layer = rect;
+
+	/*
+	 * All the layers are sent to the renderer in a single batch,
+	 * BATCH_SIZE / 4 layers at a time.
+	 */
+	while (len > 0)
 	{
-		SDL_RenderDrawRect(renderer, &srect);
-		++srect.x;
-		++srect.y;
-		srect.w -= 2;
-		srect.h -= 2;
+		int layers = (len > BATCH_SIZE / 4) ? BATCH_SIZE / 4 : len;
+		int n = rectangleRects(layer, layers, color, rects, nullptr);
+		if (n == 0)
+			break;
+		fillRects(rects, n, color);
+		len -= layers;
+		layer.ul.x += layers;
+		layer.ul.y += layers;
+		layer.lr.x -= layers;
+		layer.lr.y -= layers;
 	}
 }
 
 void ViewRenderHW::filledRectangle(const Rectangle &rect, uint32_t color)
 {
-	union ARGBColor c;
-	toARGBColor(color, &c);
 	SDL_Rect srect;
 	to_SDL_Rect(rect, srect);
-	SDL_SetRenderDrawColor(renderer, c.colorARGB.r, c.colorARGB.g, c.colorARGB.b, SDL_ALPHA_OPAQUE);
+	setDrawColor(color);
 	SDL_RenderFillRect(renderer, &srect);
 }
 
 void ViewRenderHW::filledRectangle2(const Rectangle &rect, uint32_t colors[2])
 {
-	union ARGBColor c[2];
-	toARGBColor(colors[0], &c[0]);
-	toARGBColor(colors[1], &c[1]);
 	SDL_Rect srect;
 	to_SDL_Rect(rect, srect);
-	SDL_SetRenderDrawColor(renderer, c[0].colorARGB.r, c[0].colorARGB.g, c[0].colorARGB.b, SDL_ALPHA_OPAQUE);
+	setDrawColor(colors[0]);
 	SDL_RenderDrawRect(renderer, &srect);
 	srect.x++;
 	srect.y++;
 	srect.w -= 2;
 	srect.h -= 2;
-	SDL_SetRenderDrawColor(renderer, c[1].colorARGB.r, c[1].colorARGB.g, c[1].colorARGB.b, SDL_ALPHA_OPAQUE);
+	setDrawColor(colors[1]);
 	SDL_RenderFillRect(renderer, &srect);
 }
 
 void ViewRenderHW::frame(const Rectangle &rect, int len, uint32_t colors[2], bool inner)
 {
-	union ARGBColor c[2];
-	toARGBColor(colors[0], &c[0]);
-	toARGBColor(colors[1], &c[1]);
-	SDL_Point spoint[6];
-	SDL_Rect srect;
-	to_SDL_Rect(rect, srect);
-	srect.w -= 1;
-	srect.h -= 1;
+	Rectangle rects[BATCH_SIZE];
+	uint32_t rcolors[BATCH_SIZE];
+	Rectangle layer;
+	layer = rect;
 
-	if (inner)
+	while (len > 0)
 	{
-		while (len--)
-		{
-			spoint[1].x = srect.x;
-			spoint[1].y = srect.y;
-			spoint[2].x = spoint[1].x + srect.w - 1;
-			spoint[2].y = spoint[1].y;
-			spoint[0].x = spoint[1].x;
-			spoint[0].y = spoint[1].y + srect.h;
-			spoint[3].x = spoint[0].x + 1;
-			spoint[3].y = spoint[0].y;
-			spoint[4].x = spoint[1].x + srect.w;
-			spoint[4].y = spoint[1].y + srect.h;
-			spoint[5].x = spoint[2].x + 1;
-			spoint[5].y = spoint[2].y;
-
-			SDL_SetRenderDrawColor(renderer, c[1].colorARGB.r, c[1].colorARGB.g, c[1].colorARGB.b, SDL_ALPHA_OPAQUE);
-			SDL_RenderDrawLines(renderer, spoint, 3);
-			SDL_SetRenderDrawColor(renderer, c[0].colorARGB.r, c[0].colorARGB.g, c[0].colorARGB.b, SDL_ALPHA_OPAQUE);
-			SDL_RenderDrawLines(renderer, spoint + 3, 3);
-			srect.x++;
-			srect.y++;
-			srect.w -= 2;
-			srect.h -= 2;
-		}
+		int layers = (len > BATCH_SIZE / 4) ? BATCH_SIZE / 4 : len;
+		int n = frameRects(layer, layers, colors, inner, rects, rcolors);
+		if (n == 0)
+			break;
+		fillRectsColored(rects, n, rcolors);
+		len -= layers;
+		layer.ul.x += layers;
+		layer.ul.y += layers;
+		layer.lr.x -= layers;
+		layer.lr.y -= layers;
 	}
-	else
+}
+
+void ViewRenderHW::fillRects(const Rectangle *rects, int n, uint32_t color)
+{
+	SDL_Rect srects[BATCH_SIZE];
+	setDrawColor(color);
+
+	while (n > 0)
+	{
+		int count = (n > BATCH_SIZE) ? BATCH_SIZE : n;
+		for (int i = 0; i < count; i++)
+			to_SDL_Rect(rects[i], srects[i]);
+		SDL_RenderFillRects(renderer, srects, count);
+		rects += count;
+		n -= count;
+	}
+}
+
+void ViewRenderHW::fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors)
+{
+	/*
+	 * Every rectangle becomes 2 triangles sharing 4 vertices, so that
+	 * rectangles with different colors are sent in a single call.
+	 */
+	SDL_Vertex vertices[BATCH_SIZE * 4];
+	int indices[BATCH_SIZE * 6];
+
+	while (n > 0)
 	{
-		while (len--)
+		int count = (n > BATCH_SIZE) ? BATCH_SIZE : n;
+		for (int i = 0; i < count; i++)
 		{
-			spoint[1].x = srect.x;
-			spoint[1].y = srect.y;
-			spoint[2].x = spoint[1].x + srect.w;
-			spoint[2].y = spoint[1].y;
-			spoint[0].x = spoint[1].x;
-			spoint[0].y = spoint[1].y + srect.h - 1;
-			spoint[3].x = spoint[0].x;
-			spoint[3].y = spoint[0].y + 1;
-			spoint[4].x = spoint[1].x + srect.w;
-			spoint[4].y = spoint[1].y + srect.h;
-			spoint[5].x = spoint[2].x;
-			spoint[5].y = spoint[2].y + 1;
-
-			SDL_SetRenderDrawColor(renderer, c[0].colorARGB.r, c[0].colorARGB.g, c[0].colorARGB.b, SDL_ALPHA_OPAQUE);
-			SDL_RenderDrawLines(renderer, spoint, 3);
-			SDL_SetRenderDrawColor(renderer, c[1].colorARGB.r, c[1].colorARGB.g, c[1].colorARGB.b, SDL_ALPHA_OPAQUE);
-			SDL_RenderDrawLines(renderer, spoint + 3, 3);
-			srect.x++;
-			srect.y++;
-			srect.w -= 2;
-			srect.h -= 2;
+			union ARGBColor c;
+			toARGBColor(colors[i], &c);
+			SDL_Color clr = { c.colorARGB.r, c.colorARGB.g, c.colorARGB.b, SDL_ALPHA_OPAQUE };
+			float x0 = rects[i].ul.x;
+			float y0 = rects[i].ul.y;
+			float x1 = rects[i].lr.x + 1;
+			float y1 = rects[i].lr.y + 1;
+			SDL_Vertex *v = &vertices[i * 4];
+			int *idx = &indices[i * 6];
+
+			v[0].position.x = x0;
+			v[0].position.y = y0;
+			v[1].position.x = x1;
+			v[1].position.y = y0;
+			v[2].position.x = x1;
+			v[2].position.y = y1;
+			v[3].position.x = x0;
+			v[3].position.y = y1;
+			for (int k = 0; k < 4; k++)
+			{
+				v[k].color = clr;
+				v[k].tex_coord.x = 0;
+				v[k].tex_coord.y = 0;
+			}
+
+			idx[0] = i * 4;
+			idx[1] = i * 4 + 1;
+			idx[2] = i * 4 + 2;
+			idx[3] = i * 4;
+			idx[4] = i * 4 + 2;
+			idx[5] = i * 4 + 3;
 		}
+		SDL_RenderGeometry(renderer, NULL, vertices, count * 4, indices, count * 6);
+		rects += count;
+		colors += count;
+		n -= count;
+	}
+}
+
+void ViewRenderHW::lines(const Point *points, int n, uint32_t color)
+{
+	SDL_Point spoints[BATCH_SIZE];
+	setDrawColor(color);
+
+	/*
+	 * Consecutive chunks share their boundary point so that the
+	 * polyline is not broken.
+	 */
+	while (n > 1)
+	{
+		int count = (n > BATCH_SIZE) ? BATCH_SIZE : n;
+		for (int i = 0; i < count; i++)
+			to_SDL_Point(points[i], spoints[i]);
+		SDL_RenderDrawLines(renderer, spoints, count);
+		points += count - 1;
+		n -= count - 1;
 	}
 }
 
@@ -303,7 +674,16 @@ void ViewRenderHW::textBox(const char *text, Rectangle &out)
 	int w, h;
 
 	out.ul.x = out.ul.y = 0;
-	if (!text || TTF_SizeText(font, text, &w, &h))
+	if (!text)
+	{
+		out.lr.x = out.lr.y = 0;
+	}
+	else if (useBitmapFont(text))
+	{
+		out.lr.x = bitmapFont->measure(text);
+		out.lr.y = bitmapFont->height;
+	}
+	else if (TTF_SizeText(font, text, &w, &h))
 	{
 		out.lr.x = out.lr.y = 0;
 	}
@@ -319,6 +699,12 @@ void ViewRenderHW::text(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor,
 	if (!text)
 		return;
 
+	if (useBitmapFont(text))
+	{
+		bitmapText(rect, fcolor, bcolor, text);
+		return;
+	}
+
 	SDL_Rect srect;
 	SDL_Color f, b;
 	to_SDL_Rect(rect, srect);
@@ -337,6 +723,12 @@ void ViewRenderHW::textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t
 	if (!text)
 		return;
 
+	if (useBitmapFont(text))
+	{
+		bitmapText(rect, fcolor, bcolor, text);
+		return;
+	}
+
 	SDL_Rect srect;
 	SDL_Color f, b;
 	to_SDL_Rect(rect, srect);
@@ -350,29 +742,248 @@ void ViewRenderHW::textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t
 	SDL_DestroyTexture(message);
 }
 
+/*
+ * Upload a bitmap of the asset pack: the texture is filled straight from
+ * the file mapping.
+ */
+static SDL_Texture *loadPackedBMP(const AssetPackEntry *entry)
+{
+	Uint32 format = assets.getPixelFormat();
+
+	if (entry->pitch < entry->width * SDL_BYTESPERPIXEL(format))
+		return NULL;
+
+	SDL_Texture *bmp = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STATIC, entry->width, entry->height);
+	if (!bmp)
+		return NULL;
+
+	if (SDL_UpdateTexture(bmp, NULL, assets.getPixels(entry), entry->pitch))
+	{
+		SDL_DestroyTexture(bmp);
+		return NULL;
+	}
+
+	SDL_SetTextureBlendMode(bmp, SDL_ISPIXELFORMAT_ALPHA(format) ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+	return bmp;
+}
+
+/*
+ * Take a reference to a bitmap, loading it if it is not cached: from the
+ * asset pack, from the surface decoded in background or, if load is true,
+ * from the file.
+ */
+static SDL_Texture *acquireBitmap(const std::string &name, SDL_Surface *&decoded, bool load)
+{
+	auto it = bitmaps.find(name);
+	if (it != bitmaps.end())
+	{
+		it->second.refs++;
+		return it->second.texture;
+	}
+
+	SDL_Texture *bmp = NULL;
+	const AssetPackEntry *entry = assets.find(name.c_str());
+	if (entry)
+		bmp = loadPackedBMP(entry);
+
+	if (!bmp)
+	{
+		SDL_Surface *surf = (decoded) ? decoded : ((load) ? SDL_LoadBMP(name.c_str()) : NULL);
+		decoded = NULL;
+		if (surf)
+		{
+			bmp = SDL_CreateTextureFromSurface(renderer, surf);
+			SDL_FreeSurface(surf);
+		}
+	}
+
+	if (bmp)
+	{
+		bitmaps[name] = {bmp, 1};
+		bitmapNames[bmp] = name;
+	}
+
+	return bmp;
+}
+
 void *ViewRenderHW::loadBMP(const char *name)
 {
-	SDL_Surface *surf = SDL_LoadBMP(name);
-	if (!surf)
-		return nullptr;
+	SDL_Surface *decoded = NULL;
 
-	SDL_Texture *bmp = SDL_CreateTextureFromSurface(renderer, surf);
-	SDL_FreeSurface(surf);
+	if (!name)
+		return nullptr;
 
-	return static_cast<void *>(bmp);
+	return static_cast<void *>(acquireBitmap(name, decoded, true));
 }
 
 bool ViewRenderHW::unloadBMP(void *bmp)
 {
 	SDL_Texture *mybmp = reinterpret_cast<SDL_Texture *>(bmp);
 
-	if (mybmp)
+	auto name = bitmapNames.find(mybmp);
+	if (!mybmp || (name == bitmapNames.end()))
+		return false;
+
+	auto cached = bitmaps.find(name->second);
+	if (--cached->second.refs == 0)
 	{
 		SDL_DestroyTexture(mybmp);
-		return true;
+		bitmaps.erase(cached);
+		bitmapNames.erase(name);
 	}
 
-	return false;
+	return true;
+}
+
+void ViewRenderHW::loadBMPAsync(const char *name, View *requester, BitmapCallback callback)
+{
+	BitmapJob *job;
+
+	if (!name || !requester)
+		return;
+
+	View *root = requester->getTopView();
+
+	if (!loader)
+	{
+		loader = new BitmapLoader;
+		loader->root = root;
+		loader->notifying = nullptr;
+		loader->worker = std::thread(&ViewRenderHW::decodeBMPs, this);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(loader->lock);
+
+		loader->root = root;
+		auto it = loader->jobs.find(name);
+		if (it != loader->jobs.end())
+		{
+			// Already loading, the file is decoded once
+			job = it->second;
+		}
+		else
+		{
+			job = new BitmapJob;
+			job->name = name;
+			job->decoded = NULL;
+			job->decode = (bitmaps.find(job->name) == bitmaps.end()) && !assets.find(name);
+			job->done = !job->decode;
+			loader->jobs[job->name] = job;
+
+			if (job->done)
+				loader->doneJobs.push_back(job);
+			else
+			{
+				loader->decodeQueue.push_back(job);
+				loader->queued.notify_one();
+			}
+		}
+
+		job->waiters.push_back({requester, callback});
+		if (!job->done)
+			return;
+	}
+
+	postBMPReady(root);
+}
+
+void ViewRenderHW::decodeBMPs()
+{
+	std::unique_lock<std::mutex> lock(loader->lock);
+
+	for (;;)
+	{
+		loader->queued.wait(lock, []
+				    { return loader->quit || !loader->decodeQueue.empty(); });
+		if (loader->quit)
+			break;
+
+		BitmapJob *job = loader->decodeQueue.front();
+		loader->decodeQueue.pop_front();
+
+		// Decoding touches no renderer state, the event loop goes on meanwhile
+		lock.unlock();
+		SDL_Surface *surf = SDL_LoadBMP(job->name.c_str());
+		lock.lock();
+
+		job->decoded = surf;
+		job->done = true;
+		loader->doneJobs.push_back(job);
+
+		// The views are found by the event loop, they can be gone meanwhile
+		if (loader->root)
+			postBMPReady(loader->root);
+	}
+}
+
+void ViewRenderHW::completeBMPAsync()
+{
+	if (!loader)
+		return;
+
+	/*
+	 * One view at a time: callbacks and views can cancel the requests of
+	 * other views, and ask for more bitmaps.
+	 */
+	for (;;)
+	{
+		BitmapJob *job;
+		BitmapWaiter waiter;
+
+		{
+			std::lock_guard<std::mutex> lock(loader->lock);
+
+			if (loader->doneJobs.empty())
+				break;
+
+			job = loader->doneJobs.front();
+			if (job->waiters.empty())
+			{
+				loader->doneJobs.pop_front();
+				loader->jobs.erase(job->name);
+				if (job->decoded)
+					SDL_FreeSurface(job->decoded);
+				delete job;
+				continue;
+			}
+
+			waiter = job->waiters.front();
+			job->waiters.erase(job->waiters.begin());
+			loader->notifying = waiter.requester;
+		}
+
+		// Each view takes a reference, a failed decoding is not retried
+		SDL_Texture *bmp = acquireBitmap(job->name, job->decoded, !job->decode);
+		if (waiter.callback)
+			waiter.callback(static_cast<void *>(bmp));
+
+		// Unless the callback deleted the view
+		if (loader->notifying)
+			notifyBMPReady(waiter.requester);
+		loader->notifying = nullptr;
+	}
+}
+
+void ViewRenderHW::cancelBMPAsync(View *requester)
+{
+	if (!loader)
+		return;
+
+	std::lock_guard<std::mutex> lock(loader->lock);
+
+	if (loader->notifying == requester)
+		loader->notifying = nullptr;
+	if (loader->root == requester)
+		loader->root = nullptr;
+
+	for (auto &j : loader->jobs)
+	{
+		std::vector<BitmapWaiter> &w = j.second->waiters;
+		w.erase(std::remove_if(w.begin(), w.end(), [requester](const BitmapWaiter &b)
+				       { return b.requester == requester; }),
+			w.end());
+	}
 }
 
 void ViewRenderHW::drawBMP(void *bmp, const Rectangle &rect)
@@ -389,30 +1000,60 @@ void ViewRenderHW::drawBMP(void *bmp, const Rectangle &rect)
 
 void ViewRenderHW::start()
 {
-	if (SDL_SetRenderTarget(renderer, NULL))
+	if (!setTarget(screen))
 		std::cout << __FUNCSIG__ << " Renderer error!  SDL_Error: " << SDL_GetError() << std::endl;
-	SDL_RenderClear(renderer);
+	/*
+	 * If clipping is active the video buffer retains the previous frame,
+	 * only the clipped area is going to be recomposed.
+	 */
+	if (!clipped)
+		SDL_RenderClear(renderer);
 }
 
 void ViewRenderHW::show()
 {
 	// Update the surface
-	if (SDL_SetRenderTarget(renderer, NULL))
+	if (!setTarget(NULL))
 		std::cout << __FUNCSIG__ << " Renderer error!  SDL_Error: " << SDL_GetError() << std::endl;
 
+	SDL_RenderCopy(renderer, screen, NULL, NULL);
+	SDL_RenderPresent(renderer);
+}
+
+void ViewRenderHW::showOutline(const Rectangle &rect, uint32_t color)
+{
+	SDL_Rect srect;
+	to_SDL_Rect(rect, srect);
+
+	if (!setTarget(NULL))
+		std::cout << __FUNCSIG__ << " Renderer error!  SDL_Error: " << SDL_GetError() << std::endl;
+
+	/*
+	 * The outline goes to the back buffer only, the video buffer
+	 * is left untouched.
+	 */
+	SDL_RenderCopy(renderer, screen, NULL, NULL);
+	setDrawColor(color);
+	SDL_RenderDrawRect(renderer, &srect);
+	++srect.x;
+	++srect.y;
+	srect.w -= 2;
+	srect.h -= 2;
+	SDL_RenderDrawRect(renderer, &srect);
 	SDL_RenderPresent(renderer);
 }
 
 void ViewRenderHW::clear(uint32_t color)
 {
-	union ARGBColor c;
-	toARGBColor(color, &c);
-	SDL_SetRenderDrawColor(renderer,
-			       c.colorARGB.r,
-			       c.colorARGB.g,
-			       c.colorARGB.b,
-			       SDL_ALPHA_OPAQUE);
-	SDL_RenderClear(renderer);
+	setDrawColor(color);
+	if (clipped)
+	{
+		SDL_Rect srect;
+		to_SDL_Rect(clipping, srect);
+		SDL_RenderFillRect(renderer, &srect);
+	}
+	else
+		SDL_RenderClear(renderer);
 }
 
 void *ViewRenderHW::createBuffer(const Rectangle &rect)
@@ -442,15 +1083,17 @@ void *ViewRenderHW::createBuffer(const Rectangle &rect)
 void ViewRenderHW::releaseBuffer(const void *buffer)
 {
 	if (buffer)
+	{
+		// A new buffer could be created at the same address
+		if (target == (SDL_Texture *)buffer)
+			targetValid = false;
 		SDL_DestroyTexture((SDL_Texture *)buffer);
+	}
 }
 
 void ViewRenderHW::setBuffer(const void *buffer)
 {
-	if (buffer == nullptr)
-		std::cout << __FUNCSIG__ << std::endl;
-
-	if (SDL_SetRenderTarget(renderer, (SDL_Texture *)buffer))
+	if (!setTarget((buffer) ? (SDL_Texture *)buffer : screen))
 		std::cout << __FUNCSIG__ << " Renderer error!  SDL_Error: " << SDL_GetError() << std::endl;
 }
 
@@ -461,12 +1104,54 @@ void ViewRenderHW::writeBuffer(const void *buffer, const Rectangle &rect, const
 	SDL_Rect vrect;
 	to_SDL_Rect(vidmem, vrect);
 
+	if (clipped)
+	{
+		Rectangle dest;
+		dest = vidmem;
+
+		if (!dest.intersect(clipping))
+			return;
+
+		/*
+		 * Buffers are copied 1:1, shrink the source rectangle
+		 * by the same amount the destination was clipped.
+		 */
+		dest.intersection(clipping);
+		srect.x += dest.ul.x - vidmem.ul.x;
+		srect.y += dest.ul.y - vidmem.ul.y;
+		srect.w = vrect.w = dest.width();
+		srect.h = vrect.h = dest.height();
+		vrect.x = dest.ul.x;
+		vrect.y = dest.ul.y;
+	}
+
 	if (buffer)
 	{
-		if (SDL_SetRenderTarget(renderer, NULL))
+		if (!setTarget(screen))
 			std::cout << __FUNCSIG__ << " Renderer error " << std::hex << buffer << std::dec << "!  SDL_Error: " << SDL_GetError() << std::endl;
 
 		if (SDL_RenderCopy(renderer, (SDL_Texture *)buffer, &srect, &vrect))
 			std::cout << __FUNCSIG__ << " Renderer error " << std::hex << buffer << std::dec << "!  SDL_Error: " << SDL_GetError() << std::endl;
 	}
+}
+
+void ViewRenderHW::setClipping(const Rectangle *clip)
+{
+	if (clip)
+	{
+		clipping = *clip;
+		clipped = true;
+	}
+	else
+		clipped = false;
+}
+
+void ViewRenderHW::getStateCounters(StateCounters &out)
+{
+	out = counters;
+}
+
+void ViewRenderHW::resetStateCounters(void)
+{
+	counters = StateCounters();
 }
\ No newline at end of file
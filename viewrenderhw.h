@@ -22,9 +22,23 @@
 
 #include "viewrender.h"
 
-class ViewRenderHW : public ViewRender
+class ViewRenderHW final : public ViewRender
 {
 public:
+	/*
+	 * Number of renderer state changes sent to SDL (issued) and
+	 * dropped because the state was already set (skipped).
+	 */
+	struct StateCounters
+	{
+		unsigned long colorIssued = 0;
+		unsigned long colorSkipped = 0;
+		unsigned long targetIssued = 0;
+		unsigned long targetSkipped = 0;
+		unsigned long blendIssued = 0;
+		unsigned long blendSkipped = 0;
+	};
+
 	ViewRenderHW(int xres, int yres, int bitdepth);
 	virtual ~ViewRenderHW();
 	virtual void line(const Point &a, const Point &b, uint32_t color) override;
@@ -34,19 +48,42 @@ public:
 	virtual void filledRectangle(const Rectangle &rect, uint32_t color) override;
 	virtual void filledRectangle2(const Rectangle &rect, uint32_t colors[2]) override;
 	virtual void frame(const Rectangle &rect, int len, uint32_t colors[2], bool inner) override;
+	virtual void fillRects(const Rectangle *rects, int n, uint32_t color) override;
+	virtual void fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors) override;
+	virtual void lines(const Point *points, int n, uint32_t color) override;
 	virtual void textBox(const char *text, Rectangle &out) override;
 	virtual void text(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const char *text) override;
 	virtual void textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const uint16_t *text) override;
 	virtual void *loadBMP(const char *name) override;
 	virtual bool unloadBMP(void *bmp) override;
 	virtual void drawBMP(void *bmp, const Rectangle &rect) override;
+	virtual void loadBMPAsync(const char *name, View *requester, BitmapCallback callback) override;
+	virtual void completeBMPAsync(void) override;
+	virtual void cancelBMPAsync(View *requester) override;
 	virtual void start(void) override;
 	virtual void show(void) override;
+	virtual void showOutline(const Rectangle &rect, uint32_t color) override;
 	virtual void clear(uint32_t color) override;
 	virtual void *createBuffer(const Rectangle &rect);
 	virtual void releaseBuffer(const void *buffer);
 	virtual void setBuffer(const void *buffer);
 	virtual void writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem) override;
+	virtual void setClipping(const Rectangle *clip) override;
+	/*
+	 * Get a copy of the state change counters.
+	 *
+	 * PARAMETER OUT
+	 *  StateCounters &out - the counters
+	 */
+	void getStateCounters(StateCounters &out);
+	/*
+	 * Reset the state change counters.
+	 */
+	void resetStateCounters(void);
+
+private:
+	// The worker thread decoding the bitmaps of loadBMPAsync()
+	void decodeBMPs(void);
 };
 
 #endif
\ No newline at end of file
@@ -17,25 +17,139 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <iostream>
 #include "viewrenderinstance.h"
+#include "viewrenderrecorder.h"
+#include "viewrendertee.h"
+#include "viewrendercapture.h"
 
-ViewRenderInstance::ViewRenderInstance() : renderer(nullptr)
+ViewRenderInstance::ViewRenderInstance() : renderer(nullptr), recorder(nullptr), tee(nullptr), capture(nullptr)
 {
 }
 
 void ViewRenderInstance::configure(enum ViewRenderType sel, int xres, int yres, int bitdepth)
 {
+#ifdef VRENDER_STATIC
+	if (sel != VRENDER_STATIC)
+	{
+		std::cout << "Renderer " << sel << " not available, the build selects renderer " << VRENDER_STATIC << std::endl;
+		return;
+	}
+#ifdef VRENDER_STATIC_FORMAT
+	if (bitdepth != VRENDER_STATIC_FORMAT::bitsPerPixel)
+	{
+		std::cout << "Bit depth " << bitdepth << " not available, the build selects bit depth " << VRENDER_STATIC_FORMAT::bitsPerPixel << std::endl;
+		return;
+	}
+#endif
+#endif
+
+	bool commandList = (recorder != nullptr);
+	setCommandList(false);
+	setCapture(nullptr);
+
 	if (renderer)
 		delete renderer;
 
+#ifdef VRENDER_STATIC
+	// The backend class is known, no need to go through the factory
+	renderer = new ViewRenderBackend(xres, yres, bitdepth);
+#else
 	renderer = ViewRenderFactory::create(sel, xres, yres, bitdepth);
+#endif
+	setCommandList(commandList);
 }
 
-class ViewRender *ViewRenderInstance::get()
+void ViewRenderInstance::setCommandList(bool enable)
+{
+#ifdef VRENDER_STATIC
+	// GRenderer bypasses the recorder
+	enable = false;
+#endif
+
+	if (enable && !recorder && renderer)
+	{
+		recorder = new ViewRenderRecorder(output());
+	}
+	else if (!enable && recorder)
+	{
+		delete recorder;
+		recorder = nullptr;
+	}
+}
+
+bool ViewRenderInstance::setCapture(const char *path)
 {
+	bool commandList = (recorder != nullptr);
+	setCommandList(false);
+
+	if (capture)
+	{
+		delete capture;
+		capture = nullptr;
+	}
+
+#ifdef VRENDER_STATIC
+	// GRenderer bypasses the capture
+	path = nullptr;
+#endif
+
+	if (path && renderer)
+	{
+		capture = new ViewRenderCapture(renderer, path);
+		if (!capture->isOpen())
+		{
+			delete capture;
+			capture = nullptr;
+		}
+	}
+
+	setCommandList(commandList);
+	return (capture != nullptr) || (path == nullptr);
+}
+
+class ViewRender *ViewRenderInstance::output()
+{
+	if (capture)
+		return capture;
+
 	return renderer;
 }
 
+class ViewRender *ViewRenderInstance::get()
+{
+	if (tee && tee->getList())
+		return tee;
+
+	return (recorder) ? recorder : output();
+}
+
+void ViewRenderInstance::beginDisplayList(class RenderCommandList *list)
+{
+#ifdef VRENDER_STATIC
+	// GRenderer bypasses the tee
+	(void)list;
+#else
+	ViewRender *target = (recorder) ? recorder : output();
+
+	if (!target)
+		return;
+
+	if (!tee)
+		tee = new ViewRenderTee(target);
+	else
+		tee->setTarget(target);
+
+	tee->setList(list);
+#endif
+}
+
+void ViewRenderInstance::endDisplayList(void)
+{
+	if (tee)
+		tee->setList(nullptr);
+}
+
 class ViewRenderInstance *ViewRenderInstance::instance()
 {
 	static ViewRenderInstance instance;
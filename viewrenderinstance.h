@@ -22,6 +22,32 @@
 
 #include "viewrenderfactory.h"
 
+/*
+ * The renderer can be selected at compile time defining VRENDER_STATIC_<backend>,
+ * e.g. VRENDER_STATIC_HW: GRenderer then refers to the final backend class, calls
+ * are bound statically and can be inlined (link time optimization is required
+ * for backends implemented in their own translation unit).
+ * Only the selected backend can be configured; command list mode, capture and
+ * display lists are not available since they wrap the renderer.
+ * VRENDER_STATIC_VESA also fixes the pixel format to VRENDER_STATIC_FORMAT
+ * (see pixelformat.h, PixelRGB565 by default).
+ * Without a VRENDER_STATIC_<backend> define the renderer is selected at run time.
+ */
+#if defined(VRENDER_STATIC_HW)
+#include "viewrenderhw.h"
+#define VRENDER_STATIC VRENDER_HW
+typedef ViewRenderHW ViewRenderBackend;
+#elif defined(VRENDER_STATIC_VESA)
+#include "viewrendersw.h"
+#define VRENDER_STATIC VRENDER_VESA
+#ifndef VRENDER_STATIC_FORMAT
+#define VRENDER_STATIC_FORMAT PixelRGB565
+#endif
+typedef ViewRenderSW<VRENDER_STATIC_FORMAT> ViewRenderBackend;
+#else
+typedef ViewRender ViewRenderBackend;
+#endif
+
 class ViewRenderInstance
 {
 public:
@@ -32,11 +58,51 @@ public:
 	 */
 	void configure(enum ViewRenderType sel, int xres, int yres, int bitdepth);
 
+	/*
+	 * Enable or disable the command list mode: the drawing of a frame is recorded
+	 * and sent to the renderer grouped by destination buffer, see ViewRenderRecorder.
+	 * The mode is retained if the renderer is configured again.
+	 */
+	void setCommandList(bool enable);
+
+	/*
+	 * Start writing all the calls reaching the renderer to a capture file,
+	 * see ViewRenderCapture; passing NULL stops the capture.
+	 * Capture stops if the renderer is configured again.
+	 *
+	 * PARAMETERS IN
+	 * const char *path - the capture file
+	 *
+	 * RETURN
+	 * true if the capture file could be created
+	 */
+	bool setCapture(const char *path);
+
+	/*
+	 * Copy the drawing primitives sent to the renderer to a display list,
+	 * until endDisplayList() is invoked. The primitives are drawn as well.
+	 *
+	 * PARAMETERS IN
+	 * RenderCommandList *list - the display list
+	 */
+	void beginDisplayList(class RenderCommandList *list);
+	void endDisplayList(void);
+
 	/*
 	 * Retrieve the configured PaletteGroup object.
 	 */
 	class ViewRender *get();
 
+	/*
+	 * Retrieve the renderer with the type selected at compile time,
+	 * see VRENDER_STATIC.
+	 */
+#ifdef VRENDER_STATIC
+	inline ViewRenderBackend *backend() { return static_cast<ViewRenderBackend *>(renderer); }
+#else
+	inline ViewRenderBackend *backend() { return get(); }
+#endif
+
 	/*
 	 * Retrieve the singleton instance.
 	 */
@@ -44,6 +110,15 @@ public:
 
 private:
 	class ViewRender *renderer;
+	class ViewRenderRecorder *recorder;
+	class ViewRenderTee *tee;
+	class ViewRenderCapture *capture;
+
+	/*
+	 * The renderer receiving the calls of the recorder, the capture
+	 * if active.
+	 */
+	class ViewRender *output(void);
 
 	ViewRenderInstance();
 };
@@ -0,0 +1,200 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VIEWRENDERLUT_H_
+#define _VIEWRENDERLUT_H_
+
+#include "viewrendersw.h"
+#include "palette.h"
+
+/*
+ * ViewRenderLUT draws slots of the lookup table of PaletteIndexed instead
+ * of colors (bit depth PALETTE_INDEXED_DEPTH, see palettegroupfactory.h):
+ * buffers and screen hold one byte per pixel and the screen is converted to
+ * the video memory, of pixel format Format, when shown.
+ * Changing the colors of the lookup table costs one conversion of the
+ * screen, the views are not drawn again. Otherwise only the area written
+ * since the last frame is converted.
+ */
+template <class Format>
+class ViewRenderLUT final : public ViewRenderSW<PixelLUT8>
+{
+public:
+	typedef typename Format::pixel_t video_t;
+
+	/*
+	 * PARAMETERS IN
+	 * int xres, int yres - the resolution
+	 * void *videomem - the video memory; if NULL the memory is allocated
+	 * int pitch - the distance between rows of the video memory, in bytes
+	 */
+	ViewRenderLUT(int xres, int yres, void *videomem = nullptr, int pitch = 0) : ViewRenderSW<PixelLUT8>(xres, yres, PixelLUT8::bitsPerPixel),
+										      ownVideo(videomem == nullptr),
+										      lutVersion(~PaletteIndexed::getLUTVersion()),
+										      isDirty(false),
+										      outline(false)
+	{
+		video.width = xres;
+		video.height = yres;
+		video.pitch = (videomem) ? pitch : xres * (int)sizeof(video_t);
+		video.pixels = (videomem) ? static_cast<uint8_t *>(videomem) : new uint8_t[video.pitch * yres]();
+	}
+
+	virtual ~ViewRenderLUT()
+	{
+		if (ownVideo)
+			delete[] video.pixels;
+	}
+
+	inline const Surface &getVideo(void) const { return video; }
+
+	virtual void start(void) override
+	{
+		// The pixels below the outline are restored in the screen
+		if (outline)
+			invalidate(outlineArea);
+		outline = false;
+
+		ViewRenderSW<PixelLUT8>::start();
+		if (!clipped)
+			invalidate(Rectangle(0, 0, xres - 1, yres - 1));
+	}
+
+	virtual void showOutline(const Rectangle &rect, uint32_t color) override
+	{
+		Rectangle screenArea(0, 0, xres - 1, yres - 1);
+
+		if (outline)
+			invalidate(outlineArea);
+
+		outlineArea = rect;
+		outline = outlineArea.intersect(screenArea);
+		if (outline)
+		{
+			outlineArea.intersection(screenArea);
+			invalidate(outlineArea);
+		}
+
+		ViewRenderSW<PixelLUT8>::showOutline(rect, color);
+	}
+
+	virtual void clear(uint32_t color) override
+	{
+		ViewRenderSW<PixelLUT8>::clear(color);
+
+		if (current != &screen)
+			return;
+
+		Rectangle area(0, 0, xres - 1, yres - 1);
+		if (clipped)
+		{
+			if (!area.intersect(clipping))
+				return;
+			area.intersection(clipping);
+		}
+		invalidate(area);
+	}
+
+	virtual void setBuffer(const void *buffer) override
+	{
+		ViewRenderSW<PixelLUT8>::setBuffer(buffer);
+
+		// Anything can be drawn on the screen now
+		if (!buffer)
+			invalidate(Rectangle(0, 0, xres - 1, yres - 1));
+	}
+
+	virtual void writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem) override
+	{
+		Rectangle area(0, 0, xres - 1, yres - 1);
+		Rectangle dest;
+
+		ViewRenderSW<PixelLUT8>::writeBuffer(buffer, rect, vidmem);
+
+		dest = vidmem;
+		if (!dest.intersect(area))
+			return;
+		dest.intersection(area);
+		if (clipped)
+		{
+			if (!dest.intersect(clipping))
+				return;
+			dest.intersection(clipping);
+		}
+		invalidate(dest);
+	}
+
+protected:
+	virtual void present(void) override
+	{
+		// New colors: the whole screen changes
+		if (lutVersion != PaletteIndexed::getLUTVersion())
+		{
+			const uint32_t *lut = PaletteIndexed::getLUT();
+
+			for (int i = 0; i < PALETTE_LUT_SIZE; i++)
+				colors[i] = Format::pack(lut[i] | 0xFF000000);
+			lutVersion = PaletteIndexed::getLUTVersion();
+			invalidate(Rectangle(0, 0, xres - 1, yres - 1));
+		}
+
+		if (!isDirty)
+			return;
+
+		for (int y = dirty.ul.y; y <= dirty.lr.y; y++)
+		{
+			const uint8_t *src = Rasterizer<PixelLUT8>::row(screen, y) + dirty.ul.x;
+			video_t *dst = Rasterizer<Format>::row(video, y) + dirty.ul.x;
+
+			for (int x = dirty.ul.x; x <= dirty.lr.x; x++)
+				*dst++ = colors[*src++];
+		}
+
+		isDirty = false;
+	}
+
+private:
+	void invalidate(const Rectangle &area)
+	{
+		if (isDirty)
+		{
+			Rectangle temp;
+			temp = area;
+			dirty.join(temp);
+		}
+		else
+			dirty = area;
+
+		isDirty = true;
+	}
+
+	Surface video;
+	bool ownVideo;
+	// Lookup table converted to the video memory format
+	video_t colors[PALETTE_LUT_SIZE];
+	unsigned lutVersion;
+	// Area of the screen not converted to the video memory yet
+	Rectangle dirty;
+	bool isDirty;
+	// Area of the outline shown, if any
+	Rectangle outlineArea;
+	bool outline;
+};
+
+#endif
\ No newline at end of file
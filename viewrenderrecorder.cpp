@@ -0,0 +1,382 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <functional>
+#include "viewrenderrecorder.h"
+
+template <typename T>
+static void append(T *&array, unsigned &size, unsigned &capacity, T item)
+{
+	if (size == capacity)
+	{
+		unsigned newCapacity = (capacity) ? (capacity * 2) : 16;
+		T *newArray = new T[newCapacity];
+
+		for (unsigned i = 0; i < size; i++)
+			newArray[i] = array[i];
+
+		delete[] array;
+		array = newArray;
+		capacity = newCapacity;
+	}
+
+	array[size++] = item;
+}
+
+ViewRenderRecorder::ViewRenderRecorder(ViewRender *target) : ViewRender(target->getXRes(), target->getYRes(), target->getBitDepth()),
+							     target(target), recording(false), current(nullptr),
+							     runs(nullptr), runsSize(0), runsCapacity(0), switches(0),
+							     releasedBuffers(nullptr), releasedBuffersSize(0), releasedBuffersCapacity(0),
+							     releasedBMPs(nullptr), releasedBMPsSize(0), releasedBMPsCapacity(0)
+{
+}
+
+ViewRenderRecorder::~ViewRenderRecorder()
+{
+	for (unsigned i = 0; i < releasedBuffersSize; i++)
+		target->releaseBuffer(releasedBuffers[i]);
+	for (unsigned i = 0; i < releasedBMPsSize; i++)
+		target->unloadBMP(releasedBMPs[i]);
+
+	delete[] runs;
+	delete[] releasedBuffers;
+	delete[] releasedBMPs;
+}
+
+void ViewRenderRecorder::select(const void *buffer)
+{
+	if (runsSize && (runs[runsSize - 1].buffer == buffer))
+		return;
+
+	Run run;
+	run.buffer = buffer;
+	run.first = commands.getSize();
+	run.count = 0;
+	append(runs, runsSize, runsCapacity, run);
+}
+
+void ViewRenderRecorder::submit(void)
+{
+	for (unsigned i = 0; i < runsSize; i++)
+		runs[i].count = ((i + 1 < runsSize) ? runs[i + 1].first : commands.getSize()) - runs[i].first;
+
+	/*
+	 * Group the runs by destination, the video memory goes last since it is
+	 * composed from the buffers; stable sorting retains the order of the
+	 * commands sent to the same destination.
+	 */
+	std::stable_sort(runs, runs + runsSize, [](const Run &a, const Run &b)
+			 {
+				 if (a.buffer == b.buffer || a.buffer == nullptr)
+					 return false;
+				 if (b.buffer == nullptr)
+					 return true;
+				 return std::less<const void *>()(a.buffer, b.buffer); });
+
+	target->start();
+	const void *last = nullptr;
+	switches = 1;
+	for (unsigned i = 0; i < runsSize; i++)
+	{
+		if (runs[i].buffer != last)
+		{
+			target->setBuffer(runs[i].buffer);
+			last = runs[i].buffer;
+			switches++;
+		}
+		commands.replay(target, runs[i].first, runs[i].count);
+	}
+
+	for (unsigned i = 0; i < releasedBuffersSize; i++)
+		target->releaseBuffer(releasedBuffers[i]);
+	for (unsigned i = 0; i < releasedBMPsSize; i++)
+		target->unloadBMP(releasedBMPs[i]);
+
+	releasedBuffersSize = releasedBMPsSize = 0;
+	runsSize = 0;
+	commands.reset();
+}
+
+void ViewRenderRecorder::line(const Point &a, const Point &b, uint32_t color)
+{
+	if (recording)
+	{
+		select(current);
+		commands.line(a, b, color);
+	}
+	else
+		target->line(a, b, color);
+}
+
+void ViewRenderRecorder::hline(const Point &a, int len, uint32_t color)
+{
+	if (recording)
+	{
+		select(current);
+		commands.hline(a, len, color);
+	}
+	else
+		target->hline(a, len, color);
+}
+
+void ViewRenderRecorder::vline(const Point &a, int len, uint32_t color)
+{
+	if (recording)
+	{
+		select(current);
+		commands.vline(a, len, color);
+	}
+	else
+		target->vline(a, len, color);
+}
+
+void ViewRenderRecorder::rectangle(const Rectangle &rect, int len, uint32_t color)
+{
+	if (recording)
+	{
+		select(current);
+		commands.rectangle(rect, len, color);
+	}
+	else
+		target->rectangle(rect, len, color);
+}
+
+void ViewRenderRecorder::filledRectangle(const Rectangle &rect, uint32_t color)
+{
+	if (recording)
+	{
+		select(current);
+		commands.filledRectangle(rect, color);
+	}
+	else
+		target->filledRectangle(rect, color);
+}
+
+void ViewRenderRecorder::filledRectangle2(const Rectangle &rect, uint32_t colors[2])
+{
+	if (recording)
+	{
+		select(current);
+		commands.filledRectangle2(rect, colors);
+	}
+	else
+		target->filledRectangle2(rect, colors);
+}
+
+void ViewRenderRecorder::frame(const Rectangle &rect, int len, uint32_t colors[2], bool inner)
+{
+	if (recording)
+	{
+		select(current);
+		commands.frame(rect, len, colors, inner);
+	}
+	else
+		target->frame(rect, len, colors, inner);
+}
+
+void ViewRenderRecorder::fillRects(const Rectangle *rects, int n, uint32_t color)
+{
+	if (recording)
+	{
+		select(current);
+		commands.fillRects(rects, n, color);
+	}
+	else
+		target->fillRects(rects, n, color);
+}
+
+void ViewRenderRecorder::fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors)
+{
+	if (recording)
+	{
+		select(current);
+		commands.fillRectsColored(rects, n, colors);
+	}
+	else
+		target->fillRectsColored(rects, n, colors);
+}
+
+void ViewRenderRecorder::lines(const Point *points, int n, uint32_t color)
+{
+	if (recording)
+	{
+		select(current);
+		commands.lines(points, n, color);
+	}
+	else
+		target->lines(points, n, color);
+}
+
+void ViewRenderRecorder::textBox(const char *text, Rectangle &out)
+{
+	target->textBox(text, out);
+}
+
+void ViewRenderRecorder::text(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const char *text)
+{
+	if (recording)
+	{
+		select(current);
+		commands.text(rect, fcolor, bcolor, text);
+	}
+	else
+		target->text(rect, fcolor, bcolor, text);
+}
+
+void ViewRenderRecorder::textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const uint16_t *text)
+{
+	if (recording)
+	{
+		select(current);
+		commands.textUNICODE(rect, fcolor, bcolor, text);
+	}
+	else
+		target->textUNICODE(rect, fcolor, bcolor, text);
+}
+
+void *ViewRenderRecorder::loadBMP(const char *name)
+{
+	return target->loadBMP(name);
+}
+
+bool ViewRenderRecorder::unloadBMP(void *bmp)
+{
+	if (!recording)
+		return target->unloadBMP(bmp);
+
+	if (!bmp)
+		return false;
+
+	// The bitmap could be referred by recorded commands
+	append(releasedBMPs, releasedBMPsSize, releasedBMPsCapacity, bmp);
+	return true;
+}
+
+void ViewRenderRecorder::drawBMP(void *bmp, const Rectangle &rect)
+{
+	if (recording)
+	{
+		select(current);
+		commands.drawBMP(bmp, rect);
+	}
+	else
+		target->drawBMP(bmp, rect);
+}
+
+void ViewRenderRecorder::loadBMPAsync(const char *name, View *requester, BitmapCallback callback)
+{
+	target->loadBMPAsync(name, requester, callback);
+}
+
+void ViewRenderRecorder::completeBMPAsync(void)
+{
+	target->completeBMPAsync();
+}
+
+void ViewRenderRecorder::cancelBMPAsync(View *requester)
+{
+	target->cancelBMPAsync(requester);
+}
+
+void ViewRenderRecorder::start(void)
+{
+	/*
+	 * start() is sent to the wrapped renderer on submission,
+	 * before any other command.
+	 */
+	commands.reset();
+	runsSize = 0;
+	current = nullptr;
+	recording = true;
+}
+
+void ViewRenderRecorder::show(void)
+{
+	if (recording)
+	{
+		submit();
+		recording = false;
+	}
+
+	target->show();
+}
+
+void ViewRenderRecorder::showOutline(const Rectangle &rect, uint32_t color)
+{
+	target->showOutline(rect, color);
+}
+
+void ViewRenderRecorder::clear(uint32_t color)
+{
+	if (recording)
+	{
+		select(current);
+		commands.clear(color);
+	}
+	else
+		target->clear(color);
+}
+
+void *ViewRenderRecorder::createBuffer(const Rectangle &rect)
+{
+	return target->createBuffer(rect);
+}
+
+void ViewRenderRecorder::releaseBuffer(const void *buffer)
+{
+	if (!recording)
+		target->releaseBuffer(buffer);
+	else if (buffer)
+		// The buffer could be referred by recorded commands
+		append(releasedBuffers, releasedBuffersSize, releasedBuffersCapacity, buffer);
+}
+
+void ViewRenderRecorder::setBuffer(const void *buffer)
+{
+	if (recording)
+		current = buffer;
+	else
+		target->setBuffer(buffer);
+}
+
+void ViewRenderRecorder::writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem)
+{
+	if (recording)
+	{
+		// Writing to video memory makes it the destination of the next commands
+		current = nullptr;
+		select(current);
+		commands.writeBuffer(buffer, rect, vidmem);
+	}
+	else
+		target->writeBuffer(buffer, rect, vidmem);
+}
+
+void ViewRenderRecorder::setClipping(const Rectangle *clip)
+{
+	if (recording)
+	{
+		// Clipping affects the video memory only
+		select(nullptr);
+		commands.setClipping(clip);
+	}
+	else
+		target->setClipping(clip);
+}
\ No newline at end of file
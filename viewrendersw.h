@@ -0,0 +1,398 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VIEWRENDERSW_H_
+#define _VIEWRENDERSW_H_
+
+#include "viewrender.h"
+#include "rasterizer.h"
+#include "builtinfont.h"
+
+/*
+ * ViewRenderSW draws with the CPU into a linear video memory with the
+ * pixel format Format (see pixelformat.h), e.g. a VESA linear frame buffer.
+ * Buffers are memory surfaces of the same format, so composing the video
+ * memory is a plain copy of rows.
+ * The drawing methods are final: calls through a ViewRenderSW pointer are
+ * bound statically, see VRENDER_STATIC in viewrenderinstance.h.
+ * Text is drawn with a bitmap font, builtinFont unless set with setFont().
+ * Bitmaps are not supported yet, there are no image loaders available
+ * without the host os.
+ */
+template <class Format>
+class ViewRenderSW : public ViewRender
+{
+public:
+	typedef Rasterizer<Format> R;
+	typedef typename Format::pixel_t pixel_t;
+
+	/*
+	 * PARAMETERS IN
+	 * int xres, int yres - the resolution
+	 * int bitdepth - the bit depth, it MUST match Format
+	 * void *videomem - the video memory; if NULL the memory is allocated
+	 *                  and the frames are composed off screen
+	 * int pitch - the distance between rows of the video memory, in bytes
+	 */
+	ViewRenderSW(int xres, int yres, int bitdepth, void *videomem = nullptr, int pitch = 0) : ViewRender(xres, yres, bitdepth),
+												   current(&screen),
+												   clipped(false),
+												   font(&builtinFont),
+												   ownScreen(videomem == nullptr),
+												   outlineSaved(nullptr),
+												   outlineSize(0),
+												   outlineCapacity(0),
+												   outlineRectsNum(0)
+	{
+		screen.width = xres;
+		screen.height = yres;
+		screen.pitch = (videomem) ? pitch : xres * (int)sizeof(pixel_t);
+		screen.pixels = (videomem) ? static_cast<uint8_t *>(videomem) : new uint8_t[screen.pitch * yres]();
+	}
+
+	virtual ~ViewRenderSW()
+	{
+		if (ownScreen)
+			delete[] screen.pixels;
+		delete[] outlineSaved;
+	}
+
+	virtual void line(const Point &a, const Point &b, uint32_t color) override final
+	{
+		R::line(*current, a, b, R::pack(color));
+	}
+
+	virtual void hline(const Point &a, int len, uint32_t color) override final
+	{
+		R::hline(*current, a.x, a.x + len, a.y, R::pack(color));
+	}
+
+	virtual void vline(const Point &a, int len, uint32_t color) override final
+	{
+		R::vline(*current, a.x, a.y, a.y + len, R::pack(color));
+	}
+
+	virtual void rectangle(const Rectangle &rect, int len, uint32_t color) override final
+	{
+		Rectangle layer;
+		pixel_t pixel = R::pack(color);
+
+		layer = rect;
+		while (len-- > 0)
+		{
+			Rectangle rects[4];
+			int n = rectangleRects(layer, 1, color, rects, nullptr);
+			if (n == 0)
+				break;
+			for (int i = 0; i < n; i++)
+				R::fill(*current, rects[i], pixel);
+			layer.zoom(-1, -1);
+		}
+	}
+
+	virtual void filledRectangle(const Rectangle &rect, uint32_t color) override final
+	{
+		R::fill(*current, rect, R::pack(color));
+	}
+
+	virtual void filledRectangle2(const Rectangle &rect, uint32_t colors[2]) override final
+	{
+		Rectangle inner;
+
+		rectangle(rect, 1, colors[0]);
+		inner = rect;
+		inner.zoom(-1, -1);
+		R::fill(*current, inner, R::pack(colors[1]));
+	}
+
+	virtual void frame(const Rectangle &rect, int len, uint32_t colors[2], bool inner) override final
+	{
+		Rectangle layer;
+		pixel_t pixels[2] = {R::pack(colors[0]), R::pack(colors[1])};
+
+		layer = rect;
+		while (len-- > 0)
+		{
+			Rectangle rects[4];
+			uint32_t rcolors[4];
+			int n = frameRects(layer, 1, colors, inner, rects, rcolors);
+			if (n == 0)
+				break;
+			for (int i = 0; i < n; i++)
+				R::fill(*current, rects[i], (rcolors[i] == colors[0]) ? pixels[0] : pixels[1]);
+			layer.zoom(-1, -1);
+		}
+	}
+
+	virtual void fillRects(const Rectangle *rects, int n, uint32_t color) override final
+	{
+		pixel_t pixel = R::pack(color);
+
+		for (int i = 0; i < n; i++)
+			R::fill(*current, rects[i], pixel);
+	}
+
+	virtual void fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors) override final
+	{
+		for (int i = 0; i < n; i++)
+			R::fill(*current, rects[i], R::pack(colors[i]));
+	}
+
+	virtual void lines(const Point *points, int n, uint32_t color) override final
+	{
+		pixel_t pixel = R::pack(color);
+
+		for (int i = 1; i < n; i++)
+			R::line(*current, points[i - 1], points[i], pixel);
+	}
+
+	virtual void textBox(const char *text, Rectangle &out) override
+	{
+		out.ul.x = out.ul.y = 0;
+		if (!text)
+		{
+			out.lr.x = out.lr.y = 0;
+		}
+		else
+		{
+			out.lr.x = font->measure(text);
+			out.lr.y = font->height;
+		}
+	}
+
+	virtual void text(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const char *text) override
+	{
+		drawText(rect, fcolor, bcolor, text);
+	}
+
+	virtual void textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const uint16_t *text) override
+	{
+		drawText(rect, fcolor, bcolor, text);
+	}
+
+	virtual void *loadBMP(const char * /*name*/) override
+	{
+		return nullptr;
+	}
+
+	virtual bool unloadBMP(void * /*bmp*/) override
+	{
+		return false;
+	}
+
+	virtual void drawBMP(void * /*bmp*/, const Rectangle & /*rect*/) override
+	{
+	}
+
+	virtual void start(void) override
+	{
+		restoreOutline();
+		current = &screen;
+		if (!clipped)
+			R::fill(screen, Rectangle(0, 0, xres - 1, yres - 1), R::pack(0));
+	}
+
+	virtual void show(void) override
+	{
+		present();
+	}
+
+	virtual void showOutline(const Rectangle &rect, uint32_t color) override
+	{
+		/*
+		 * The pixels below the outline are saved, and restored by the next
+		 * start() or showOutline(), so the video memory is left untouched.
+		 */
+		restoreOutline();
+
+		outlineRectsNum = rectangleRects(rect, 2, color, outlineRects, nullptr);
+		outlineSize = 0;
+		for (int i = 0; i < outlineRectsNum; i++)
+		{
+			clipToScreen(outlineRects[i]);
+			outlineSize += area(outlineRects[i]);
+		}
+
+		if (outlineSize > outlineCapacity)
+		{
+			delete[] outlineSaved;
+			outlineSaved = new pixel_t[outlineSize];
+			outlineCapacity = outlineSize;
+		}
+
+		pixel_t *saved = outlineSaved;
+		for (int i = 0; i < outlineRectsNum; i++)
+		{
+			Rectangle &r = outlineRects[i];
+			for (int y = r.ul.y; y <= r.lr.y; y++)
+				for (int x = r.ul.x; x <= r.lr.x; x++)
+					*saved++ = R::row(screen, y)[x];
+			R::fill(screen, r, R::pack(color));
+		}
+
+		present();
+	}
+
+	virtual void clear(uint32_t color) override
+	{
+		if ((current == &screen) && clipped)
+			R::fill(screen, clipping, R::pack(color));
+		else
+			R::fill(*current, Rectangle(0, 0, current->width - 1, current->height - 1), R::pack(color));
+	}
+
+	virtual void *createBuffer(const Rectangle &rect) override
+	{
+		Surface *s = new Surface;
+
+		s->width = rect.width();
+		s->height = rect.height();
+		s->pitch = s->width * sizeof(pixel_t);
+		s->pixels = new uint8_t[s->pitch * s->height]();
+		return s;
+	}
+
+	virtual void releaseBuffer(const void *buffer) override
+	{
+		const Surface *s = static_cast<const Surface *>(buffer);
+
+		if (!s)
+			return;
+
+		if (current == s)
+			current = &screen;
+		delete[] s->pixels;
+		delete s;
+	}
+
+	virtual void setBuffer(const void *buffer) override
+	{
+		current = (buffer) ? static_cast<Surface *>(const_cast<void *>(buffer)) : &screen;
+	}
+
+	virtual void writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem) override
+	{
+		const Surface *s = static_cast<const Surface *>(buffer);
+
+		if (!s)
+			return;
+
+		Rectangle dest;
+		dest = vidmem;
+		if (clipped)
+		{
+			if (!dest.intersect(clipping))
+				return;
+			dest.intersection(clipping);
+		}
+
+		// Buffers are copied 1:1, shrink the source by the clipped amount
+		Rectangle src(rect.ul.x + dest.ul.x - vidmem.ul.x,
+			      rect.ul.y + dest.ul.y - vidmem.ul.y,
+			      rect.ul.x + dest.lr.x - vidmem.ul.x,
+			      rect.ul.y + dest.lr.y - vidmem.ul.y);
+		R::blit(screen, *s, src, dest.ul);
+		current = &screen;
+	}
+
+	virtual void setClipping(const Rectangle *clip) override
+	{
+		if (clip)
+		{
+			clipping = *clip;
+			clipped = true;
+		}
+		else
+			clipped = false;
+	}
+
+	inline const Surface &getScreen(void) const { return screen; }
+
+	/*
+	 * Set the font of the text, the font MUST outlive the renderer.
+	 */
+	inline void setFont(const BitmapFont *newFont) { font = (newFont) ? newFont : &builtinFont; }
+
+protected:
+	/*
+	 * Send the video memory to the display, if the hardware requires it.
+	 * Linear frame buffers are on display as soon as they are written.
+	 */
+	virtual void present(void) {}
+
+	Surface screen;
+	// The drawing target, a buffer or the screen
+	Surface *current;
+	Rectangle clipping;
+	bool clipped;
+	const BitmapFont *font;
+
+private:
+	static inline int area(const Rectangle &r)
+	{
+		return ((r.lr.x < r.ul.x) || (r.lr.y < r.ul.y)) ? 0 : (r.lr.x - r.ul.x + 1) * (r.lr.y - r.ul.y + 1);
+	}
+
+	/*
+	 * The text fills rect, as the text drawn by ViewRenderHW: the
+	 * background covers it all, the line is centered vertically and
+	 * starts at the left side; the glyphs out of rect are clipped.
+	 */
+	template <class T>
+	void drawText(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const T *text)
+	{
+		if (!text)
+			return;
+
+		R::fill(*current, rect, R::pack(bcolor));
+		Point pen(rect.ul.x, rect.ul.y + (rect.lr.y - rect.ul.y + 1 - font->height) / 2 + font->ascent);
+		R::text(*current, *font, text, pen, rect, fcolor);
+	}
+
+	void clipToScreen(Rectangle &r)
+	{
+		r.ul.x = std::max(r.ul.x, 0);
+		r.ul.y = std::max(r.ul.y, 0);
+		r.lr.x = std::min(r.lr.x, xres - 1);
+		r.lr.y = std::min(r.lr.y, yres - 1);
+	}
+
+	void restoreOutline(void)
+	{
+		pixel_t *saved = outlineSaved;
+
+		for (int i = 0; i < outlineRectsNum; i++)
+		{
+			Rectangle &r = outlineRects[i];
+			for (int y = r.ul.y; y <= r.lr.y; y++)
+				for (int x = r.ul.x; x <= r.lr.x; x++)
+					R::row(screen, y)[x] = *saved++;
+		}
+		outlineRectsNum = 0;
+	}
+
+	bool ownScreen;
+	// Pixels below the outline traced by showOutline()
+	pixel_t *outlineSaved;
+	int outlineSize, outlineCapacity;
+	Rectangle outlineRects[8];
+	int outlineRectsNum;
+};
+
+#endif
\ No newline at end of file
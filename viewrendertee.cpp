@@ -0,0 +1,193 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "viewrendertee.h"
+
+ViewRenderTee::ViewRenderTee(ViewRender *target) : ViewRender(target->getXRes(), target->getYRes(), target->getBitDepth()),
+						   target(target), list(nullptr)
+{
+}
+
+void ViewRenderTee::line(const Point &a, const Point &b, uint32_t color)
+{
+	if (list)
+		list->line(a, b, color);
+	target->line(a, b, color);
+}
+
+void ViewRenderTee::hline(const Point &a, int len, uint32_t color)
+{
+	if (list)
+		list->hline(a, len, color);
+	target->hline(a, len, color);
+}
+
+void ViewRenderTee::vline(const Point &a, int len, uint32_t color)
+{
+	if (list)
+		list->vline(a, len, color);
+	target->vline(a, len, color);
+}
+
+void ViewRenderTee::rectangle(const Rectangle &rect, int len, uint32_t color)
+{
+	if (list)
+		list->rectangle(rect, len, color);
+	target->rectangle(rect, len, color);
+}
+
+void ViewRenderTee::filledRectangle(const Rectangle &rect, uint32_t color)
+{
+	if (list)
+		list->filledRectangle(rect, color);
+	target->filledRectangle(rect, color);
+}
+
+void ViewRenderTee::filledRectangle2(const Rectangle &rect, uint32_t colors[2])
+{
+	if (list)
+		list->filledRectangle2(rect, colors);
+	target->filledRectangle2(rect, colors);
+}
+
+void ViewRenderTee::frame(const Rectangle &rect, int len, uint32_t colors[2], bool inner)
+{
+	if (list)
+		list->frame(rect, len, colors, inner);
+	target->frame(rect, len, colors, inner);
+}
+
+void ViewRenderTee::fillRects(const Rectangle *rects, int n, uint32_t color)
+{
+	if (list)
+		list->fillRects(rects, n, color);
+	target->fillRects(rects, n, color);
+}
+
+void ViewRenderTee::fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors)
+{
+	if (list)
+		list->fillRectsColored(rects, n, colors);
+	target->fillRectsColored(rects, n, colors);
+}
+
+void ViewRenderTee::lines(const Point *points, int n, uint32_t color)
+{
+	if (list)
+		list->lines(points, n, color);
+	target->lines(points, n, color);
+}
+
+void ViewRenderTee::textBox(const char *text, Rectangle &out)
+{
+	target->textBox(text, out);
+}
+
+void ViewRenderTee::text(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const char *text)
+{
+	if (list)
+		list->text(rect, fcolor, bcolor, text);
+	target->text(rect, fcolor, bcolor, text);
+}
+
+void ViewRenderTee::textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const uint16_t *text)
+{
+	if (list)
+		list->textUNICODE(rect, fcolor, bcolor, text);
+	target->textUNICODE(rect, fcolor, bcolor, text);
+}
+
+void *ViewRenderTee::loadBMP(const char *name)
+{
+	return target->loadBMP(name);
+}
+
+bool ViewRenderTee::unloadBMP(void *bmp)
+{
+	return target->unloadBMP(bmp);
+}
+
+void ViewRenderTee::drawBMP(void *bmp, const Rectangle &rect)
+{
+	if (list)
+		list->drawBMP(bmp, rect);
+	target->drawBMP(bmp, rect);
+}
+
+void ViewRenderTee::loadBMPAsync(const char *name, View *requester, BitmapCallback callback)
+{
+	target->loadBMPAsync(name, requester, callback);
+}
+
+void ViewRenderTee::completeBMPAsync(void)
+{
+	target->completeBMPAsync();
+}
+
+void ViewRenderTee::cancelBMPAsync(View *requester)
+{
+	target->cancelBMPAsync(requester);
+}
+
+void ViewRenderTee::start(void)
+{
+	target->start();
+}
+
+void ViewRenderTee::show(void)
+{
+	target->show();
+}
+
+void ViewRenderTee::showOutline(const Rectangle &rect, uint32_t color)
+{
+	target->showOutline(rect, color);
+}
+
+void ViewRenderTee::clear(uint32_t color)
+{
+	if (list)
+		list->clear(color);
+	target->clear(color);
+}
+
+void *ViewRenderTee::createBuffer(const Rectangle &rect)
+{
+	return target->createBuffer(rect);
+}
+
+void ViewRenderTee::releaseBuffer(const void *buffer)
+{
+	target->releaseBuffer(buffer);
+}
+
+void ViewRenderTee::setBuffer(const void *buffer)
+{
+	target->setBuffer(buffer);
+}
+
+void ViewRenderTee::writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem)
+{
+	target->writeBuffer(buffer, rect, vidmem);
+}
+
+void ViewRenderTee::setClipping(const Rectangle *clip)
+{
+	target->setClipping(clip);
+}
\ No newline at end of file
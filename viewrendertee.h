@@ -0,0 +1,87 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VIEWRENDERTEE_H_
+#define _VIEWRENDERTEE_H_
+
+#include "viewrender.h"
+#include "rendercommandlist.h"
+
+/*
+ * ViewRenderTee forwards all calls to a renderer and, while a command
+ * list is set, copies the drawing primitives to the list as well.
+ * Buffer management and frame control are forwarded only.
+ */
+class ViewRenderTee : public ViewRender
+{
+public:
+	/*
+	 * PARAMETERS IN
+	 * ViewRender *target - the renderer receiving the calls, it is not
+	 *                      owned by the tee
+	 */
+	ViewRenderTee(ViewRender *target);
+	virtual void line(const Point &a, const Point &b, uint32_t color) override;
+	virtual void hline(const Point &a, int len, uint32_t color) override;
+	virtual void vline(const Point &a, int len, uint32_t color) override;
+	virtual void rectangle(const Rectangle &rect, int len, uint32_t color) override;
+	virtual void filledRectangle(const Rectangle &rect, uint32_t color) override;
+	virtual void filledRectangle2(const Rectangle &rect, uint32_t colors[2]) override;
+	virtual void frame(const Rectangle &rect, int len, uint32_t colors[2], bool inner) override;
+	virtual void fillRects(const Rectangle *rects, int n, uint32_t color) override;
+	virtual void fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors) override;
+	virtual void lines(const Point *points, int n, uint32_t color) override;
+	virtual void textBox(const char *text, Rectangle &out) override;
+	virtual void text(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const char *text) override;
+	virtual void textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const uint16_t *text) override;
+	virtual void *loadBMP(const char *name) override;
+	virtual bool unloadBMP(void *bmp) override;
+	virtual void drawBMP(void *bmp, const Rectangle &rect) override;
+	virtual void loadBMPAsync(const char *name, View *requester, BitmapCallback callback) override;
+	virtual void completeBMPAsync(void) override;
+	virtual void cancelBMPAsync(View *requester) override;
+	virtual void start(void) override;
+	virtual void show(void) override;
+	virtual void showOutline(const Rectangle &rect, uint32_t color) override;
+	virtual void clear(uint32_t color) override;
+	virtual void *createBuffer(const Rectangle &rect) override;
+	virtual void releaseBuffer(const void *buffer) override;
+	virtual void setBuffer(const void *buffer) override;
+	virtual void writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem) override;
+	virtual void setClipping(const Rectangle *clip) override;
+
+	inline void setTarget(ViewRender *target) { this->target = target; }
+	inline ViewRender *getTarget(void) { return target; }
+
+	/*
+	 * Set the list receiving the copy of the drawing primitives,
+	 * nullptr stops copying.
+	 *
+	 * PARAMETERS IN
+	 * RenderCommandList *list - the command list
+	 */
+	inline void setList(RenderCommandList *list) { this->list = list; }
+	inline RenderCommandList *getList(void) { return list; }
+
+private:
+	ViewRender *target;
+	RenderCommandList *list;
+};
+
+#endif
\ No newline at end of file
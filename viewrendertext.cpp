@@ -0,0 +1,622 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "viewrendertext.h"
+#include "viewrendervga.h"
+
+// Connections of a box drawing character
+#define BOX_UP 1
+#define BOX_DOWN 2
+#define BOX_LEFT 4
+#define BOX_RIGHT 8
+
+// CP437 single line box drawing characters, indexed by connections
+static const uint8_t boxChars[16] = {0x20, 0xB3, 0xB3, 0xB3, 0xC4, 0xD9, 0xBF, 0xB4,
+				     0xC4, 0xC0, 0xDA, 0xC3, 0xC4, 0xC1, 0xC2, 0xC5};
+
+// UTF-8 encoding of the CP437 characters drawn, for terminals
+static const struct
+{
+	uint8_t ch;
+	const char *utf8;
+} boxUTF8[] = {
+    {0xB3, "\xE2\x94\x82"}, {0xC4, "\xE2\x94\x80"}, {0xDA, "\xE2\x94\x8C"}, {0xBF, "\xE2\x94\x90"},
+    {0xC0, "\xE2\x94\x94"}, {0xD9, "\xE2\x94\x98"}, {0xC3, "\xE2\x94\x9C"}, {0xB4, "\xE2\x94\xA4"},
+    {0xC2, "\xE2\x94\xAC"}, {0xC1, "\xE2\x94\xB4"}, {0xC5, "\xE2\x94\xBC"}};
+
+// ANSI color numbers of the VGA colors 0 - 7
+static const int ansiColors[8] = {0, 4, 2, 6, 1, 5, 3, 7};
+
+static inline uint16_t makeCell(uint8_t ch, uint8_t fg, uint8_t bg)
+{
+	return (uint16_t)(ch | (fg << 8) | (bg << 12));
+}
+
+static inline uint8_t fgOf(uint16_t cell) { return (cell >> 8) & 0x0F; }
+static inline uint8_t bgOf(uint16_t cell) { return cell >> 12; }
+
+#define BLANK_CELL makeCell(' ', 7, 0)
+
+static inline uint16_t charCode(char ch) { return (uint8_t)ch; }
+static inline uint16_t charCode(uint16_t ch) { return ch; }
+
+static uint8_t boxMask(uint8_t ch)
+{
+	switch (ch)
+	{
+	case 0xB3:
+		return BOX_UP | BOX_DOWN;
+	case 0xC4:
+		return BOX_LEFT | BOX_RIGHT;
+	case 0xD9:
+		return BOX_UP | BOX_LEFT;
+	case 0xBF:
+		return BOX_DOWN | BOX_LEFT;
+	case 0xC0:
+		return BOX_UP | BOX_RIGHT;
+	case 0xDA:
+		return BOX_DOWN | BOX_RIGHT;
+	case 0xB4:
+		return BOX_UP | BOX_DOWN | BOX_LEFT;
+	case 0xC3:
+		return BOX_UP | BOX_DOWN | BOX_RIGHT;
+	case 0xC1:
+		return BOX_UP | BOX_LEFT | BOX_RIGHT;
+	case 0xC2:
+		return BOX_DOWN | BOX_LEFT | BOX_RIGHT;
+	case 0xC5:
+		return BOX_UP | BOX_DOWN | BOX_LEFT | BOX_RIGHT;
+	}
+
+	return 0;
+}
+
+/*
+ * Cell including the pixel coordinate v, rounding down negative values too.
+ */
+static inline int cellOf(int v, int size)
+{
+	return (v >= 0) ? v / size : -((size - 1 - v) / size);
+}
+
+static inline uint8_t colorIndex(uint32_t color)
+{
+	return PixelVGA16::pack(color);
+}
+
+ViewRenderText::ViewRenderText(int xres, int yres, uint16_t *videomem) : ViewRender(xres, yres, PixelVGA16::bitsPerPixel),
+									 screen(xres / TEXT_CELL_WIDTH, yres / TEXT_CELL_HEIGHT),
+									 current(&screen),
+									 shown(new uint16_t[screen.getXRes() * screen.getYRes()]),
+									 shownValid(false),
+									 videomem(videomem),
+									 clipped(false),
+									 saved(nullptr),
+									 outline(false)
+{
+	screen.setBuffer(BLANK_CELL);
+}
+
+ViewRenderText::~ViewRenderText()
+{
+	delete[] shown;
+	delete[] saved;
+}
+
+/*
+ * Clip an area of cells to the drawing target.
+ *
+ * PARAMETERS IN/OUT
+ *  Rectangle &cells - the area, clipped on return
+ *
+ * RETURN
+ * false if nothing is left to draw
+ */
+bool ViewRenderText::cellArea(Rectangle &cells)
+{
+	Rectangle limits(0, 0, current->getXRes() - 1, current->getYRes() - 1);
+
+	if ((cells.lr.x < cells.ul.x) || (cells.lr.y < cells.ul.y) || !cells.intersect(limits))
+		return false;
+	cells.intersection(limits);
+
+	if ((current == &screen) && clipped)
+	{
+		Rectangle clip(cellOf(clipping.ul.x, TEXT_CELL_WIDTH), cellOf(clipping.ul.y, TEXT_CELL_HEIGHT),
+			       cellOf(clipping.lr.x, TEXT_CELL_WIDTH), cellOf(clipping.lr.y, TEXT_CELL_HEIGHT));
+		if (!cells.intersect(clip))
+			return false;
+		cells.intersection(clip);
+	}
+
+	return true;
+}
+
+void ViewRenderText::fillCells(const Rectangle &cells, uint8_t bg)
+{
+	current->fill(cells.ul.x, cells.ul.y, cells.width(), cells.height(), makeCell(' ', 7, bg));
+}
+
+/*
+ * Connections of the box drawing character in a cell.
+ * Characters cannot tell the end of a line, e.g. a line going right and one
+ * going left and right look the same: only the connections reaching a
+ * line in the next cell are kept.
+ */
+uint8_t ViewRenderText::joints(int x, int y)
+{
+	uint8_t mask = boxMask(current->getBufferXY(x, y) & 0xFF);
+
+	if ((mask & BOX_UP) && !(boxMask(current->getBufferXY(x, y - 1) & 0xFF) & BOX_DOWN))
+		mask &= ~BOX_UP;
+	if ((mask & BOX_DOWN) && !(boxMask(current->getBufferXY(x, y + 1) & 0xFF) & BOX_UP))
+		mask &= ~BOX_DOWN;
+	if ((mask & BOX_LEFT) && !(boxMask(current->getBufferXY(x - 1, y) & 0xFF) & BOX_RIGHT))
+		mask &= ~BOX_LEFT;
+	if ((mask & BOX_RIGHT) && !(boxMask(current->getBufferXY(x + 1, y) & 0xFF) & BOX_LEFT))
+		mask &= ~BOX_RIGHT;
+
+	return mask;
+}
+
+/*
+ * Draw a horizontal or vertical line of box drawing characters, joined
+ * to the lines already in the cells.
+ */
+void ViewRenderText::boxLine(int x0, int y0, int x1, int y1, uint8_t fg)
+{
+	bool horizontal = (y0 == y1);
+	Rectangle cells(std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1));
+	Rectangle area;
+
+	area = cells;
+	if (!cellArea(area))
+		return;
+
+	for (int y = area.ul.y; y <= area.lr.y; y++)
+		for (int x = area.ul.x; x <= area.lr.x; x++)
+		{
+			uint8_t mask;
+
+			if (horizontal)
+			{
+				mask = ((x > cells.ul.x) ? BOX_LEFT : 0) | ((x < cells.lr.x) ? BOX_RIGHT : 0);
+				if (!mask)
+					mask = BOX_LEFT | BOX_RIGHT;
+			}
+			else
+			{
+				mask = ((y > cells.ul.y) ? BOX_UP : 0) | ((y < cells.lr.y) ? BOX_DOWN : 0);
+				if (!mask)
+					mask = BOX_UP | BOX_DOWN;
+			}
+
+			uint16_t old = current->getBufferXY(x, y);
+			mask |= joints(x, y);
+			current->setBufferXY(x, y, makeCell(boxChars[mask], fg, bgOf(old)));
+		}
+}
+
+void ViewRenderText::drawRect(const Rectangle &rect, uint32_t color)
+{
+	// The cells covered completely are filled
+	Rectangle cells(cellOf(rect.ul.x + TEXT_CELL_WIDTH - 1, TEXT_CELL_WIDTH),
+			cellOf(rect.ul.y + TEXT_CELL_HEIGHT - 1, TEXT_CELL_HEIGHT),
+			cellOf(rect.lr.x + 1, TEXT_CELL_WIDTH) - 1,
+			cellOf(rect.lr.y + 1, TEXT_CELL_HEIGHT) - 1);
+
+	if ((cells.lr.x >= cells.ul.x) && (cells.lr.y >= cells.ul.y))
+	{
+		if (cellArea(cells))
+			fillCells(cells, colorIndex(color));
+		return;
+	}
+
+	// Thinner than a cell: a line through the cells it crosses
+	if (rect.width() >= rect.height())
+	{
+		int y = cellOf((rect.ul.y + rect.lr.y) / 2, TEXT_CELL_HEIGHT);
+		boxLine(cellOf(rect.ul.x, TEXT_CELL_WIDTH), y, cellOf(rect.lr.x, TEXT_CELL_WIDTH), y, colorIndex(color));
+	}
+	else
+	{
+		int x = cellOf((rect.ul.x + rect.lr.x) / 2, TEXT_CELL_WIDTH);
+		boxLine(x, cellOf(rect.ul.y, TEXT_CELL_HEIGHT), x, cellOf(rect.lr.y, TEXT_CELL_HEIGHT), colorIndex(color));
+	}
+}
+
+void ViewRenderText::line(const Point &a, const Point &b, uint32_t color)
+{
+	int x0 = cellOf(a.x, TEXT_CELL_WIDTH);
+	int y0 = cellOf(a.y, TEXT_CELL_HEIGHT);
+	int x1 = cellOf(b.x, TEXT_CELL_WIDTH);
+	int y1 = cellOf(b.y, TEXT_CELL_HEIGHT);
+
+	if ((x0 == x1) || (y0 == y1))
+	{
+		boxLine(x0, y0, x1, y1, colorIndex(color));
+		return;
+	}
+
+	uint8_t ch = ((x1 - x0) * (y1 - y0) > 0) ? '\\' : '/';
+	uint8_t fg = colorIndex(color);
+	int steps = std::max(std::abs(x1 - x0), std::abs(y1 - y0));
+
+	for (int i = 0; i <= steps; i++)
+	{
+		Rectangle cell;
+		cell.ul.x = cell.lr.x = x0 + (x1 - x0) * i / steps;
+		cell.ul.y = cell.lr.y = y0 + (y1 - y0) * i / steps;
+		if (cellArea(cell))
+			current->setBufferXY(cell.ul.x, cell.ul.y, makeCell(ch, fg, bgOf(current->getBufferXY(cell.ul.x, cell.ul.y))));
+	}
+}
+
+void ViewRenderText::hline(const Point &a, int len, uint32_t color)
+{
+	int y = cellOf(a.y, TEXT_CELL_HEIGHT);
+
+	boxLine(cellOf(a.x, TEXT_CELL_WIDTH), y, cellOf(a.x + len, TEXT_CELL_WIDTH), y, colorIndex(color));
+}
+
+void ViewRenderText::vline(const Point &a, int len, uint32_t color)
+{
+	int x = cellOf(a.x, TEXT_CELL_WIDTH);
+
+	boxLine(x, cellOf(a.y, TEXT_CELL_HEIGHT), x, cellOf(a.y + len, TEXT_CELL_HEIGHT), colorIndex(color));
+}
+
+void ViewRenderText::rectangle(const Rectangle &rect, int /*len*/, uint32_t color)
+{
+	// The layers would fall in the same cells
+	Rectangle rects[4];
+	int n = rectangleRects(rect, 1, color, rects, nullptr);
+
+	for (int i = 0; i < n; i++)
+		drawRect(rects[i], color);
+}
+
+void ViewRenderText::filledRectangle(const Rectangle &rect, uint32_t color)
+{
+	drawRect(rect, color);
+}
+
+void ViewRenderText::filledRectangle2(const Rectangle &rect, uint32_t colors[2])
+{
+	Rectangle inner;
+
+	inner = rect;
+	inner.zoom(-1, -1);
+	drawRect(inner, colors[1]);
+	rectangle(rect, 1, colors[0]);
+}
+
+void ViewRenderText::frame(const Rectangle &rect, int /*len*/, uint32_t colors[2], bool inner)
+{
+	Rectangle rects[4];
+	uint32_t rcolors[4];
+	int n = frameRects(rect, 1, colors, inner, rects, rcolors);
+
+	for (int i = 0; i < n; i++)
+		drawRect(rects[i], rcolors[i]);
+}
+
+void ViewRenderText::fillRects(const Rectangle *rects, int n, uint32_t color)
+{
+	for (int i = 0; i < n; i++)
+		drawRect(rects[i], color);
+}
+
+void ViewRenderText::fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors)
+{
+	for (int i = 0; i < n; i++)
+		drawRect(rects[i], colors[i]);
+}
+
+void ViewRenderText::lines(const Point *points, int n, uint32_t color)
+{
+	for (int i = 1; i < n; i++)
+		line(points[i - 1], points[i], color);
+}
+
+void ViewRenderText::textBox(const char *text, Rectangle &out)
+{
+	int len = (text) ? (int)strlen(text) : 0;
+
+	out = Rectangle(0, 0, len * TEXT_CELL_WIDTH, TEXT_CELL_HEIGHT);
+}
+
+/*
+ * Write the characters on the row of cells in the middle of rect.
+ */
+template <typename T> void ViewRenderText::putText(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const T *text, int len)
+{
+	int x0 = cellOf(rect.ul.x, TEXT_CELL_WIDTH);
+	int y = cellOf((rect.ul.y + rect.lr.y) / 2, TEXT_CELL_HEIGHT);
+	Rectangle cells(x0, y, cellOf(rect.lr.x, TEXT_CELL_WIDTH), y);
+	uint8_t fg = colorIndex(fcolor);
+	uint8_t bg = colorIndex(bcolor);
+
+	if (!cellArea(cells))
+		return;
+
+	for (int x = std::max(x0, cells.ul.x); (x <= cells.lr.x) && (x - x0 < len); x++)
+	{
+		uint16_t ch = charCode(text[x - x0]);
+		current->setBufferXY(x, y, makeCell((ch < 256) ? (uint8_t)ch : '?', fg, bg));
+	}
+}
+
+void ViewRenderText::text(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const char *text)
+{
+	if (!text)
+		return;
+
+	int len = 0;
+	while (text[len] && (len < current->getXRes()))
+		len++;
+	putText(rect, fcolor, bcolor, text, len);
+}
+
+void ViewRenderText::textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const uint16_t *text)
+{
+	if (!text)
+		return;
+
+	int len = 0;
+	while (text[len] && (len < current->getXRes()))
+		len++;
+	putText(rect, fcolor, bcolor, text, len);
+}
+
+void *ViewRenderText::loadBMP(const char * /*name*/)
+{
+	return nullptr;
+}
+
+bool ViewRenderText::unloadBMP(void * /*bmp*/)
+{
+	return false;
+}
+
+void ViewRenderText::drawBMP(void * /*bmp*/, const Rectangle & /*rect*/)
+{
+}
+
+/*
+ * Save or restore the screen cells below the outline: the border of
+ * outlineCells, the only cells changed by rectangle().
+ */
+void ViewRenderText::swapOutline(bool restore)
+{
+	const Rectangle &c = outlineCells;
+	int n = 0;
+
+	for (int y = std::max(c.ul.y, 0); y <= std::min(c.lr.y, screen.getYRes() - 1); y++)
+	{
+		bool edge = (y == c.ul.y) || (y == c.lr.y);
+
+		for (int x = std::max(c.ul.x, 0); x <= std::min(c.lr.x, screen.getXRes() - 1); x++)
+		{
+			// The rows in between have only their first and last cell
+			if (!edge && (x > c.ul.x) && (x < c.lr.x))
+			{
+				x = c.lr.x - 1;
+				continue;
+			}
+
+			if (restore)
+				screen.setBufferXY(x, y, saved[n++]);
+			else
+				saved[n++] = screen.getBufferXY(x, y);
+		}
+	}
+}
+
+void ViewRenderText::start()
+{
+	if (outline)
+	{
+		swapOutline(true);
+		outline = false;
+	}
+
+	current = &screen;
+	if (!clipped)
+		screen.setBuffer(BLANK_CELL);
+}
+
+void ViewRenderText::show()
+{
+	emit();
+}
+
+void ViewRenderText::showOutline(const Rectangle &rect, uint32_t color)
+{
+	if (outline)
+		swapOutline(true);
+	else if (!saved)
+		saved = new uint16_t[2 * (screen.getXRes() + screen.getYRes())];
+
+	outlineCells = Rectangle(cellOf(std::min(rect.ul.x, rect.lr.x), TEXT_CELL_WIDTH), cellOf(std::min(rect.ul.y, rect.lr.y), TEXT_CELL_HEIGHT),
+				 cellOf(std::max(rect.ul.x, rect.lr.x), TEXT_CELL_WIDTH), cellOf(std::max(rect.ul.y, rect.lr.y), TEXT_CELL_HEIGHT));
+	swapOutline(false);
+	outline = true;
+
+	// The outline is not clipped
+	TextBuffer *target = current;
+	bool clip = clipped;
+	current = &screen;
+	clipped = false;
+	rectangle(rect, 1, color);
+	current = target;
+	clipped = clip;
+
+	emit();
+}
+
+void ViewRenderText::clear(uint32_t color)
+{
+	Rectangle cells(0, 0, current->getXRes() - 1, current->getYRes() - 1);
+
+	if (cellArea(cells))
+		fillCells(cells, colorIndex(color));
+}
+
+void *ViewRenderText::createBuffer(const Rectangle &rect)
+{
+	TextBuffer *buffer = new TextBuffer(std::max((rect.width() + TEXT_CELL_WIDTH - 1) / TEXT_CELL_WIDTH, 1),
+					    std::max((rect.height() + TEXT_CELL_HEIGHT - 1) / TEXT_CELL_HEIGHT, 1));
+
+	buffer->setBuffer(BLANK_CELL);
+	return buffer;
+}
+
+void ViewRenderText::releaseBuffer(const void *buffer)
+{
+	const TextBuffer *b = static_cast<const TextBuffer *>(buffer);
+
+	if (!b)
+		return;
+
+	if (current == b)
+		current = &screen;
+	delete b;
+}
+
+void ViewRenderText::setBuffer(const void *buffer)
+{
+	current = (buffer) ? static_cast<TextBuffer *>(const_cast<void *>(buffer)) : &screen;
+}
+
+void ViewRenderText::writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem)
+{
+	const TextBuffer *src = static_cast<const TextBuffer *>(buffer);
+
+	current = &screen;
+	if (!src)
+		return;
+
+	Rectangle cells(cellOf(vidmem.ul.x, TEXT_CELL_WIDTH), cellOf(vidmem.ul.y, TEXT_CELL_HEIGHT),
+			cellOf(vidmem.lr.x, TEXT_CELL_WIDTH), cellOf(vidmem.lr.y, TEXT_CELL_HEIGHT));
+	Rectangle dest;
+	dest = cells;
+	if (!cellArea(dest))
+		return;
+
+	// Buffers are copied 1:1, shrink the source by the clipped amount
+	int sx = cellOf(rect.ul.x, TEXT_CELL_WIDTH) + dest.ul.x - cells.ul.x;
+	int sy = cellOf(rect.ul.y, TEXT_CELL_HEIGHT) + dest.ul.y - cells.ul.y;
+
+	screen.copy(*src, sx, sy, dest.width(), dest.height(), dest.ul.x, dest.ul.y);
+}
+
+void ViewRenderText::setClipping(const Rectangle *clip)
+{
+	if (clip)
+	{
+		clipping = *clip;
+		clipped = true;
+	}
+	else
+		clipped = false;
+}
+
+/*
+ * Send the changed cells of the screen to the display.
+ * Each frame rewrites the screen, the dirty cells are compared to the ones
+ * shown to send only the different ones.
+ */
+void ViewRenderText::emit()
+{
+	int columns = screen.getXRes();
+
+	for (int y = screen.nextDirtyRow(0); y >= 0; y = screen.nextDirtyRow(y + 1))
+	{
+		const uint16_t *row = screen.getRow(y);
+		uint16_t *old = shown + y * columns;
+		int first, last;
+
+		screen.getDirtySpan(y, first, last);
+
+		if (videomem)
+		{
+			for (int x = first; x <= last; x++)
+				if (!shownValid || (row[x] != old[x]))
+				{
+					videomem[y * columns + x] = toLE16(row[x]);
+					old[x] = row[x];
+				}
+			continue;
+		}
+
+		// The cursor is moved to the first cell of each run of changed cells
+		int attr = -1;
+		int cursor = -1;
+		for (int x = first; x <= last; x++)
+		{
+			if (shownValid && (row[x] == old[x]))
+				continue;
+			old[x] = row[x];
+
+			if (x != cursor)
+				out += "\x1b[" + std::to_string(y + 1) + ";" + std::to_string(x + 1) + "H";
+			cursor = x + 1;
+
+			uint8_t fg = fgOf(row[x]);
+			uint8_t bg = bgOf(row[x]);
+			uint8_t ch = row[x] & 0xFF;
+
+			if ((row[x] >> 8) != attr)
+			{
+				attr = row[x] >> 8;
+				out += "\x1b[" + std::to_string(((fg < 8) ? 30 : 90) + ansiColors[fg & 7]) + ";" +
+				       std::to_string(((bg < 8) ? 40 : 100) + ansiColors[bg & 7]) + "m";
+			}
+
+			if ((ch >= 0x20) && (ch < 0x7F))
+			{
+				out += (char)ch;
+				continue;
+			}
+
+			const char *utf8 = "?";
+			for (unsigned i = 0; i < sizeof(boxUTF8) / sizeof(boxUTF8[0]); i++)
+				if (boxUTF8[i].ch == ch)
+					utf8 = boxUTF8[i].utf8;
+			out += utf8;
+		}
+	}
+
+	if (!videomem && !out.empty())
+	{
+		out += "\x1b[0m";
+		std::cout << out << std::flush;
+		out.clear();
+	}
+
+	// The first frame sent all the cells, the screen starts dirty
+	shownValid = true;
+	screen.clearDirty();
+}
\ No newline at end of file
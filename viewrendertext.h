@@ -0,0 +1,108 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VIEWRENDERTEXT_H_
+#define _VIEWRENDERTEXT_H_
+
+#include <string>
+
+#include "viewrender.h"
+#include "textbuffer.h"
+
+// Size in pixels of a character cell
+#define TEXT_CELL_WIDTH 8
+#define TEXT_CELL_HEIGHT 16
+
+/*
+ * ViewRenderText maps the GUI onto a grid of character cells, one cell
+ * every TEXT_CELL_WIDTH x TEXT_CELL_HEIGHT pixels, with the 16 colors of
+ * the VGA text mode.
+ * Fills set the background of the cells they cover completely, rectangles
+ * thinner than a cell become box drawing characters, text goes straight
+ * into the cells.
+ * show() sends the cells changed since the last frame shown to the VGA
+ * text memory, if available, otherwise to the standard output as ANSI
+ * escape sequences, e.g. for a serial console.
+ */
+class ViewRenderText final : public ViewRender
+{
+public:
+	/*
+	 * PARAMETERS IN
+	 * int xres, int yres - the resolution in pixels
+	 * uint16_t *videomem - the VGA text memory, NULL to use a terminal
+	 */
+	ViewRenderText(int xres, int yres, uint16_t *videomem = nullptr);
+	virtual ~ViewRenderText();
+
+	virtual void line(const Point &a, const Point &b, uint32_t color) override;
+	virtual void hline(const Point &a, int len, uint32_t color) override;
+	virtual void vline(const Point &a, int len, uint32_t color) override;
+	virtual void rectangle(const Rectangle &rect, int len, uint32_t color) override;
+	virtual void filledRectangle(const Rectangle &rect, uint32_t color) override;
+	virtual void filledRectangle2(const Rectangle &rect, uint32_t colors[2]) override;
+	virtual void frame(const Rectangle &rect, int len, uint32_t colors[2], bool inner) override;
+	virtual void fillRects(const Rectangle *rects, int n, uint32_t color) override;
+	virtual void fillRectsColored(const Rectangle *rects, int n, const uint32_t *colors) override;
+	virtual void lines(const Point *points, int n, uint32_t color) override;
+	virtual void textBox(const char *text, Rectangle &out) override;
+	virtual void text(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const char *text) override;
+	virtual void textUNICODE(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const uint16_t *text) override;
+	virtual void *loadBMP(const char *name) override;
+	virtual bool unloadBMP(void *bmp) override;
+	virtual void drawBMP(void *bmp, const Rectangle &rect) override;
+	virtual void start(void) override;
+	virtual void show(void) override;
+	virtual void showOutline(const Rectangle &rect, uint32_t color) override;
+	virtual void clear(uint32_t color) override;
+	virtual void *createBuffer(const Rectangle &rect) override;
+	virtual void releaseBuffer(const void *buffer) override;
+	virtual void setBuffer(const void *buffer) override;
+	virtual void writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem) override;
+	virtual void setClipping(const Rectangle *clip) override;
+
+	inline const TextBuffer &getScreen(void) const { return screen; }
+
+private:
+	bool cellArea(Rectangle &cells);
+	void fillCells(const Rectangle &cells, uint8_t bg);
+	uint8_t joints(int x, int y);
+	void boxLine(int x0, int y0, int x1, int y1, uint8_t fg);
+	void drawRect(const Rectangle &rect, uint32_t color);
+	template <typename T> void putText(const Rectangle &rect, uint32_t fcolor, uint32_t bcolor, const T *text, int len);
+	void swapOutline(bool restore);
+	void emit(void);
+
+	TextBuffer screen;
+	TextBuffer *current;
+	// The cells on the display, valid after the first frame
+	uint16_t *shown;
+	bool shownValid;
+	uint16_t *videomem;
+	Rectangle clipping;
+	bool clipped;
+	// Screen cells below the outline traced by showOutline(), the border of outlineCells
+	uint16_t *saved;
+	Rectangle outlineCells;
+	bool outline;
+	// ANSI output of a frame
+	std::string out;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,309 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#include "viewrendervga.h"
+
+// The default colors of the VGA DAC in 16 colors modes
+static uint32_t dac[16] = {0x000000, 0x0000AA, 0x00AA00, 0x00AAAA, 0xAA0000, 0xAA00AA, 0xAA5500, 0xAAAAAA,
+			   0x555555, 0x5555FF, 0x55FF55, 0x55FFFF, 0xFF5555, 0xFF55FF, 0xFFFF55, 0xFFFFFF};
+
+/*
+ * Direct mapped cache of the quantized colors.
+ * Entries hold the color in the low 24 bits and the index in the high 8,
+ * empty entries are marked by an invalid index.
+ */
+#define QCACHE_SIZE 256
+#define QCACHE_EMPTY 0xFF000000
+
+static uint32_t qcache[QCACHE_SIZE];
+static bool qcacheValid = false;
+
+static uint8_t nearest(uint32_t rgb)
+{
+	uint8_t best = 0;
+	int bestDist = 0x7FFFFFFF;
+
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		int dr = (int)redOf(rgb) - (int)redOf(dac[i]);
+		int dg = (int)greenOf(rgb) - (int)greenOf(dac[i]);
+		int db = (int)blueOf(rgb) - (int)blueOf(dac[i]);
+		// Weighted as the eye perceives the components
+		int dist = 3 * dr * dr + 4 * dg * dg + 2 * db * db;
+		if (dist < bestDist)
+		{
+			bestDist = dist;
+			best = i;
+		}
+	}
+
+	return best;
+}
+
+PixelVGA16::pixel_t PixelVGA16::pack(uint32_t argb)
+{
+	uint32_t rgb = argb & 0x00FFFFFF;
+
+	if (!qcacheValid)
+	{
+		for (unsigned i = 0; i < QCACHE_SIZE; i++)
+			qcache[i] = QCACHE_EMPTY;
+		qcacheValid = true;
+	}
+
+	uint32_t &entry = qcache[(rgb * 2654435761u) >> 24];
+	if ((entry == QCACHE_EMPTY) || ((entry & 0x00FFFFFF) != rgb))
+		entry = rgb | ((uint32_t)nearest(rgb) << 24);
+
+	return (pixel_t)(entry >> 24);
+}
+
+uint32_t PixelVGA16::unpack(pixel_t pixel)
+{
+	return dac[pixel & 0x0F] | 0xFF000000;
+}
+
+void ViewRenderVGA::setDAC(const uint32_t colors[16])
+{
+	for (int i = 0; i < 16; i++)
+		dac[i] = colors[i] & 0x00FFFFFF;
+	qcacheValid = false;
+}
+
+/*
+ * Transpose the 8x8 bit matrix made of the bytes of x, most significant
+ * byte first (Hacker's Delight, 7-3).
+ * With the bytes holding 8 pixels, left to right, byte n of the result
+ * (least significant first) holds bit n of each pixel: the byte of plane n.
+ */
+static inline uint64_t transpose8(uint64_t x)
+{
+	uint64_t t;
+
+	t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+	x = x ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x = x ^ t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x = x ^ t ^ (t << 28);
+	return x;
+}
+
+VGAPlanes::VGAPlanes(int xres, int yres) : pitch((xres + 7) / 8), rows(yres)
+{
+	for (int n = 0; n < 4; n++)
+		planes[n] = new uint8_t[pitch * rows]();
+}
+
+VGAPlanes::~VGAPlanes()
+{
+	for (int n = 0; n < 4; n++)
+		delete[] planes[n];
+}
+
+void VGAPlanes::fill(const Rectangle &rect, uint8_t color, uint8_t mapMask)
+{
+	int first = rect.ul.x / 8;
+	int last = rect.lr.x / 8;
+	uint8_t leftMask = 0xFF >> (rect.ul.x & 7);
+	uint8_t rightMask = 0xFF << (7 - (rect.lr.x & 7));
+
+	if (first == last)
+	{
+		leftMask &= rightMask;
+		rightMask = leftMask;
+	}
+
+	for (int n = 0; n < 4; n++)
+	{
+		if (!(mapMask & (1 << n)))
+			continue;
+
+		uint8_t value = (color & (1 << n)) ? 0xFF : 0x00;
+		for (int y = rect.ul.y; y <= rect.lr.y; y++)
+		{
+			uint8_t *row = planes[n] + y * pitch;
+
+			row[first] = (row[first] & ~leftMask) | (value & leftMask);
+			if (last > first)
+			{
+				memset(row + first + 1, value, last - first - 1);
+				row[last] = (row[last] & ~rightMask) | (value & rightMask);
+			}
+		}
+	}
+}
+
+void VGAPlanes::convert(const uint8_t *chunky, int x, int y, int n)
+{
+	uint8_t *dst[4];
+	int offset = y * pitch + x / 8;
+
+	for (int p = 0; p < 4; p++)
+		dst[p] = planes[p] + offset;
+
+	for (; n > 0; n -= 8, chunky += 8)
+	{
+		uint8_t group[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		const uint8_t *src = chunky;
+
+		// Last pixels of the row
+		if (n < 8)
+		{
+			memcpy(group, chunky, n);
+			src = group;
+		}
+
+		uint64_t x = ((uint64_t)src[0] << 56) | ((uint64_t)src[1] << 48) | ((uint64_t)src[2] << 40) | ((uint64_t)src[3] << 32) |
+			     ((uint64_t)src[4] << 24) | ((uint64_t)src[5] << 16) | ((uint64_t)src[6] << 8) | (uint64_t)src[7];
+		x = transpose8(x);
+
+		*dst[0]++ = (uint8_t)x;
+		*dst[1]++ = (uint8_t)(x >> 8);
+		*dst[2]++ = (uint8_t)(x >> 16);
+		*dst[3]++ = (uint8_t)(x >> 24);
+	}
+}
+
+uint8_t VGAPlanes::get(int x, int y) const
+{
+	int offset = y * pitch + x / 8;
+	int bit = 7 - (x & 7);
+	uint8_t color = 0;
+
+	for (int n = 0; n < 4; n++)
+		color |= ((planes[n][offset] >> bit) & 1) << n;
+
+	return color;
+}
+
+ViewRenderVGA::ViewRenderVGA(int xres, int yres) : ViewRenderSW<PixelVGA16>(xres, yres, PixelVGA16::bitsPerPixel),
+						   planes(xres, yres),
+						   isDirty(false),
+						   outline(false)
+{
+}
+
+void ViewRenderVGA::invalidate(const Rectangle &area)
+{
+	if (isDirty)
+	{
+		Rectangle temp;
+		temp = area;
+		dirty.join(temp);
+	}
+	else
+		dirty = area;
+
+	isDirty = true;
+}
+
+void ViewRenderVGA::start()
+{
+	// The pixels below the outline are restored in the shadow screen
+	if (outline)
+		invalidate(outlineArea);
+	outline = false;
+
+	ViewRenderSW<PixelVGA16>::start();
+	if (!clipped)
+		planes.fill(Rectangle(0, 0, xres - 1, yres - 1), PixelVGA16::pack(0));
+}
+
+void ViewRenderVGA::showOutline(const Rectangle &rect, uint32_t color)
+{
+	Rectangle screenArea(0, 0, xres - 1, yres - 1);
+
+	if (outline)
+		invalidate(outlineArea);
+
+	outlineArea = rect;
+	outline = outlineArea.intersect(screenArea);
+	if (outline)
+	{
+		outlineArea.intersection(screenArea);
+		invalidate(outlineArea);
+	}
+
+	ViewRenderSW<PixelVGA16>::showOutline(rect, color);
+}
+
+void ViewRenderVGA::clear(uint32_t color)
+{
+	ViewRenderSW<PixelVGA16>::clear(color);
+
+	if (current != &screen)
+		return;
+
+	Rectangle area(0, 0, xres - 1, yres - 1);
+	if (clipped)
+	{
+		if (!area.intersect(clipping))
+			return;
+		area.intersection(clipping);
+	}
+	planes.fill(area, PixelVGA16::pack(color));
+}
+
+void ViewRenderVGA::setBuffer(const void *buffer)
+{
+	ViewRenderSW<PixelVGA16>::setBuffer(buffer);
+
+	// Anything can be drawn on the screen now
+	if (!buffer)
+		invalidate(Rectangle(0, 0, xres - 1, yres - 1));
+}
+
+void ViewRenderVGA::writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem)
+{
+	Rectangle area(0, 0, xres - 1, yres - 1);
+	Rectangle dest;
+
+	ViewRenderSW<PixelVGA16>::writeBuffer(buffer, rect, vidmem);
+
+	dest = vidmem;
+	if (!dest.intersect(area))
+		return;
+	dest.intersection(area);
+	if (clipped)
+	{
+		if (!dest.intersect(clipping))
+			return;
+		dest.intersection(clipping);
+	}
+	invalidate(dest);
+}
+
+void ViewRenderVGA::present()
+{
+	if (!isDirty)
+		return;
+
+	// The planes are written a byte, that is 8 pixels, at a time
+	int x = dirty.ul.x & ~7;
+	int n = std::min((dirty.lr.x | 7) + 1, xres) - x;
+
+	for (int y = dirty.ul.y; y <= dirty.lr.y; y++)
+		planes.convert(Rasterizer<PixelVGA16>::row(screen, y) + x, x, y, n);
+
+	isDirty = false;
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VIEWRENDERVGA_H_
+#define _VIEWRENDERVGA_H_
+
+#include "viewrendersw.h"
+
+/*
+ * 4 bits, index of the 16 colors of the VGA DAC.
+ * Colors are quantized to the nearest color of the DAC, the results are
+ * cached: a GUI uses few colors and each of them is looked up very often.
+ */
+struct PixelVGA16
+{
+	typedef uint8_t pixel_t;
+	static constexpr int bitsPerPixel = 4;
+
+	static pixel_t pack(uint32_t argb);
+	static uint32_t unpack(pixel_t pixel);
+};
+
+/*
+ * The 4 planes of a VGA 16 colors frame buffer, bit 7 of a byte is the
+ * leftmost of its 8 pixels.
+ */
+class VGAPlanes
+{
+public:
+	VGAPlanes(int xres, int yres);
+	~VGAPlanes();
+
+	/*
+	 * Fill a rectangle like the VGA write mode 2 does: the planes enabled
+	 * by mapMask are set to the bits of color, the pixels at the edges of
+	 * the rectangle are masked as with the bit mask register.
+	 *
+	 * PARAMETERS IN
+	 *  const Rectangle &rect - the area, already clipped to the planes
+	 *  uint8_t color - the color index
+	 *  uint8_t mapMask - planes to write, bit n enables plane n
+	 */
+	void fill(const Rectangle &rect, uint8_t color, uint8_t mapMask = 0x0F);
+
+	/*
+	 * Convert a row of 4 bit pixels, one per byte, to the planes.
+	 * x MUST be a multiple of 8, n is rounded up to a multiple of 8.
+	 *
+	 * PARAMETERS IN
+	 *  const uint8_t *chunky - the pixels
+	 *  int x, int y - position of the first pixel
+	 *  int n - number of pixels
+	 */
+	void convert(const uint8_t *chunky, int x, int y, int n);
+
+	/*
+	 * Get the color index of a pixel, reading back the 4 planes.
+	 */
+	uint8_t get(int x, int y) const;
+
+	inline uint8_t *plane(int n) { return planes[n]; }
+	inline int getPitch(void) const { return pitch; }
+
+private:
+	uint8_t *planes[4];
+	int pitch, rows;
+};
+
+/*
+ * ViewRenderVGA renders into a simulated VGA 16 colors planar frame buffer.
+ * Views draw into buffers holding one color index per byte ("chunky"
+ * pixels), the screen is composed in a shadow copy and the changed area is
+ * converted to the planes when shown. Clearing the screen writes the planes
+ * directly.
+ */
+class ViewRenderVGA final : public ViewRenderSW<PixelVGA16>
+{
+public:
+	ViewRenderVGA(int xres, int yres);
+	virtual ~ViewRenderVGA() {}
+
+	virtual void start(void) override;
+	virtual void showOutline(const Rectangle &rect, uint32_t color) override;
+	virtual void clear(uint32_t color) override;
+	virtual void setBuffer(const void *buffer) override;
+	virtual void writeBuffer(const void *buffer, const Rectangle &rect, const Rectangle &vidmem) override;
+
+	inline VGAPlanes &getPlanes(void) { return planes; }
+
+	/*
+	 * Load the 16 colors of the DAC, 0x00RRGGBB.
+	 * The views should be drawn again, their pixels were quantized with the
+	 * previous colors.
+	 */
+	static void setDAC(const uint32_t colors[16]);
+
+protected:
+	virtual void present(void) override;
+
+private:
+	void invalidate(const Rectangle &area);
+
+	VGAPlanes planes;
+	// Area of the shadow screen not converted to the planes yet
+	Rectangle dirty;
+	bool isDirty;
+	// Area of the outline shown, if any
+	Rectangle outlineArea;
+	bool outline;
+};
+
+#endif
\ No newline at end of file
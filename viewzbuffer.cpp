@@ -38,7 +38,7 @@ void ViewZBuffer::configure(Rectangle &mainscreen)
 	memset(buffer, 0, screen.width() * screen.height());
 }
 
-ViewZBuffer::ViewZBuffer() : screen(0, 0, 0, 0), buffer(nullptr)
+ViewZBuffer::ViewZBuffer() : screen(0, 0, 0, 0), clipping(0, 0, 0, 0), clipped(false), full(false), buffer(nullptr)
 {
 }
 
@@ -51,36 +51,56 @@ ViewZBuffer::~ViewZBuffer()
 void ViewZBuffer::set(Rectangle &area)
 {
 	int y, base;
+	Rectangle temp;
 
-	if (screen.includes(area))
+	temp = area;
+	if (full || (clipped && !clipArea(temp)))
+		return;
+
+	if (screen.includes(temp))
 	{
 		/*
 		 * base is the starting pointer inside the buffer.
 		 */
-		base = area.ul.y * screen.width() + area.ul.x;
+		base = temp.ul.y * screen.width() + temp.ul.x;
 
-		for (y = 0; y < area.height(); y++)
+		for (y = 0; y < temp.height(); y++)
 		{
-			memset(buffer + base, 1, area.width());
+			memset(buffer + base, 1, temp.width());
 			base += screen.width();
 		}
+
+		/*
+		 * Detect an area covering the whole (clipped) screen
+		 */
+		Rectangle whole;
+		whole = screen;
+		if (clipped)
+			whole.intersection(clipping);
+		full = temp.includes(whole);
 	}
 }
 
 void ViewZBuffer::clear(Rectangle &area)
 {
 	int y, base;
+	Rectangle temp;
 
-	if (screen.includes(area))
+	temp = area;
+	if (clipped && !clipArea(temp))
+		return;
+
+	if (screen.includes(temp))
 	{
+		full = false;
 		/*
 		 * base is the starting pointer inside the buffer.
 		 */
-		base = area.ul.y * screen.width() + area.ul.x;
+		base = temp.ul.y * screen.width() + temp.ul.x;
 
-		for (y = 0; y < area.height(); y++)
+		for (y = 0; y < temp.height(); y++)
 		{
-			memset(buffer + base, 0, area.width());
+			memset(buffer + base, 0, temp.width());
 			base += screen.width();
 		}
 	}
@@ -88,27 +108,33 @@ void ViewZBuffer::clear(Rectangle &area)
 
 void ViewZBuffer::clear()
 {
+	full = false;
 	memset(buffer, 0, screen.width() * screen.height());
 }
 
 bool ViewZBuffer::isAreaSet(Rectangle &area)
 {
 	int x, y, base;
+	Rectangle temp;
 
-	if (screen.includes(area))
+	temp = area;
+	if (full || (clipped && !clipArea(temp)))
+		return true;
+
+	if (screen.includes(temp))
 	{
 		/*
 		 * base is the starting pointer inside the buffer.
 		 */
-		base = area.ul.y * screen.width() + area.ul.x;
+		base = temp.ul.y * screen.width() + temp.ul.x;
 
-		for (y = 0; y < area.height(); y++)
+		for (y = 0; y < temp.height(); y++)
 		{
-			for (x = 0; x < area.width(); x++)
+			for (x = 0; x < temp.width(); x++)
 				if (buffer[base++] == 0)
 					return false;
 
-			base += screen.width() - area.width();
+			base += screen.width() - temp.width();
 		}
 	}
 
@@ -118,24 +144,143 @@ bool ViewZBuffer::isAreaSet(Rectangle &area)
 bool ViewZBuffer::isAreaClear(Rectangle &area)
 {
 	int x, y, base;
+	Rectangle temp;
 
-	if (screen.includes(area))
+	temp = area;
+	if (clipped && !clipArea(temp))
+		return true;
+
+	if (screen.includes(temp))
 	{
 		/*
 		 * base is the starting pointer inside the buffer.
 		 */
-		base = area.ul.y * screen.width() + area.ul.x;
+		base = temp.ul.y * screen.width() + temp.ul.x;
 
-		for (y = 0; y < area.height(); y++)
+		for (y = 0; y < temp.height(); y++)
 		{
-			for (x = 0; x < area.width(); x++)
+			for (x = 0; x < temp.width(); x++)
 				if (buffer[base++] == 1)
 					return false;
 
-			base += screen.width() - area.width();
+			base += screen.width() - temp.width();
+		}
+	}
+
+	return true;
+}
+
+void ViewZBuffer::getClearArea(Rectangle &area, Region &region)
+{
+	Rectangle temp;
+
+	temp = area;
+	if (full || (clipped && !clipArea(temp)))
+		return;
+
+	if (!temp.intersect(screen))
+		return;
+	temp.intersection(screen);
+
+	/*
+	 * open holds the rectangles built from the runs of the previous row,
+	 * they grow downwards as long as the same run is found in the next row.
+	 */
+	Region open;
+	Region runs;
+
+	for (int y = temp.ul.y; y <= temp.lr.y; y++)
+	{
+		uint8_t *row = buffer + y * screen.width();
+
+		runs.clear();
+		for (int x = temp.ul.x; x <= temp.lr.x; x++)
+		{
+			if (row[x])
+				continue;
+
+			int start = x;
+			while ((x < temp.lr.x) && !row[x + 1])
+				x++;
+
+			Rectangle run(start, y, x, y);
+			runs.add(run);
+		}
+
+		/*
+		 * Close the rectangles not continued by a run of this row,
+		 * extend the others.
+		 */
+		unsigned i = 0;
+		while (i < open.size())
+		{
+			bool continued = false;
+
+			for (unsigned j = 0; j < runs.size(); j++)
+			{
+				if ((runs[j].ul.x == open[i].ul.x) && (runs[j].lr.x == open[i].lr.x))
+				{
+					open[i].lr.y = y;
+					/* The run is consumed, mark it empty */
+					runs[j].ul.x = runs[j].lr.x + 1;
+					continued = true;
+					break;
+				}
+			}
+
+			if (continued)
+			{
+				i++;
+				continue;
+			}
+
+			region.add(open[i]);
+			open.remove(i);
+		}
+
+		for (unsigned j = 0; j < runs.size(); j++)
+		{
+			if (runs[j].ul.x <= runs[j].lr.x)
+				open.add(runs[j]);
 		}
 	}
 
+	for (unsigned i = 0; i < open.size(); i++)
+		region.add(open[i]);
+}
+
+bool ViewZBuffer::getClipping(Rectangle &clip)
+{
+	if (clipped)
+		clip = clipping;
+
+	return clipped;
+}
+
+void ViewZBuffer::setClipping(Rectangle &clip)
+{
+	clipping = clip;
+	clipped = true;
+	full = false;
+}
+
+void ViewZBuffer::resetClipping()
+{
+	clipped = false;
+	full = false;
+}
+
+bool ViewZBuffer::intersectsClipping(Rectangle &area)
+{
+	return clipped ? area.intersect(clipping) : true;
+}
+
+bool ViewZBuffer::clipArea(Rectangle &area)
+{
+	if (!area.intersect(clipping))
+		return false;
+
+	area.intersection(clipping);
 	return true;
 }
 
@@ -43,10 +43,64 @@ public:
 	bool isAreaSet(Rectangle &area);
 	bool isAreaClear(Rectangle &area);
 
+	/*
+	 * Add to region the parts of area which are clear in the buffer,
+	 * as a set of rectangles.
+	 * Rows of clear pixels are merged with the rows below when they
+	 * span the same columns.
+	 *
+	 * PARAMETERS IN
+	 * Rectangle &area - the area to be scanned
+	 *
+	 * PARAMETERS OUT
+	 * Region &region - the region the clear rectangles are added to
+	 */
+	void getClearArea(Rectangle &area, Region &region);
+
+	/*
+	 * Restrict all operations to the area described by clip.
+	 * Areas falling outside clip are not set or cleared, and
+	 * are reported as set by isAreaSet() (nothing is visible there).
+	 * This is used to recompute exposure for a damaged area only.
+	 */
+	void setClipping(Rectangle &clip);
+	void resetClipping(void);
+
+	/*
+	 * Copy the clipping rectangle into clip.
+	 * Return false if clipping is not active.
+	 */
+	bool getClipping(Rectangle &clip);
+
+	/*
+	 * Verify if area intersects or is included in the clipping rectangle.
+	 * Without clipping the whole screen is considered.
+	 * Used by incremental exposure computation to skip views outside the
+	 * damaged area.
+	 */
+	bool intersectsClipping(Rectangle &area);
+
+	/*
+	 * Return true if the (clipped) screen is completely covered,
+	 * further views are hidden and need no testing, see
+	 * View::hideExposure().
+	 * Only a single area covering the screen is detected.
+	 */
+	inline bool isFull(void) const { return full; }
+
 private:
 	ViewZBuffer();
 
+	/*
+	 * Apply clipping to area, return false if area falls
+	 * completely outside the clipping rectangle.
+	 */
+	bool clipArea(Rectangle &area);
+
 	Rectangle screen;
+	Rectangle clipping;
+	bool clipped;
+	bool full;
 	// uint32_t *buffer;
 	uint8_t *buffer;
 	// int width;
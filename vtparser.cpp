@@ -0,0 +1,293 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include "vtparser.h"
+
+enum
+{
+	VT_ACT_NONE,
+	VT_ACT_PRINT,
+	VT_ACT_EXECUTE,
+	VT_ACT_CLEAR,
+	VT_ACT_COLLECT,
+	VT_ACT_PARAM,
+	VT_ACT_ESC_DISPATCH,
+	VT_ACT_CSI_DISPATCH,
+	VT_ACT_UTF8_START,
+	VT_ACT_UTF8_CONT,
+	// A sequence cut short, the byte is decoded again in the ground state
+	VT_ACT_UTF8_ABORT,
+	VT_ACT_INVALID
+};
+
+#define VT_REPLACEMENT_CHAR 0xFFFD
+
+/*
+ * For each state and input byte: the action in the high nibble and the
+ * next state in the low nibble.
+ */
+static uint8_t transitions[VTParser::VT_STATE_NUM][256];
+static bool transitionsReady = false;
+
+static void setRange(unsigned state, int first, int last, unsigned action, unsigned next)
+{
+	for (int i = first; i <= last; i++)
+		transitions[state][i] = (action << 4) | next;
+}
+
+/*
+ * C0 controls are executed in the middle of most sequences.
+ */
+static void setExecute(unsigned state)
+{
+	setRange(state, 0x00, 0x17, VT_ACT_EXECUTE, state);
+	setRange(state, 0x19, 0x19, VT_ACT_EXECUTE, state);
+	setRange(state, 0x1C, 0x1F, VT_ACT_EXECUTE, state);
+}
+
+static void buildTransitions(void)
+{
+	for (unsigned s = 0; s < VTParser::VT_STATE_NUM; s++)
+		setRange(s, 0x00, 0xFF, VT_ACT_NONE, s);
+
+	setExecute(VTParser::VT_GROUND);
+	setRange(VTParser::VT_GROUND, 0x20, 0x7E, VT_ACT_PRINT, VTParser::VT_GROUND);
+	setRange(VTParser::VT_GROUND, 0x80, 0xC1, VT_ACT_INVALID, VTParser::VT_GROUND);
+	setRange(VTParser::VT_GROUND, 0xC2, 0xF4, VT_ACT_UTF8_START, VTParser::VT_UTF8);
+	setRange(VTParser::VT_GROUND, 0xF5, 0xFF, VT_ACT_INVALID, VTParser::VT_GROUND);
+
+	setExecute(VTParser::VT_ESCAPE);
+	setRange(VTParser::VT_ESCAPE, 0x20, 0x2F, VT_ACT_COLLECT, VTParser::VT_ESCAPE_INTERMEDIATE);
+	setRange(VTParser::VT_ESCAPE, 0x30, 0x7E, VT_ACT_ESC_DISPATCH, VTParser::VT_GROUND);
+	setRange(VTParser::VT_ESCAPE, '[', '[', VT_ACT_CLEAR, VTParser::VT_CSI_ENTRY);
+	setRange(VTParser::VT_ESCAPE, ']', ']', VT_ACT_NONE, VTParser::VT_OSC_STRING);
+
+	setExecute(VTParser::VT_ESCAPE_INTERMEDIATE);
+	setRange(VTParser::VT_ESCAPE_INTERMEDIATE, 0x20, 0x2F, VT_ACT_COLLECT, VTParser::VT_ESCAPE_INTERMEDIATE);
+	setRange(VTParser::VT_ESCAPE_INTERMEDIATE, 0x30, 0x7E, VT_ACT_ESC_DISPATCH, VTParser::VT_GROUND);
+
+	setExecute(VTParser::VT_CSI_ENTRY);
+	setRange(VTParser::VT_CSI_ENTRY, 0x20, 0x2F, VT_ACT_COLLECT, VTParser::VT_CSI_INTERMEDIATE);
+	setRange(VTParser::VT_CSI_ENTRY, 0x30, 0x39, VT_ACT_PARAM, VTParser::VT_CSI_PARAM);
+	setRange(VTParser::VT_CSI_ENTRY, 0x3A, 0x3A, VT_ACT_NONE, VTParser::VT_CSI_IGNORE);
+	setRange(VTParser::VT_CSI_ENTRY, 0x3B, 0x3B, VT_ACT_PARAM, VTParser::VT_CSI_PARAM);
+	setRange(VTParser::VT_CSI_ENTRY, 0x3C, 0x3F, VT_ACT_COLLECT, VTParser::VT_CSI_PARAM);
+	setRange(VTParser::VT_CSI_ENTRY, 0x40, 0x7E, VT_ACT_CSI_DISPATCH, VTParser::VT_GROUND);
+
+	setExecute(VTParser::VT_CSI_PARAM);
+	setRange(VTParser::VT_CSI_PARAM, 0x20, 0x2F, VT_ACT_COLLECT, VTParser::VT_CSI_INTERMEDIATE);
+	setRange(VTParser::VT_CSI_PARAM, 0x30, 0x39, VT_ACT_PARAM, VTParser::VT_CSI_PARAM);
+	setRange(VTParser::VT_CSI_PARAM, 0x3A, 0x3A, VT_ACT_NONE, VTParser::VT_CSI_IGNORE);
+	setRange(VTParser::VT_CSI_PARAM, 0x3B, 0x3B, VT_ACT_PARAM, VTParser::VT_CSI_PARAM);
+	setRange(VTParser::VT_CSI_PARAM, 0x3C, 0x3F, VT_ACT_NONE, VTParser::VT_CSI_IGNORE);
+	setRange(VTParser::VT_CSI_PARAM, 0x40, 0x7E, VT_ACT_CSI_DISPATCH, VTParser::VT_GROUND);
+
+	setExecute(VTParser::VT_CSI_INTERMEDIATE);
+	setRange(VTParser::VT_CSI_INTERMEDIATE, 0x20, 0x2F, VT_ACT_COLLECT, VTParser::VT_CSI_INTERMEDIATE);
+	setRange(VTParser::VT_CSI_INTERMEDIATE, 0x30, 0x3F, VT_ACT_NONE, VTParser::VT_CSI_IGNORE);
+	setRange(VTParser::VT_CSI_INTERMEDIATE, 0x40, 0x7E, VT_ACT_CSI_DISPATCH, VTParser::VT_GROUND);
+
+	setExecute(VTParser::VT_CSI_IGNORE);
+	setRange(VTParser::VT_CSI_IGNORE, 0x40, 0x7E, VT_ACT_NONE, VTParser::VT_GROUND);
+
+	// OSC strings end with BEL or with ESC '\'
+	setRange(VTParser::VT_OSC_STRING, 0x07, 0x07, VT_ACT_NONE, VTParser::VT_GROUND);
+
+	// CAN, SUB and ESC interrupt any sequence
+	for (unsigned s = 0; s < VTParser::VT_STATE_NUM; s++)
+	{
+		if (s == VTParser::VT_UTF8)
+			continue;
+		setRange(s, 0x18, 0x18, VT_ACT_EXECUTE, VTParser::VT_GROUND);
+		setRange(s, 0x1A, 0x1A, VT_ACT_EXECUTE, VTParser::VT_GROUND);
+		setRange(s, 0x1B, 0x1B, VT_ACT_CLEAR, VTParser::VT_ESCAPE);
+	}
+
+	setRange(VTParser::VT_UTF8, 0x00, 0xFF, VT_ACT_UTF8_ABORT, VTParser::VT_GROUND);
+	setRange(VTParser::VT_UTF8, 0x80, 0xBF, VT_ACT_UTF8_CONT, VTParser::VT_UTF8);
+
+	transitionsReady = true;
+}
+
+/*
+ * Length of the run of printable ASCII characters at the start of data,
+ * 8 bytes are checked at once.
+ */
+static size_t printableRun(const uint8_t *data, const uint8_t *end)
+{
+	const uint64_t ones = 0x0101010101010101ULL;
+	const uint64_t highs = 0x8080808080808080ULL;
+	const uint8_t *p = data;
+
+	while (end - p >= 8)
+	{
+		uint64_t v;
+		memcpy(&v, p, sizeof(v));
+		// Any byte below 0x20, or above 0x7E
+		if (((v - ones * 0x20) & ~v & highs) || (((v + ones * 0x01) | v) & highs))
+			break;
+		p += 8;
+	}
+	while ((p < end) && ((uint8_t)(*p - 0x20) < 0x5F))
+		p++;
+
+	return p - data;
+}
+
+VTParser::VTParser(VTHandler *handler) : handler(handler)
+{
+	if (!transitionsReady)
+		buildTransitions();
+
+	reset();
+}
+
+void VTParser::reset()
+{
+	state = VT_GROUND;
+	numParams = 0;
+	prefix = 0;
+	intermediate = 0;
+	utf8Code = 0;
+	utf8Min = 0;
+	utf8Left = 0;
+}
+
+void VTParser::parse(const uint8_t *data, size_t len)
+{
+	const uint8_t *end = data + len;
+
+	while (data < end)
+	{
+		if (state == VT_GROUND)
+		{
+			size_t run = printableRun(data, end);
+			if (run)
+			{
+				handler->print(data, (int)run);
+				data += run;
+				if (data == end)
+					break;
+			}
+		}
+
+		uint8_t entry = transitions[state][*data];
+		unsigned action = entry >> 4;
+
+		state = entry & 0x0F;
+		if (action == VT_ACT_UTF8_ABORT)
+		{
+			// Decode the byte again from the ground state
+			handler->printCode(VT_REPLACEMENT_CHAR);
+			continue;
+		}
+		if (action != VT_ACT_NONE)
+			perform(action, *data);
+		data++;
+	}
+}
+
+void VTParser::perform(unsigned action, uint8_t code)
+{
+	switch (action)
+	{
+	case VT_ACT_PRINT:
+		handler->print(&code, 1);
+		break;
+
+	case VT_ACT_EXECUTE:
+		handler->execute(code);
+		break;
+
+	case VT_ACT_CLEAR:
+		numParams = 0;
+		prefix = 0;
+		intermediate = 0;
+		break;
+
+	case VT_ACT_COLLECT:
+		if ((code >= 0x3C) && (code <= 0x3F))
+			prefix = code;
+		else
+			intermediate = code;
+		break;
+
+	case VT_ACT_PARAM:
+		if (!numParams)
+		{
+			params[0] = 0;
+			numParams = 1;
+		}
+		if (code == ';')
+		{
+			if (numParams < VT_MAX_PARAMS)
+				params[numParams++] = 0;
+		}
+		else if (params[numParams - 1] < 10000)
+			params[numParams - 1] = params[numParams - 1] * 10 + (code - '0');
+		break;
+
+	case VT_ACT_ESC_DISPATCH:
+		handler->escDispatch(code, intermediate);
+		break;
+
+	case VT_ACT_CSI_DISPATCH:
+		handler->csiDispatch(code, params, numParams, prefix, intermediate);
+		break;
+
+	case VT_ACT_UTF8_START:
+		if (code < 0xE0)
+		{
+			utf8Code = code & 0x1F;
+			utf8Min = 0x80;
+			utf8Left = 1;
+		}
+		else if (code < 0xF0)
+		{
+			utf8Code = code & 0x0F;
+			utf8Min = 0x800;
+			utf8Left = 2;
+		}
+		else
+		{
+			utf8Code = code & 0x07;
+			utf8Min = 0x10000;
+			utf8Left = 3;
+		}
+		break;
+
+	case VT_ACT_UTF8_CONT:
+		utf8Code = (utf8Code << 6) | (code & 0x3F);
+		if (--utf8Left)
+			break;
+
+		state = VT_GROUND;
+		// Overlong forms, surrogates and out of range values
+		if ((utf8Code < utf8Min) || ((utf8Code >= 0xD800) && (utf8Code <= 0xDFFF)) || (utf8Code > 0x10FFFF))
+			utf8Code = VT_REPLACEMENT_CHAR;
+		handler->printCode(utf8Code);
+		break;
+
+	case VT_ACT_INVALID:
+		handler->printCode(VT_REPLACEMENT_CHAR);
+		break;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+/*
+ * DiegOS Operating System source code
+ *
+ * Copyright (C) 2012 - 2024 Diego Gallizioli
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VTPARSER_H_
+#define _VTPARSER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#define VT_MAX_PARAMS 16
+
+/*
+ * The receiver of the sequences decoded by VTParser.
+ */
+class VTHandler
+{
+public:
+	virtual ~VTHandler() {}
+
+	/*
+	 * Print a run of printable ASCII characters.
+	 *
+	 * PARAMETERS IN
+	 *  const uint8_t *text - the characters, 0x20 - 0x7E
+	 *  int len - the number of characters
+	 */
+	virtual void print(const uint8_t *text, int len) = 0;
+
+	/*
+	 * Print a character decoded from UTF-8, invalid sequences are
+	 * reported as U+FFFD.
+	 */
+	virtual void printCode(uint32_t code) = 0;
+
+	/*
+	 * Execute a C0 control character (BS, HT, LF, CR...).
+	 */
+	virtual void execute(uint8_t code) = 0;
+
+	/*
+	 * Execute an escape sequence: ESC intermediate final.
+	 *
+	 * PARAMETERS IN
+	 *  uint8_t final - the final character
+	 *  uint8_t intermediate - the intermediate character, 0 if none
+	 */
+	virtual void escDispatch(uint8_t final, uint8_t intermediate) = 0;
+
+	/*
+	 * Execute a control sequence: CSI prefix params intermediate final.
+	 *
+	 * PARAMETERS IN
+	 *  uint8_t final - the final character
+	 *  const int *params - the numeric parameters, 0 when omitted
+	 *  int num - the number of parameters, 0 if none
+	 *  uint8_t prefix - the private marker ('?', '>'...), 0 if none
+	 *  uint8_t intermediate - the intermediate character, 0 if none
+	 */
+	virtual void csiDispatch(uint8_t final, const int *params, int num, uint8_t prefix, uint8_t intermediate) = 0;
+};
+
+/*
+ * A streaming VT100/ANSI decoder.
+ * Bytes are fed in chunks of any size, a sequence can be split between
+ * two chunks.
+ * The state machine is table driven: each state has a table of 256
+ * entries holding the action to perform and the next state.
+ * Runs of printable characters are sent to the handler with a single call.
+ * OSC strings and unknown sequences are consumed and ignored.
+ */
+class VTParser
+{
+public:
+	VTParser(VTHandler *handler);
+
+	/*
+	 * Decode a chunk of the stream.
+	 *
+	 * PARAMETERS IN
+	 *  const uint8_t *data - the bytes
+	 *  size_t len - the number of bytes
+	 */
+	void parse(const uint8_t *data, size_t len);
+
+	/*
+	 * Go back to the ground state, discarding a partial sequence.
+	 */
+	void reset(void);
+
+	enum
+	{
+		VT_GROUND,
+		VT_ESCAPE,
+		VT_ESCAPE_INTERMEDIATE,
+		VT_CSI_ENTRY,
+		VT_CSI_PARAM,
+		VT_CSI_INTERMEDIATE,
+		VT_CSI_IGNORE,
+		VT_OSC_STRING,
+		VT_UTF8,
+		VT_STATE_NUM
+	};
+
+private:
+	void perform(unsigned action, uint8_t code);
+
+	VTHandler *handler;
+	unsigned state;
+	int params[VT_MAX_PARAMS];
+	int numParams;
+	uint8_t prefix, intermediate;
+	// The code point being decoded, its minimum value for the length of
+	// the sequence and the continuation bytes still expected
+	uint32_t utf8Code, utf8Min;
+	int utf8Left;
+};
+
+#endif
\ No newline at end of file
@@ -29,7 +29,7 @@ WindowIconClose::WindowIconClose(Rectangle &rect) : AbstractButton(rect)
 void WindowIconClose::drawView()
 {
 	Rectangle viewRect;
-	ViewRender *renderer = GRenderer;
+	ViewRenderBackend *renderer = GRenderer;
 	Palette *palette = GPaletteGroup->getPalette(PaletteGroup::PAL_WINICON);
 	getViewport(viewRect);
 
@@ -63,38 +63,57 @@ void WindowIconClose::drawView()
 	}
 
 	viewRect.zoom(-2, -2);
+
+	/*
+	 * Each stroke of the cross is made of 5 parallel lines, they are
+	 * joined in a single polyline walking back and forth through the
+	 * stroke: the segments linking two lines join adjacent pixels.
+	 */
+	Point cross[10];
 	Point s(viewRect.ul), e(viewRect.lr);
-	renderer->line(s, e, color[0]);
+	cross[4] = s;
+	cross[5] = e;
 	s.move(1, 0);
 	e.move(0, -1);
-	renderer->line(s, e, color[0]);
+	cross[3] = s;
+	cross[2] = e;
 	s.move(1, 0);
 	e.move(0, -1);
-	renderer->line(s, e, color[0]);
+	cross[0] = s;
+	cross[1] = e;
 	s.move(-2, 1);
 	e.move(-1, 2);
-	renderer->line(s, e, color[0]);
+	cross[7] = s;
+	cross[6] = e;
 	s.move(0, 1);
 	e.move(-1, 0);
-	renderer->line(s, e, color[0]);
+	cross[8] = s;
+	cross[9] = e;
+	renderer->lines(cross, 10, color[0]);
 
 	s.x = viewRect.lr.x;
 	s.y = viewRect.ul.y;
 	e.x = viewRect.ul.x;
 	e.y = viewRect.lr.y;
-	renderer->line(s, e, color[0]);
+	cross[4] = s;
+	cross[5] = e;
 	s.move(-1, 0);
 	e.move(0, -1);
-	renderer->line(s, e, color[0]);
+	cross[3] = s;
+	cross[2] = e;
 	s.move(-1, 0);
 	e.move(0, -1);
-	renderer->line(s, e, color[0]);
+	cross[0] = s;
+	cross[1] = e;
 	s.move(2, 1);
 	e.move(1, 2);
-	renderer->line(s, e, color[0]);
+	cross[7] = s;
+	cross[6] = e;
 	s.move(0, 1);
 	e.move(1, 0);
-	renderer->line(s, e, color[0]);
+	cross[8] = s;
+	cross[9] = e;
+	renderer->lines(cross, 10, color[0]);
 }
 
 void WindowIconClose::doAction()
@@ -114,7 +133,7 @@ WindowIconZoom::WindowIconZoom(Rectangle &rect) : AbstractButton(rect)
 void WindowIconZoom::drawView()
 {
 	Rectangle viewRect;
-	ViewRender *renderer = GRenderer;
+	ViewRenderBackend *renderer = GRenderer;
 	Palette *palette = GPaletteGroup->getPalette(PaletteGroup::PAL_WINICON);
 	getViewport(viewRect);
 
@@ -131,18 +150,25 @@ void WindowIconZoom::drawView()
 	 *    B       D
 	 *    DDDDDDDDD
 	 */
-	Point ul(viewRect.ul);
-	renderer->hline(ul, viewRect.width(), color);
-	renderer->vline(ul, viewRect.height() - 1, color);
-	ul.move(viewRect.width(), 1);
-	renderer->vline(ul, viewRect.height() - 1, color2);
-	ul.move(-viewRect.width(), viewRect.height() - 1);
-	renderer->hline(ul, viewRect.width() - 1, color2);
-
-	// The button frame
+	Rectangle rects[5];
+	uint32_t colors[5];
+	int x = viewRect.ul.x, y = viewRect.ul.y;
+	int w = viewRect.width(), h = viewRect.height();
+	rects[0] = Rectangle(x, y, x + w, y);
+	colors[0] = color;
+	rects[1] = Rectangle(x, y, x, y + h - 1);
+	colors[1] = color;
+	rects[2] = Rectangle(x + w, y + 1, x + w, y + h);
+	colors[2] = color2;
+	rects[3] = Rectangle(x, y + h, x + w - 1, y + h);
+	colors[3] = color2;
+
+	// The button frame, drawn in the same batch as the shadow
 	palette->getPalette(WINICON_MAIN, color);
 	viewRect.zoom(-1, -1);
-	renderer->filledRectangle(viewRect, color);
+	rects[4] = viewRect;
+	colors[4] = color;
+	renderer->fillRectsColored(rects, 5, colors);
 
 	if (isDown())
 	{